@@ -21,6 +21,24 @@ function(AddH5SupportSources)
     ${H5Support_SOURCE_DIR}/Source/H5Support/H5ScopedSentinel.h
     ${H5Support_SOURCE_DIR}/Source/H5Support/H5ScopedErrorHandler.h
     ${H5Support_SOURCE_DIR}/Source/H5Support/H5Macros.h
+    ${H5Support_SOURCE_DIR}/Source/H5Support/H5SupportMutex.h
+    ${H5Support_SOURCE_DIR}/Source/H5Support/H5TaskExecutor.h
+    ${H5Support_SOURCE_DIR}/Source/H5Support/H5LiteAsync.h
+    ${H5Support_SOURCE_DIR}/Source/H5Support/H5Instrumentation.h
+    ${H5Support_SOURCE_DIR}/Source/H5Support/H5DatasetAppender.h
+    ${H5Support_SOURCE_DIR}/Source/H5Support/H5DatasetBlockReader.h
+    ${H5Support_SOURCE_DIR}/Source/H5Support/H5DefaultInitAllocator.h
+    ${H5Support_SOURCE_DIR}/Source/H5Support/H5DatasetHandle.h
+    ${H5Support_SOURCE_DIR}/Source/H5Support/H5AttributeWriter.h
+    ${H5Support_SOURCE_DIR}/Source/H5Support/H5LiteAttributes.h
+    ${H5Support_SOURCE_DIR}/Source/H5Support/H5LiteStrings.h
+    ${H5Support_SOURCE_DIR}/Source/H5Support/H5TypeTraits.h
+    ${H5Support_SOURCE_DIR}/Source/H5Support/H5CompoundType.h
+    ${H5Support_SOURCE_DIR}/Source/H5Support/H5CompoundColumns.h
+    ${H5Support_SOURCE_DIR}/Source/H5Support/H5MemoryLayout.h
+    ${H5Support_SOURCE_DIR}/Source/H5Support/H5LiteGather.h
+    ${H5Support_SOURCE_DIR}/Source/H5Support/H5LiteReducedPrecision.h
+    ${H5Support_SOURCE_DIR}/Source/H5Support/H5CodecFilters.h
   )
 
   set(H5Support_SRCS
@@ -30,6 +48,12 @@ function(AddH5SupportSources)
     ${H5Support_SOURCE_DIR}/Source/H5Support/H5ScopedErrorHandler.cpp
   )
 
+  if(H5Support_USE_ZLIB)
+    list(APPEND H5Support_HDRS
+      ${H5Support_SOURCE_DIR}/Source/H5Support/H5LiteParallel.h
+    )
+  endif()
+
   if(H5Support_USE_QT)
     list(APPEND H5Support_HDRS
       ${H5Support_SOURCE_DIR}/Source/H5Support/QH5Lite.h
@@ -0,0 +1,245 @@
+/* ============================================================================
+ * Copyright (c) 2007-2019 BlueQuartz Software, LLC
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+ * contributors may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The code contained herein was partially funded by the followig contracts:
+ *    United States Air Force Prime Contract FA8650-04-C-5229
+ *    United States Air Force Prime Contract FA8650-15-D-5231
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#pragma once
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <hdf5.h>
+
+#include "H5Support/H5Lite.h"
+#include "H5Support/H5Support.h"
+
+#if defined(H5Support_NAMESPACE)
+namespace H5Support_NAMESPACE
+{
+#endif
+
+/**
+ * @brief The H5AttributeWriter class writes a set of attributes of mixed types to one
+ * object. The object is looked up and opened once in the constructor and stays open until
+ * close() or destruction, so each write only creates (or replaces) the attribute itself.
+ *
+ * Every write returns its own error code; the first failure is also kept in getError() so
+ * a batch of writes can be checked once at the end.
+ * @code
+ * H5AttributeWriter writer(fileID, "Data");
+ * writer.writeString("Units", "mm");
+ * writer.writeScalar("Version", 2);
+ * writer.writeVector("Origin", std::vector<float>{0.0f, 0.0f, 0.0f});
+ * herr_t error = writer.close();
+ * @endcode
+ */
+class H5AttributeWriter
+{
+public:
+  /**
+   * @brief Opens the object that will receive the attributes
+   * @param locationID The location to look for objectName
+   * @param objectName The Object to write the attributes to
+   */
+  H5AttributeWriter(hid_t locationID, const std::string& objectName)
+  : m_ObjectName(objectName)
+  {
+    H5SUPPORT_MUTEX_LOCK()
+
+    H5O_info_t objectInfo{};
+    m_Error = H5Oget_info_by_name(locationID, objectName.c_str(), &objectInfo, H5P_DEFAULT);
+    if(m_Error < 0)
+    {
+      std::cout << "H5AttributeWriter(" << __LINE__ << ") Error getting object info at locationID (" << locationID << ") with object name (" << objectName << ")" << std::endl;
+      return;
+    }
+    m_ObjectType = objectInfo.type;
+    m_ObjectID = H5Lite::openId(locationID, objectName, m_ObjectType);
+    if(m_ObjectID < 0)
+    {
+      std::cout << "H5AttributeWriter(" << __LINE__ << ") Error opening Object '" << objectName << "' for Attribute operations." << std::endl;
+      m_Error = -1;
+    }
+  }
+
+  ~H5AttributeWriter()
+  {
+    close();
+  }
+
+  H5AttributeWriter(const H5AttributeWriter&) = delete;            // Copy Constructor Not Implemented
+  H5AttributeWriter(H5AttributeWriter&&) = delete;                 // Move Constructor Not Implemented
+  H5AttributeWriter& operator=(const H5AttributeWriter&) = delete; // Copy Assignment Not Implemented
+  H5AttributeWriter& operator=(H5AttributeWriter&&) = delete;      // Move Assignment Not Implemented
+
+  /**
+   * @brief Returns true if the object was opened and has not been closed
+   * @return
+   */
+  bool isValid() const
+  {
+    return m_ObjectID >= 0;
+  }
+
+  /**
+   * @brief Returns the first error of any write, or 0
+   * @return
+   */
+  herr_t getError() const
+  {
+    return m_Error;
+  }
+
+  /**
+   * @brief Writes an array attribute
+   * @param attributeName The Name of the Attribute
+   * @param rank The number of dimensions in the attribute data
+   * @param dims The Dimensions of the attribute data
+   * @param data The Attribute Data to write as a pointer
+   * @return Standard HDF Error Condition
+   */
+  template <typename T> herr_t writePointer(const std::string& attributeName, int32_t rank, const hsize_t* dims, const T* data)
+  {
+    hid_t dataType = H5TypeTraits<T>::type();
+    if(!isValid() || dataType < 0)
+    {
+      return record(-1);
+    }
+
+    H5SUPPORT_MUTEX_LOCK()
+
+    herr_t error = 0;
+    herr_t returnError = 0;
+    hid_t dataspaceID = H5Screate_simple(rank, dims, nullptr);
+    if(dataspaceID < 0)
+    {
+      return record(static_cast<herr_t>(dataspaceID));
+    }
+    returnError = H5Lite::writeObjectAttribute(m_ObjectID, attributeName, dataType, dataspaceID, data);
+    CloseH5S(dataspaceID, error, returnError);
+    return record(returnError);
+  }
+
+  /**
+   * @brief Writes an array attribute with the given dimensions
+   * @param attributeName The Name of the Attribute
+   * @param dims The Dimensions of the attribute data
+   * @param data The Attribute Data to write
+   * @return Standard HDF Error Condition
+   */
+  template <typename T> herr_t writeVector(const std::string& attributeName, const std::vector<hsize_t>& dims, const std::vector<T>& data)
+  {
+    return writePointer(attributeName, static_cast<int32_t>(dims.size()), dims.data(), data.data());
+  }
+
+  /**
+   * @brief Writes a one dimensional array attribute
+   * @param attributeName The Name of the Attribute
+   * @param data The Attribute Data to write
+   * @return Standard HDF Error Condition
+   */
+  template <typename T> herr_t writeVector(const std::string& attributeName, const std::vector<T>& data)
+  {
+    hsize_t dims = data.size();
+    return writePointer(attributeName, 1, &dims, data.data());
+  }
+
+  /**
+   * @brief Writes a single value attribute, stored like H5Lite::writeScalarAttribute()
+   * @param attributeName The Name of the Attribute
+   * @param data The value
+   * @return Standard HDF Error Condition
+   */
+  template <typename T> herr_t writeScalar(const std::string& attributeName, T data)
+  {
+    hsize_t dims = 1;
+    return writePointer(attributeName, 1, &dims, &data);
+  }
+
+  /**
+   * @brief Writes a string as a null terminated attribute
+   * @param attributeName The name of the Attribute
+   * @param data The string to write as the attribute
+   * @return Standard HDF error conditions
+   */
+  herr_t writeString(const std::string& attributeName, const std::string& data)
+  {
+    if(!isValid())
+    {
+      return record(-1);
+    }
+    return record(H5Lite::writeObjectStringAttribute(m_ObjectID, attributeName, data));
+  }
+
+  /**
+   * @brief Closes the object. Safe to call more than once.
+   * @return The first error of any write or of closing the object
+   */
+  herr_t close()
+  {
+    if(m_ObjectID < 0)
+    {
+      return m_Error;
+    }
+
+    H5SUPPORT_MUTEX_LOCK()
+
+    herr_t error = H5Lite::closeId(m_ObjectID, m_ObjectType);
+    if(error < 0)
+    {
+      std::cout << "H5AttributeWriter(" << __LINE__ << ") Error Closing Object '" << m_ObjectName << "'" << std::endl;
+    }
+    m_ObjectID = -1;
+    record(error);
+    return m_Error;
+  }
+
+private:
+  herr_t record(herr_t error)
+  {
+    if(error < 0 && m_Error >= 0)
+    {
+      m_Error = error;
+    }
+    return error;
+  }
+
+  std::string m_ObjectName;
+  hid_t m_ObjectID = -1;
+  H5O_type_t m_ObjectType = H5O_TYPE_UNKNOWN;
+  herr_t m_Error = 0;
+};
+
+#if defined(H5Support_NAMESPACE)
+}
+#endif
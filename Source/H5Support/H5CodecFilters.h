@@ -0,0 +1,1429 @@
+/* ============================================================================
+ * Copyright (c) 2007-2019 BlueQuartz Software, LLC
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+ * contributors may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The code contained herein was partially funded by the followig contracts:
+ *    United States Air Force Prime Contract FA8650-04-C-5229
+ *    United States Air Force Prime Contract FA8650-15-D-5231
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <queue>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <hdf5.h>
+
+#include "H5Support/H5Lite.h"
+#include "H5Support/H5Macros.h"
+#include "H5Support/H5Support.h"
+#include "H5Support/H5SupportMutex.h"
+
+#if defined(H5Support_NAMESPACE)
+namespace H5Support_NAMESPACE
+{
+#endif
+
+/**
+ * @brief Self contained compression codecs for the H5Support filters of H5Lite::registerCodecFilters().
+ * Both codecs share one LZ77 stage with a 64 KiB window and LZ4 style sequences: a token byte
+ * holding the literal count and match length, 255 extension bytes for long counts, the
+ * literals and a 16 bit match offset.
+ *
+ * LZ is the fast codec: a single hash probe per position, greedy matching, and all the
+ * sequence fields interleaved in one byte stream.
+ *
+ * LZH is the high ratio codec: hash chains searched to a depth chosen by the level, one step
+ * of lazy matching, and the tokens, literals and the two offset bytes split into four streams
+ * that are each coded with a length limited canonical Huffman code.
+ *
+ * Delta and RunLength work on whole integer elements and suit label volumes and index arrays.
+ * Delta stores the zigzag coded difference of each element to the one before it as a LEB128
+ * varint, so monotonic sequences take about a byte per element. RunLength stores each run of
+ * equal elements as a varint count and one copy of the element.
+ *
+ * roundMantissas() is the lossy step in front of them for float fields. It rounds each value to
+ * a given number of explicit mantissa bits and zeroes the rest, which the shuffle filter then
+ * turns into runs of zero bytes for deflate or LZ.
+ *
+ * Every block starts with its uncompressed size and method, and falls back to storing the
+ * bytes when compressing does not make them smaller.
+ */
+namespace H5Codec
+{
+enum class Method : uint8_t
+{
+  Stored = 0,
+  LZ = 1,
+  LZH = 2,
+  Delta = 3,
+  RunLength = 4
+};
+
+constexpr size_t k_HeaderSize = 5;
+constexpr size_t k_MinMatch = 4;
+constexpr size_t k_MaxOffset = 65535;
+constexpr size_t k_WindowMask = 65535;
+constexpr uint32_t k_HashBits = 16;
+constexpr uint32_t k_HuffmanMaxLength = 12;
+constexpr int32_t k_DefaultLevel = 5;
+
+// -----------------------------------------------------------------------------
+inline uint32_t load32(const uint8_t* data)
+{
+  uint32_t value = 0;
+  std::memcpy(&value, data, sizeof(value));
+  return value;
+}
+
+// -----------------------------------------------------------------------------
+inline uint32_t hash4(uint32_t value)
+{
+  return (value * 2654435761u) >> (32 - k_HashBits);
+}
+
+// -----------------------------------------------------------------------------
+inline void writeUInt32(std::vector<uint8_t>& output, uint32_t value)
+{
+  for(int32_t i = 0; i < 4; ++i)
+  {
+    output.push_back(static_cast<uint8_t>(value >> (8 * i)));
+  }
+}
+
+/**
+ * @brief The ByteReader struct is a bounds checked cursor over a byte range
+ */
+struct ByteReader
+{
+  const uint8_t* pos = nullptr;
+  const uint8_t* end = nullptr;
+
+  bool readByte(uint8_t& value)
+  {
+    if(pos >= end)
+    {
+      return false;
+    }
+    value = *pos++;
+    return true;
+  }
+
+  bool readUInt32(uint32_t& value)
+  {
+    if(end - pos < 4)
+    {
+      return false;
+    }
+    value = 0;
+    for(int32_t i = 0; i < 4; ++i)
+    {
+      value |= static_cast<uint32_t>(pos[i]) << (8 * i);
+    }
+    pos += 4;
+    return true;
+  }
+
+  bool take(size_t count, const uint8_t*& data)
+  {
+    if(static_cast<size_t>(end - pos) < count)
+    {
+      return false;
+    }
+    data = pos;
+    pos += count;
+    return true;
+  }
+
+  /**
+   * @brief Reads the 255 extension bytes of a length field
+   */
+  bool readLength(size_t& length)
+  {
+    uint8_t value = 255;
+    while(value == 255)
+    {
+      if(!readByte(value))
+      {
+        return false;
+      }
+      length += value;
+    }
+    return true;
+  }
+};
+
+/**
+ * @brief The LZStreams struct receives the fields of the LZ sequences. The LZ codec points all
+ * four at one buffer, which interleaves the fields in sequence order.
+ */
+struct LZStreams
+{
+  std::vector<uint8_t>* commands = nullptr;
+  std::vector<uint8_t>* literals = nullptr;
+  std::vector<uint8_t>* offsetLow = nullptr;
+  std::vector<uint8_t>* offsetHigh = nullptr;
+};
+
+// -----------------------------------------------------------------------------
+inline void writeLength(std::vector<uint8_t>& output, size_t length)
+{
+  while(length >= 255)
+  {
+    output.push_back(255);
+    length -= 255;
+  }
+  output.push_back(static_cast<uint8_t>(length));
+}
+
+/**
+ * @brief Appends one sequence: literalCount literals followed by a match of matchLength bytes
+ * at distance offset. A matchLength of 0 ends the block after the literals.
+ */
+inline void emitSequence(LZStreams& streams, const uint8_t* literals, size_t literalCount, size_t offset, size_t matchLength)
+{
+  size_t literalCode = std::min<size_t>(literalCount, 15);
+  size_t matchCode = (matchLength == 0) ? 0 : std::min<size_t>(matchLength - k_MinMatch, 15);
+  streams.commands->push_back(static_cast<uint8_t>((literalCode << 4) | matchCode));
+  if(literalCode == 15)
+  {
+    writeLength(*streams.commands, literalCount - 15);
+  }
+  streams.literals->insert(streams.literals->end(), literals, literals + literalCount);
+  if(matchLength == 0)
+  {
+    return;
+  }
+  streams.offsetLow->push_back(static_cast<uint8_t>(offset & 0xff));
+  streams.offsetHigh->push_back(static_cast<uint8_t>(offset >> 8));
+  if(matchCode == 15)
+  {
+    writeLength(*streams.commands, matchLength - k_MinMatch - 15);
+  }
+}
+
+// -----------------------------------------------------------------------------
+inline size_t matchLength(const uint8_t* source, size_t size, size_t match, size_t pos)
+{
+  size_t length = 0;
+  while(pos + length < size && source[match + length] == source[pos + length])
+  {
+    ++length;
+  }
+  return length;
+}
+
+/**
+ * @brief Greedy LZ parse with one hash probe per position. Positions that keep missing are
+ * skipped faster, so incompressible data costs little time.
+ */
+inline void lzParseFast(const uint8_t* source, size_t size, LZStreams& streams)
+{
+  size_t anchor = 0;
+  if(size > k_MinMatch)
+  {
+    std::vector<uint32_t> table(size_t(1) << k_HashBits, 0);
+    size_t limit = size - k_MinMatch;
+    size_t pos = 0;
+    size_t misses = 0;
+    while(pos <= limit)
+    {
+      uint32_t sequence = load32(source + pos);
+      uint32_t& slot = table[hash4(sequence)];
+      size_t candidate = slot;
+      slot = static_cast<uint32_t>(pos + 1);
+      if(candidate > 0 && pos - (candidate - 1) <= k_MaxOffset && load32(source + candidate - 1) == sequence)
+      {
+        size_t match = candidate - 1;
+        size_t length = k_MinMatch + matchLength(source, size, match + k_MinMatch, pos + k_MinMatch);
+        while(pos > anchor && match > 0 && source[pos - 1] == source[match - 1])
+        {
+          --pos;
+          --match;
+          ++length;
+        }
+        emitSequence(streams, source + anchor, pos - anchor, pos - match, length);
+        pos += length;
+        anchor = pos;
+        misses = 0;
+        if(pos - 2 <= limit)
+        {
+          table[hash4(load32(source + pos - 2))] = static_cast<uint32_t>(pos - 1);
+        }
+      }
+      else
+      {
+        ++misses;
+        pos += 1 + (misses >> 6);
+      }
+    }
+  }
+  if(anchor < size)
+  {
+    emitSequence(streams, source + anchor, size - anchor, 0, 0);
+  }
+}
+
+/**
+ * @brief LZ parse over hash chains searched up to chainDepth candidates, with one step of lazy
+ * matching: a match is deferred when the next position starts a longer one.
+ */
+inline void lzParseChained(const uint8_t* source, size_t size, LZStreams& streams, size_t chainDepth)
+{
+  size_t anchor = 0;
+  if(size > k_MinMatch)
+  {
+    std::vector<int64_t> head(size_t(1) << k_HashBits, -1);
+    std::vector<int64_t> previous(k_WindowMask + 1, -1);
+    size_t limit = size - k_MinMatch;
+    size_t inserted = 0;
+    auto insertUpTo = [&](size_t pos) {
+      for(; inserted <= pos && inserted <= limit; ++inserted)
+      {
+        int64_t& slot = head[hash4(load32(source + inserted))];
+        previous[inserted & k_WindowMask] = slot;
+        slot = static_cast<int64_t>(inserted);
+      }
+    };
+    auto findMatch = [&](size_t pos, size_t& bestOffset) {
+      size_t bestLength = 0;
+      int64_t candidate = head[hash4(load32(source + pos))];
+      for(size_t depth = 0; depth < chainDepth && candidate >= 0; ++depth)
+      {
+        size_t match = static_cast<size_t>(candidate);
+        if(match >= pos || pos - match > k_MaxOffset)
+        {
+          break;
+        }
+        if(pos + bestLength < size && source[match + bestLength] == source[pos + bestLength])
+        {
+          size_t length = matchLength(source, size, match, pos);
+          if(length > bestLength)
+          {
+            bestLength = length;
+            bestOffset = pos - match;
+          }
+        }
+        int64_t next = previous[match & k_WindowMask];
+        if(next >= candidate)
+        {
+          break;
+        }
+        candidate = next;
+      }
+      return (bestLength >= k_MinMatch) ? bestLength : 0;
+    };
+
+    size_t pos = 0;
+    while(pos <= limit)
+    {
+      size_t offset = 0;
+      size_t length = findMatch(pos, offset);
+      insertUpTo(pos);
+      if(length == 0)
+      {
+        ++pos;
+        continue;
+      }
+      if(pos + 1 <= limit)
+      {
+        size_t nextOffset = 0;
+        size_t nextLength = findMatch(pos + 1, nextOffset);
+        if(nextLength > length)
+        {
+          insertUpTo(pos + 1);
+          ++pos;
+          offset = nextOffset;
+          length = nextLength;
+        }
+      }
+      emitSequence(streams, source + anchor, pos - anchor, offset, length);
+      pos += length;
+      anchor = pos;
+      insertUpTo(pos - 1);
+    }
+  }
+  if(anchor < size)
+  {
+    emitSequence(streams, source + anchor, size - anchor, 0, 0);
+  }
+}
+
+/**
+ * @brief Rebuilds size bytes from LZ sequences. The readers may all alias one stream.
+ * @return False if the sequences are corrupt
+ */
+inline bool lzDecode(ByteReader& commands, ByteReader& literals, ByteReader& offsetLow, ByteReader& offsetHigh, uint8_t* output, size_t size)
+{
+  size_t pos = 0;
+  while(pos < size)
+  {
+    uint8_t token = 0;
+    if(!commands.readByte(token))
+    {
+      return false;
+    }
+    size_t literalCount = token >> 4;
+    if(literalCount == 15 && !commands.readLength(literalCount))
+    {
+      return false;
+    }
+    const uint8_t* literalData = nullptr;
+    if(literalCount > size - pos || !literals.take(literalCount, literalData))
+    {
+      return false;
+    }
+    std::memcpy(output + pos, literalData, literalCount);
+    pos += literalCount;
+    if(pos == size)
+    {
+      break;
+    }
+
+    uint8_t low = 0;
+    uint8_t high = 0;
+    if(!offsetLow.readByte(low) || !offsetHigh.readByte(high))
+    {
+      return false;
+    }
+    size_t offset = static_cast<size_t>(low) | (static_cast<size_t>(high) << 8);
+    size_t length = token & 15;
+    if(length == 15 && !commands.readLength(length))
+    {
+      return false;
+    }
+    length += k_MinMatch;
+    if(offset == 0 || offset > pos || length > size - pos)
+    {
+      return false;
+    }
+    const uint8_t* match = output + pos - offset;
+    if(offset >= length)
+    {
+      std::memcpy(output + pos, match, length);
+    }
+    else
+    {
+      for(size_t i = 0; i < length; ++i)
+      {
+        output[pos + i] = match[i];
+      }
+    }
+    pos += length;
+  }
+  return true;
+}
+
+/**
+ * @brief Computes Huffman code lengths no longer than k_HuffmanMaxLength. When the tree is
+ * too deep the counts are halved, which flattens it, and the code is rebuilt.
+ */
+inline void huffmanLengths(std::vector<uint64_t> counts, std::vector<uint8_t>& lengths)
+{
+  lengths.assign(256, 0);
+  while(true)
+  {
+    using Node = std::pair<uint64_t, int32_t>;
+    std::priority_queue<Node, std::vector<Node>, std::greater<Node>> queue;
+    std::vector<int32_t> parent(512, -1);
+    for(int32_t symbol = 0; symbol < 256; ++symbol)
+    {
+      if(counts[symbol] > 0)
+      {
+        queue.push(Node(counts[symbol], symbol));
+      }
+    }
+    int32_t nextNode = 256;
+    while(queue.size() > 1)
+    {
+      Node first = queue.top();
+      queue.pop();
+      Node second = queue.top();
+      queue.pop();
+      parent[first.second] = nextNode;
+      parent[second.second] = nextNode;
+      queue.push(Node(first.first + second.first, nextNode++));
+    }
+    uint32_t maxLength = 0;
+    for(int32_t symbol = 0; symbol < 256; ++symbol)
+    {
+      uint32_t length = 0;
+      for(int32_t node = symbol; counts[symbol] > 0 && parent[node] >= 0; node = parent[node])
+      {
+        ++length;
+      }
+      lengths[symbol] = static_cast<uint8_t>(length);
+      maxLength = std::max(maxLength, length);
+    }
+    if(maxLength <= k_HuffmanMaxLength)
+    {
+      return;
+    }
+    for(auto& count : counts)
+    {
+      count = (count == 0) ? 0 : ((count >> 1) | 1);
+    }
+  }
+}
+
+/**
+ * @brief Assigns canonical codes to code lengths, bit reversed for the LSB first bit stream
+ * @return False if the lengths do not form a valid prefix code
+ */
+inline bool huffmanCodes(const std::vector<uint8_t>& lengths, std::vector<uint16_t>& codes)
+{
+  uint32_t lengthCounts[k_HuffmanMaxLength + 1] = {0};
+  uint32_t kraft = 0;
+  for(uint8_t length : lengths)
+  {
+    if(length > k_HuffmanMaxLength)
+    {
+      return false;
+    }
+    if(length > 0)
+    {
+      ++lengthCounts[length];
+      kraft += 1u << (k_HuffmanMaxLength - length);
+    }
+  }
+  if(kraft > (1u << k_HuffmanMaxLength))
+  {
+    return false;
+  }
+  uint32_t nextCode[k_HuffmanMaxLength + 1] = {0};
+  uint32_t code = 0;
+  for(uint32_t length = 1; length <= k_HuffmanMaxLength; ++length)
+  {
+    code = (code + lengthCounts[length - 1]) << 1;
+    nextCode[length] = code;
+  }
+  codes.assign(256, 0);
+  for(size_t symbol = 0; symbol < 256; ++symbol)
+  {
+    uint32_t length = lengths[symbol];
+    if(length == 0)
+    {
+      continue;
+    }
+    uint32_t canonical = nextCode[length]++;
+    uint32_t reversed = 0;
+    for(uint32_t bit = 0; bit < length; ++bit)
+    {
+      reversed |= ((canonical >> bit) & 1u) << (length - 1 - bit);
+    }
+    codes[symbol] = static_cast<uint16_t>(reversed);
+  }
+  return true;
+}
+
+/**
+ * @brief Appends a byte stream coded with a canonical Huffman code: its length, a mode byte,
+ * then either the raw bytes (mode 0), the single repeated byte (mode 1) or 128 bytes of packed
+ * 4 bit code lengths followed by the size and bytes of the bit stream (mode 2)
+ */
+inline void huffmanEncode(const std::vector<uint8_t>& input, std::vector<uint8_t>& output)
+{
+  writeUInt32(output, static_cast<uint32_t>(input.size()));
+  std::vector<uint64_t> counts(256, 0);
+  for(uint8_t value : input)
+  {
+    ++counts[value];
+  }
+  size_t symbolCount = static_cast<size_t>(std::count_if(counts.begin(), counts.end(), [](uint64_t count) { return count > 0; }));
+  if(symbolCount == 1)
+  {
+    output.push_back(1);
+    output.push_back(input[0]);
+    return;
+  }
+  std::vector<uint8_t> lengths;
+  std::vector<uint16_t> codes;
+  uint64_t totalBits = 0;
+  if(symbolCount > 1)
+  {
+    huffmanLengths(counts, lengths);
+    huffmanCodes(lengths, codes);
+    for(size_t symbol = 0; symbol < 256; ++symbol)
+    {
+      totalBits += counts[symbol] * lengths[symbol];
+    }
+  }
+  size_t packedSize = 128 + 4 + static_cast<size_t>((totalBits + 7) / 8);
+  if(symbolCount == 0 || packedSize >= input.size())
+  {
+    output.push_back(0);
+    output.insert(output.end(), input.begin(), input.end());
+    return;
+  }
+  output.push_back(2);
+  for(size_t symbol = 0; symbol < 256; symbol += 2)
+  {
+    output.push_back(static_cast<uint8_t>(lengths[symbol] | (lengths[symbol + 1] << 4)));
+  }
+  writeUInt32(output, static_cast<uint32_t>((totalBits + 7) / 8));
+  uint64_t bits = 0;
+  uint32_t bitCount = 0;
+  for(uint8_t value : input)
+  {
+    bits |= static_cast<uint64_t>(codes[value]) << bitCount;
+    bitCount += lengths[value];
+    while(bitCount >= 8)
+    {
+      output.push_back(static_cast<uint8_t>(bits));
+      bits >>= 8;
+      bitCount -= 8;
+    }
+  }
+  if(bitCount > 0)
+  {
+    output.push_back(static_cast<uint8_t>(bits));
+  }
+}
+
+/**
+ * @brief Decodes a stream written by huffmanEncode()
+ * @param maxSize The largest stream size accepted. The size stored in the stream is not
+ * trusted until it has been checked against this
+ * @return False if the stream is corrupt
+ */
+inline bool huffmanDecode(ByteReader& input, size_t maxSize, std::vector<uint8_t>& output)
+{
+  uint32_t size = 0;
+  uint8_t mode = 0;
+  if(!input.readUInt32(size) || !input.readByte(mode) || size > maxSize)
+  {
+    return false;
+  }
+  const uint8_t* data = nullptr;
+  if(mode == 0)
+  {
+    if(!input.take(size, data))
+    {
+      return false;
+    }
+    output.assign(data, data + size);
+    return true;
+  }
+  if(mode == 1)
+  {
+    uint8_t value = 0;
+    if(!input.readByte(value))
+    {
+      return false;
+    }
+    output.assign(size, value);
+    return true;
+  }
+  if(mode != 2 || !input.take(128, data))
+  {
+    return false;
+  }
+  std::vector<uint8_t> lengths(256);
+  for(size_t i = 0; i < 128; ++i)
+  {
+    lengths[2 * i] = data[i] & 15;
+    lengths[2 * i + 1] = data[i] >> 4;
+  }
+  std::vector<uint16_t> codes;
+  uint32_t streamSize = 0;
+  if(!huffmanCodes(lengths, codes) || !input.readUInt32(streamSize) || !input.take(streamSize, data))
+  {
+    return false;
+  }
+  // Each entry of the table holds symbol << 4 | code length for every k_HuffmanMaxLength bit prefix
+  std::vector<uint16_t> table(size_t(1) << k_HuffmanMaxLength, 0);
+  for(size_t symbol = 0; symbol < 256; ++symbol)
+  {
+    if(lengths[symbol] > 0)
+    {
+      for(size_t i = codes[symbol]; i < table.size(); i += size_t(1) << lengths[symbol])
+      {
+        table[i] = static_cast<uint16_t>((symbol << 4) | lengths[symbol]);
+      }
+    }
+  }
+  output.resize(size);
+  const uint8_t* streamEnd = data + streamSize;
+  uint64_t bits = 0;
+  uint32_t bitCount = 0;
+  for(uint32_t i = 0; i < size; ++i)
+  {
+    while(bitCount <= 56 && data < streamEnd)
+    {
+      bits |= static_cast<uint64_t>(*data++) << bitCount;
+      bitCount += 8;
+    }
+    uint16_t entry = table[bits & ((1u << k_HuffmanMaxLength) - 1)];
+    uint32_t length = entry & 15;
+    if(length == 0 || length > bitCount)
+    {
+      return false;
+    }
+    output[i] = static_cast<uint8_t>(entry >> 4);
+    bits >>= length;
+    bitCount -= length;
+  }
+  return true;
+}
+
+// -----------------------------------------------------------------------------
+inline void writeVarint(std::vector<uint8_t>& output, uint64_t value)
+{
+  while(value >= 0x80)
+  {
+    output.push_back(static_cast<uint8_t>(value | 0x80));
+    value >>= 7;
+  }
+  output.push_back(static_cast<uint8_t>(value));
+}
+
+// -----------------------------------------------------------------------------
+inline bool readVarint(ByteReader& reader, uint64_t& value)
+{
+  value = 0;
+  for(uint32_t shift = 0; shift < 64; shift += 7)
+  {
+    uint8_t byte = 0;
+    if(!reader.readByte(byte))
+    {
+      return false;
+    }
+    value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+    if((byte & 0x80) == 0)
+    {
+      return true;
+    }
+  }
+  return false;
+}
+
+// -----------------------------------------------------------------------------
+inline bool isBigEndianHost()
+{
+  const uint16_t value = 1;
+  uint8_t firstByte = 0;
+  std::memcpy(&firstByte, &value, 1);
+  return firstByte == 0;
+}
+
+// -----------------------------------------------------------------------------
+template <typename U> inline U loadElement(const uint8_t* data, bool swap)
+{
+  U value = 0;
+  std::memcpy(&value, data, sizeof(U));
+  if(swap)
+  {
+    U swapped = 0;
+    for(size_t i = 0; i < sizeof(U); ++i)
+    {
+      swapped = static_cast<U>((swapped << 8) | ((value >> (8 * i)) & 0xff));
+    }
+    value = swapped;
+  }
+  return value;
+}
+
+// -----------------------------------------------------------------------------
+template <typename U> inline void storeElement(uint8_t* data, U value, bool swap)
+{
+  value = loadElement<U>(reinterpret_cast<const uint8_t*>(&value), swap);
+  std::memcpy(data, &value, sizeof(U));
+}
+
+// -----------------------------------------------------------------------------
+template <typename U> inline void deltaEncodeElements(const uint8_t* source, size_t count, bool swap, std::vector<uint8_t>& output)
+{
+  using S = typename std::make_signed<U>::type;
+  U previous = 0;
+  for(size_t i = 0; i < count; ++i)
+  {
+    U value = loadElement<U>(source + i * sizeof(U), swap);
+    U delta = static_cast<U>(value - previous);
+    previous = value;
+    U zigzag = static_cast<U>(static_cast<U>(delta << 1) ^ static_cast<U>(static_cast<S>(delta) >> (8 * sizeof(U) - 1)));
+    writeVarint(output, zigzag);
+  }
+}
+
+// -----------------------------------------------------------------------------
+template <typename U> inline bool deltaDecodeElements(ByteReader& reader, size_t count, bool swap, uint8_t* output)
+{
+  U previous = 0;
+  for(size_t i = 0; i < count; ++i)
+  {
+    uint64_t zigzag = 0;
+    if(!readVarint(reader, zigzag) || static_cast<U>(zigzag) != zigzag)
+    {
+      return false;
+    }
+    U value = static_cast<U>(zigzag);
+    U delta = static_cast<U>((value >> 1) ^ static_cast<U>(0 - static_cast<U>(value & 1u)));
+    previous = static_cast<U>(previous + delta);
+    storeElement<U>(output + i * sizeof(U), previous, swap);
+  }
+  return true;
+}
+
+// -----------------------------------------------------------------------------
+template <typename U> inline void runLengthEncodeElements(const uint8_t* source, size_t count, std::vector<uint8_t>& output)
+{
+  size_t i = 0;
+  while(i < count)
+  {
+    U value = loadElement<U>(source + i * sizeof(U), false);
+    size_t run = 1;
+    while(i + run < count && loadElement<U>(source + (i + run) * sizeof(U), false) == value)
+    {
+      ++run;
+    }
+    writeVarint(output, run - 1);
+    output.insert(output.end(), source + i * sizeof(U), source + (i + 1) * sizeof(U));
+    i += run;
+  }
+}
+
+// -----------------------------------------------------------------------------
+template <typename U> inline bool runLengthDecodeElements(ByteReader& reader, size_t count, uint8_t* output)
+{
+  size_t i = 0;
+  while(i < count)
+  {
+    uint64_t run = 0;
+    const uint8_t* element = nullptr;
+    if(!readVarint(reader, run) || run >= count - i || !reader.take(sizeof(U), element))
+    {
+      return false;
+    }
+    U value = loadElement<U>(element, false);
+    for(size_t end = i + static_cast<size_t>(run) + 1; i < end; ++i)
+    {
+      std::memcpy(output + i * sizeof(U), &value, sizeof(U));
+    }
+  }
+  return true;
+}
+
+/**
+ * @brief Encodes a block of integer elements with the Delta or RunLength method. A trailing
+ * partial element is stored as is.
+ * @param data
+ * @param size
+ * @param method Delta or RunLength
+ * @param elementSize 1, 2, 4 or 8
+ * @param bigEndian The byte order of the elements, which Delta needs to do arithmetic on them
+ * @return The block with its header. Stored when encoding does not pay off.
+ */
+inline std::vector<uint8_t> encodeElements(const void* data, size_t size, Method method, size_t elementSize, bool bigEndian)
+{
+  const uint8_t* source = static_cast<const uint8_t*>(data);
+  std::vector<uint8_t> output;
+  output.reserve(k_HeaderSize + 2 + size / 4);
+  writeUInt32(output, static_cast<uint32_t>(size));
+  output.push_back(static_cast<uint8_t>(method));
+  output.push_back(static_cast<uint8_t>(elementSize));
+  output.push_back(bigEndian ? 1 : 0);
+  bool swap = (bigEndian != isBigEndianHost());
+  size_t count = (elementSize == 0) ? 0 : size / elementSize;
+  bool delta = (method == Method::Delta);
+  switch(delta ? elementSize : elementSize + 16)
+  {
+  case 1:
+    deltaEncodeElements<uint8_t>(source, count, swap, output);
+    break;
+  case 2:
+    deltaEncodeElements<uint16_t>(source, count, swap, output);
+    break;
+  case 4:
+    deltaEncodeElements<uint32_t>(source, count, swap, output);
+    break;
+  case 8:
+    deltaEncodeElements<uint64_t>(source, count, swap, output);
+    break;
+  case 17:
+    runLengthEncodeElements<uint8_t>(source, count, output);
+    break;
+  case 18:
+    runLengthEncodeElements<uint16_t>(source, count, output);
+    break;
+  case 20:
+    runLengthEncodeElements<uint32_t>(source, count, output);
+    break;
+  case 24:
+    runLengthEncodeElements<uint64_t>(source, count, output);
+    break;
+  default:
+    count = 0;
+    output.resize(k_HeaderSize - 1);
+    output.push_back(static_cast<uint8_t>(Method::Stored));
+  }
+  if(output.size() >= k_HeaderSize + size)
+  {
+    count = 0;
+    output.resize(k_HeaderSize - 1);
+    output.push_back(static_cast<uint8_t>(Method::Stored));
+  }
+  output.insert(output.end(), source + count * elementSize, source + size);
+  return output;
+}
+
+// -----------------------------------------------------------------------------
+inline bool decodeElements(ByteReader& reader, size_t size, Method method, uint8_t* output)
+{
+  uint8_t elementSize = 0;
+  uint8_t bigEndian = 0;
+  if(!reader.readByte(elementSize) || !reader.readByte(bigEndian) || elementSize == 0)
+  {
+    return false;
+  }
+  bool swap = ((bigEndian != 0) != isBigEndianHost());
+  size_t count = size / elementSize;
+  bool decoded = false;
+  bool delta = (method == Method::Delta);
+  switch(delta ? elementSize : elementSize + 16)
+  {
+  case 1:
+    decoded = deltaDecodeElements<uint8_t>(reader, count, swap, output);
+    break;
+  case 2:
+    decoded = deltaDecodeElements<uint16_t>(reader, count, swap, output);
+    break;
+  case 4:
+    decoded = deltaDecodeElements<uint32_t>(reader, count, swap, output);
+    break;
+  case 8:
+    decoded = deltaDecodeElements<uint64_t>(reader, count, swap, output);
+    break;
+  case 17:
+    decoded = runLengthDecodeElements<uint8_t>(reader, count, output);
+    break;
+  case 18:
+    decoded = runLengthDecodeElements<uint16_t>(reader, count, output);
+    break;
+  case 20:
+    decoded = runLengthDecodeElements<uint32_t>(reader, count, output);
+    break;
+  case 24:
+    decoded = runLengthDecodeElements<uint64_t>(reader, count, output);
+    break;
+  default:
+    return false;
+  }
+  const uint8_t* tail = nullptr;
+  size_t tailSize = size - count * elementSize;
+  if(!decoded || !reader.take(tailSize, tail))
+  {
+    return false;
+  }
+  std::memcpy(output + count * elementSize, tail, tailSize);
+  return true;
+}
+
+// -----------------------------------------------------------------------------
+template <typename U> inline void roundMantissaElements(uint8_t* data, size_t count, uint32_t mantissaBits, uint32_t keepBits, bool swap)
+{
+  const uint32_t drop = mantissaBits - keepBits;
+  const U mask = static_cast<U>(~((static_cast<U>(1) << drop) - 1));
+  const U half = static_cast<U>(static_cast<U>(1) << (drop - 1));
+  const U exponentMask = static_cast<U>(static_cast<U>(~static_cast<U>(0)) >> 1 & ~((static_cast<U>(1) << mantissaBits) - 1));
+  for(size_t i = 0; i < count; ++i)
+  {
+    U bits = loadElement<U>(data + i * sizeof(U), swap);
+    if((bits & exponentMask) == exponentMask)
+    {
+      // Infinity and NaN keep their payload
+      continue;
+    }
+    // Round half to even; a carry out of the mantissa bumps the exponent, which is still exact
+    U rounded = static_cast<U>((bits + half - 1 + ((bits >> drop) & 1)) & mask);
+    if((rounded & exponentMask) == exponentMask)
+    {
+      // Rounding the largest finite values up would give infinity, so they are truncated
+      rounded = static_cast<U>(bits & mask);
+    }
+    storeElement<U>(data + i * sizeof(U), rounded, swap);
+  }
+}
+
+/**
+ * @brief Rounds IEEE floats in place to keepBits explicit mantissa bits, to nearest with ties
+ * to even. The relative error of each normal value is at most 2^-(keepBits + 1); values next to
+ * the largest finite one are truncated instead and stay within 2^-keepBits. Zeros, infinities
+ * and NaNs are unchanged, and subnormals keep an absolute error below the smallest normal value
+ * times 2^-(keepBits + 1). Keeping all mantissa bits (23 and 52) leaves the data as it is.
+ * @param data
+ * @param size The size in bytes. A trailing partial element is left as it is.
+ * @param elementSize 4 or 8
+ * @param bigEndian The byte order of the elements
+ * @param keepBits
+ * @return False for an element size other than 4 or 8
+ */
+inline bool roundMantissas(void* data, size_t size, size_t elementSize, bool bigEndian, uint32_t keepBits)
+{
+  uint8_t* bytes = static_cast<uint8_t*>(data);
+  bool swap = (bigEndian != isBigEndianHost());
+  if(elementSize == 4)
+  {
+    if(keepBits < 23)
+    {
+      roundMantissaElements<uint32_t>(bytes, size / 4, 23, keepBits, swap);
+    }
+    return true;
+  }
+  if(elementSize == 8)
+  {
+    if(keepBits < 52)
+    {
+      roundMantissaElements<uint64_t>(bytes, size / 8, 52, keepBits, swap);
+    }
+    return true;
+  }
+  return false;
+}
+
+/**
+ * @brief Compresses a block
+ * @param data
+ * @param size
+ * @param method LZ, LZH or Stored
+ * @param level LZH search effort, 1 - 9
+ * @return The block with its header. Stored when compression does not pay off.
+ */
+inline std::vector<uint8_t> compress(const void* data, size_t size, Method method, int32_t level = k_DefaultLevel)
+{
+  const uint8_t* source = static_cast<const uint8_t*>(data);
+  std::vector<uint8_t> output;
+  output.reserve(k_HeaderSize + size / 2);
+  writeUInt32(output, static_cast<uint32_t>(size));
+  output.push_back(static_cast<uint8_t>(method));
+  if(method == Method::LZ)
+  {
+    LZStreams streams = {&output, &output, &output, &output};
+    lzParseFast(source, size, streams);
+  }
+  else if(method == Method::LZH)
+  {
+    std::vector<uint8_t> commands;
+    std::vector<uint8_t> literals;
+    std::vector<uint8_t> offsetLow;
+    std::vector<uint8_t> offsetHigh;
+    LZStreams streams = {&commands, &literals, &offsetLow, &offsetHigh};
+    lzParseChained(source, size, streams, size_t(1) << std::min(std::max(level, 1), 9));
+    for(const auto* stream : {&commands, &literals, &offsetLow, &offsetHigh})
+    {
+      huffmanEncode(*stream, output);
+    }
+  }
+  if(method == Method::Stored || output.size() >= k_HeaderSize + size)
+  {
+    output.resize(k_HeaderSize - 1);
+    output.push_back(static_cast<uint8_t>(Method::Stored));
+    output.insert(output.end(), source, source + size);
+  }
+  return output;
+}
+
+/**
+ * @brief Reads the uncompressed size from the header of a block
+ * @return False if the block is too short to have a header
+ */
+inline bool getDecompressedSize(const void* data, size_t size, size_t& decompressedSize)
+{
+  ByteReader reader = {static_cast<const uint8_t*>(data), static_cast<const uint8_t*>(data) + size};
+  uint32_t value = 0;
+  bool ok = reader.readUInt32(value);
+  decompressedSize = value;
+  return ok && size >= k_HeaderSize;
+}
+
+/**
+ * @brief Checks the uncompressed size in the header of a block against what the rest of the
+ * block can hold, so that a corrupt header is rejected before its size is allocated. Stored
+ * blocks must hold every byte. Delta blocks spend at least one byte per element and RunLength
+ * blocks are walked run by run without decoding them. LZ and LZH blocks are checked while they
+ * are decoded.
+ * @param data The block
+ * @param size The size of the block
+ * @param elementSize The element size the block must have been encoded with, 0 if unknown
+ * @return False if the block can not decode to getDecompressedSize() bytes
+ */
+inline bool checkDecompressedSize(const void* data, size_t size, size_t elementSize)
+{
+  ByteReader reader = {static_cast<const uint8_t*>(data), static_cast<const uint8_t*>(data) + size};
+  uint32_t decompressedSize = 0;
+  uint8_t method = 0;
+  if(!reader.readUInt32(decompressedSize) || !reader.readByte(method))
+  {
+    return false;
+  }
+  if(method == static_cast<uint8_t>(Method::Stored))
+  {
+    return size - k_HeaderSize >= decompressedSize;
+  }
+  if(method != static_cast<uint8_t>(Method::Delta) && method != static_cast<uint8_t>(Method::RunLength))
+  {
+    return true;
+  }
+  uint8_t blockElementSize = 0;
+  uint8_t bigEndian = 0;
+  if(!reader.readByte(blockElementSize) || !reader.readByte(bigEndian) || blockElementSize == 0 || (elementSize != 0 && blockElementSize != elementSize))
+  {
+    return false;
+  }
+  size_t count = decompressedSize / blockElementSize;
+  size_t tailSize = decompressedSize - count * blockElementSize;
+  if(method == static_cast<uint8_t>(Method::Delta))
+  {
+    return static_cast<size_t>(reader.end - reader.pos) >= count + tailSize;
+  }
+  const uint8_t* element = nullptr;
+  for(size_t i = 0; i < count;)
+  {
+    uint64_t run = 0;
+    if(!readVarint(reader, run) || run >= count - i || !reader.take(blockElementSize, element))
+    {
+      return false;
+    }
+    i += static_cast<size_t>(run) + 1;
+  }
+  return reader.take(tailSize, element);
+}
+
+/**
+ * @brief Decompresses a block made by compress()
+ * @param data The block
+ * @param size The size of the block
+ * @param output getDecompressedSize() bytes
+ * @return False if the block is corrupt
+ */
+inline bool decompress(const void* data, size_t size, uint8_t* output)
+{
+  ByteReader reader = {static_cast<const uint8_t*>(data), static_cast<const uint8_t*>(data) + size};
+  uint32_t decompressedSize = 0;
+  uint8_t method = 0;
+  if(!reader.readUInt32(decompressedSize) || !reader.readByte(method))
+  {
+    return false;
+  }
+  if(method == static_cast<uint8_t>(Method::Stored))
+  {
+    const uint8_t* stored = nullptr;
+    if(!reader.take(decompressedSize, stored))
+    {
+      return false;
+    }
+    std::memcpy(output, stored, decompressedSize);
+    return true;
+  }
+  if(method == static_cast<uint8_t>(Method::LZ))
+  {
+    return lzDecode(reader, reader, reader, reader, output, decompressedSize);
+  }
+  if(method == static_cast<uint8_t>(Method::Delta) || method == static_cast<uint8_t>(Method::RunLength))
+  {
+    return decodeElements(reader, decompressedSize, static_cast<Method>(method), output);
+  }
+  if(method != static_cast<uint8_t>(Method::LZH))
+  {
+    return false;
+  }
+  // No LZ stream is longer than the block it rebuilds
+  std::vector<uint8_t> streams[4];
+  for(auto& stream : streams)
+  {
+    if(!huffmanDecode(reader, decompressedSize, stream))
+    {
+      return false;
+    }
+  }
+  ByteReader readers[4];
+  for(size_t i = 0; i < 4; ++i)
+  {
+    readers[i] = {streams[i].data(), streams[i].data() + streams[i].size()};
+  }
+  return lzDecode(readers[0], readers[1], readers[2], readers[3], output, decompressedSize);
+}
+} // namespace H5Codec
+
+namespace H5Lite
+{
+/**
+ * @brief Filter ids of the in-tree codecs. They are taken from the 32768 - 65535 range HDF5
+ * leaves for private use, so they can not clash with a filter registered with The HDF Group.
+ * Files using them can only be read by programs that register these filters.
+ *
+ * The delta, run-length and bit rounding filters go in the transform slot of H5FilterPipeline.
+ * The bit rounding filter takes the number of mantissa bits to keep as its client data value:
+ * @code
+ * // Visualization grade floats: 10 mantissa bits, a relative error of at most 2^-11
+ * H5FilterPipeline pipeline = H5FilterPipeline::Codec(H5Lite::k_LZFilterID);
+ * pipeline.transform = H5Lite::k_BitRoundFilterID;
+ * pipeline.transformValues = {10};
+ * H5Lite::writeVectorDatasetCompressed(fileID, "Field", dims, values, chunkDims, pipeline);
+ * @endcode
+ */
+constexpr H5Z_filter_t k_LZFilterID = 47301;
+constexpr H5Z_filter_t k_LZHFilterID = 47302;
+constexpr H5Z_filter_t k_DeltaFilterID = 47303;
+constexpr H5Z_filter_t k_RunLengthFilterID = 47304;
+constexpr H5Z_filter_t k_BitRoundFilterID = 47305;
+
+/**
+ * @brief The HDF5 filter callback shared by the codecs. HDF5 calls it from C, so no exception
+ * may leave it: a failed allocation fails the filter instead.
+ */
+inline size_t codecFilter(H5Codec::Method method, uint32_t flags, size_t cdNumElements, const uint32_t cdValues[], size_t numBytes, size_t* bufferSize, void** buffer)
+{
+  uint8_t* output = nullptr;
+  size_t outputSize = 0;
+  bool elementMethod = (method == H5Codec::Method::Delta || method == H5Codec::Method::RunLength);
+  try
+  {
+    if((flags & H5Z_FLAG_REVERSE) != 0)
+    {
+      // Client data set by setLocalElementLayout() starts with the element size
+      size_t elementSize = (elementMethod && cdNumElements > 0) ? cdValues[0] : 0;
+      if(!H5Codec::getDecompressedSize(*buffer, numBytes, outputSize) || !H5Codec::checkDecompressedSize(*buffer, numBytes, elementSize))
+      {
+        return 0;
+      }
+      output = static_cast<uint8_t*>(H5allocate_memory(std::max<size_t>(outputSize, 1), false));
+      if(output == nullptr)
+      {
+        return 0;
+      }
+      if(!H5Codec::decompress(*buffer, numBytes, output))
+      {
+        H5free_memory(output);
+        return 0;
+      }
+    }
+    else
+    {
+      // The encoders build the block in a std::vector, which costs one more copy of each
+      // compressed chunk into the buffer HDF5 owns
+      std::vector<uint8_t> compressed;
+      if(elementMethod)
+      {
+        // Client data set by setLocalElementLayout(): element size, then 1 for big endian
+        size_t elementSize = (cdNumElements > 0) ? cdValues[0] : 1;
+        bool bigEndian = (cdNumElements > 1) && cdValues[1] != 0;
+        compressed = H5Codec::encodeElements(*buffer, numBytes, method, elementSize, bigEndian);
+      }
+      else
+      {
+        int32_t level = (cdNumElements > 0) ? static_cast<int32_t>(cdValues[0]) : H5Codec::k_DefaultLevel;
+        compressed = H5Codec::compress(*buffer, numBytes, method, level);
+      }
+      outputSize = compressed.size();
+      output = static_cast<uint8_t*>(H5allocate_memory(outputSize, false));
+      if(output == nullptr)
+      {
+        return 0;
+      }
+      std::memcpy(output, compressed.data(), outputSize);
+    }
+  } catch(...)
+  {
+    if(output != nullptr)
+    {
+      H5free_memory(output);
+    }
+    return 0;
+  }
+  H5free_memory(*buffer);
+  *buffer = output;
+  *bufferSize = std::max<size_t>(outputSize, 1);
+  return outputSize;
+}
+
+// -----------------------------------------------------------------------------
+inline size_t lzFilter(unsigned int flags, size_t cdNumElements, const unsigned int cdValues[], size_t numBytes, size_t* bufferSize, void** buffer)
+{
+  return codecFilter(H5Codec::Method::LZ, flags, cdNumElements, cdValues, numBytes, bufferSize, buffer);
+}
+
+// -----------------------------------------------------------------------------
+inline size_t lzhFilter(unsigned int flags, size_t cdNumElements, const unsigned int cdValues[], size_t numBytes, size_t* bufferSize, void** buffer)
+{
+  return codecFilter(H5Codec::Method::LZH, flags, cdNumElements, cdValues, numBytes, bufferSize, buffer);
+}
+
+// -----------------------------------------------------------------------------
+inline size_t deltaFilter(unsigned int flags, size_t cdNumElements, const unsigned int cdValues[], size_t numBytes, size_t* bufferSize, void** buffer)
+{
+  return codecFilter(H5Codec::Method::Delta, flags, cdNumElements, cdValues, numBytes, bufferSize, buffer);
+}
+
+// -----------------------------------------------------------------------------
+inline size_t runLengthFilter(unsigned int flags, size_t cdNumElements, const unsigned int cdValues[], size_t numBytes, size_t* bufferSize, void** buffer)
+{
+  return codecFilter(H5Codec::Method::RunLength, flags, cdNumElements, cdValues, numBytes, bufferSize, buffer);
+}
+
+/**
+ * @brief The can_apply callback of the element filters: they only take 1, 2, 4 or 8 byte integers
+ */
+inline htri_t canApplyElementFilter(hid_t /*propertyListID*/, hid_t typeID, hid_t /*spaceID*/)
+{
+  size_t typeSize = H5Tget_size(typeID);
+  return (H5Tget_class(typeID) == H5T_INTEGER && (typeSize == 1 || typeSize == 2 || typeSize == 4 || typeSize == 8)) ? 1 : 0;
+}
+
+/**
+ * @brief The set_local callback of the element filters: records the element size and byte
+ * order of the dataset type as the client data of the filter
+ */
+inline herr_t setLocalElementLayout(hid_t propertyListID, hid_t typeID, H5Z_filter_t filter)
+{
+  uint32_t flags = 0;
+  size_t numValues = 0;
+  herr_t error = H5Pget_filter_by_id2(propertyListID, filter, &flags, &numValues, nullptr, 0, nullptr, nullptr);
+  if(error < 0)
+  {
+    return error;
+  }
+  const uint32_t values[2] = {static_cast<uint32_t>(H5Tget_size(typeID)), (H5Tget_order(typeID) == H5T_ORDER_BE) ? 1u : 0u};
+  return H5Pmodify_filter(propertyListID, filter, flags, 2, values);
+}
+
+// -----------------------------------------------------------------------------
+inline herr_t setLocalDelta(hid_t propertyListID, hid_t typeID, hid_t /*spaceID*/)
+{
+  return setLocalElementLayout(propertyListID, typeID, k_DeltaFilterID);
+}
+
+// -----------------------------------------------------------------------------
+inline herr_t setLocalRunLength(hid_t propertyListID, hid_t typeID, hid_t /*spaceID*/)
+{
+  return setLocalElementLayout(propertyListID, typeID, k_RunLengthFilterID);
+}
+
+/**
+ * @brief The HDF5 filter callback of the bit rounding filter. Writing rounds the chunk in place;
+ * reading passes it through, as the dropped bits are gone.
+ */
+inline size_t bitRoundFilter(unsigned int flags, size_t cdNumElements, const unsigned int cdValues[], size_t numBytes, size_t* /*bufferSize*/, void** buffer)
+{
+  if((flags & H5Z_FLAG_REVERSE) != 0)
+  {
+    return numBytes;
+  }
+  // Client data: mantissa bits to keep, then element size and 1 for big endian from setLocalBitRound()
+  if(cdNumElements < 3 || !H5Codec::roundMantissas(*buffer, numBytes, cdValues[1], cdValues[2] != 0, cdValues[0]))
+  {
+    return 0;
+  }
+  return numBytes;
+}
+
+/**
+ * @brief The can_apply callback of the bit rounding filter: it only takes IEEE single and double
+ * precision types
+ */
+inline htri_t canApplyBitRound(hid_t /*propertyListID*/, hid_t typeID, hid_t /*spaceID*/)
+{
+  if(H5Tget_class(typeID) != H5T_FLOAT)
+  {
+    return 0;
+  }
+  size_t signPosition = 0;
+  size_t exponentPosition = 0;
+  size_t exponentSize = 0;
+  size_t mantissaPosition = 0;
+  size_t mantissaSize = 0;
+  if(H5Tget_fields(typeID, &signPosition, &exponentPosition, &exponentSize, &mantissaPosition, &mantissaSize) < 0)
+  {
+    return -1;
+  }
+  size_t typeSize = H5Tget_size(typeID);
+  return ((typeSize == 4 && mantissaSize == 23 && exponentSize == 8) || (typeSize == 8 && mantissaSize == 52 && exponentSize == 11)) && mantissaPosition == 0 ? 1 : 0;
+}
+
+/**
+ * @brief The set_local callback of the bit rounding filter: keeps the mantissa bit count the
+ * pipeline was given and appends the element size and byte order of the dataset type
+ */
+inline herr_t setLocalBitRound(hid_t propertyListID, hid_t typeID, hid_t /*spaceID*/)
+{
+  uint32_t flags = 0;
+  size_t numValues = 1;
+  uint32_t keepBits = 0;
+  herr_t error = H5Pget_filter_by_id2(propertyListID, k_BitRoundFilterID, &flags, &numValues, &keepBits, 0, nullptr, nullptr);
+  if(error < 0 || numValues < 1)
+  {
+    return -1;
+  }
+  const uint32_t values[3] = {keepBits, static_cast<uint32_t>(H5Tget_size(typeID)), (H5Tget_order(typeID) == H5T_ORDER_BE) ? 1u : 0u};
+  return H5Pmodify_filter(propertyListID, k_BitRoundFilterID, flags, 3, values);
+}
+
+/**
+ * @brief Registers the in-tree codec filters with HDF5. Including this header registers them
+ * during static initialization, so datasets written with them read back through the plain
+ * H5Lite readers. Calling it again does nothing.
+ * @return Standard HDF5 error condition of the registration
+ */
+inline herr_t registerCodecFilters()
+{
+  H5SUPPORT_MUTEX_LOCK()
+
+  static const herr_t s_Error = []() {
+    static const H5Z_class2_t k_LZClass = {H5Z_CLASS_T_VERS, k_LZFilterID, 1, 1, "H5Support LZ", nullptr, nullptr, lzFilter};
+    static const H5Z_class2_t k_LZHClass = {H5Z_CLASS_T_VERS, k_LZHFilterID, 1, 1, "H5Support LZH", nullptr, nullptr, lzhFilter};
+    static const H5Z_class2_t k_DeltaClass = {H5Z_CLASS_T_VERS, k_DeltaFilterID, 1, 1, "H5Support Delta", canApplyElementFilter, setLocalDelta, deltaFilter};
+    static const H5Z_class2_t k_RunLengthClass = {H5Z_CLASS_T_VERS, k_RunLengthFilterID, 1, 1, "H5Support RunLength", canApplyElementFilter, setLocalRunLength, runLengthFilter};
+    static const H5Z_class2_t k_BitRoundClass = {H5Z_CLASS_T_VERS, k_BitRoundFilterID, 1, 1, "H5Support BitRound", canApplyBitRound, setLocalBitRound, bitRoundFilter};
+    herr_t error = 0;
+    for(const H5Z_class2_t* filterClass : {&k_LZClass, &k_LZHClass, &k_DeltaClass, &k_RunLengthClass, &k_BitRoundClass})
+    {
+      if(error >= 0)
+      {
+        error = H5Zregister(filterClass);
+      }
+    }
+    if(error < 0)
+    {
+      std::cout << "H5CodecFilters.h::registerCodecFilters(" << __LINE__ << ") Error registering the codec filters" << std::endl;
+    }
+    return error;
+  }();
+  return s_Error;
+}
+
+static const herr_t k_CodecFiltersRegistered = registerCodecFilters();
+} // namespace H5Lite
+
+#if defined(H5Support_NAMESPACE)
+}
+#endif
@@ -0,0 +1,349 @@
+/* ============================================================================
+ * Copyright (c) 2007-2019 BlueQuartz Software, LLC
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+ * contributors may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The code contained herein was partially funded by the followig contracts:
+ *    United States Air Force Prime Contract FA8650-04-C-5229
+ *    United States Air Force Prime Contract FA8650-15-D-5231
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#pragma once
+
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <hdf5.h>
+
+#include "H5Support/H5Lite.h"
+#include "H5Support/H5Macros.h"
+#include "H5Support/H5Support.h"
+#include "H5Support/H5TypeTraits.h"
+
+#if defined(H5Support_NAMESPACE)
+namespace H5Support_NAMESPACE
+{
+#endif
+
+/**
+ * @brief The H5CompoundColumns class describes data held as a struct of arrays: one buffer
+ * per member of a compound dataset. H5Lite::writeCompoundColumnsDataset() and
+ * H5Lite::readCompoundColumnsDataset() move every buffer with its own H5Dwrite / H5Dread
+ * through a single member memory type, so no interleaved array of structs is ever built.
+ * The buffers are referenced, not copied, and must outlive the call.
+ * @code
+ * H5CompoundColumns columns;
+ * columns.add("id", ids.data());
+ * columns.add("Position", positions.data(), 3); // 3 floats per element
+ * H5Lite::writeCompoundColumnsDataset(fileID, "Grains", {ids.size()}, columns);
+ * @endcode
+ */
+class H5CompoundColumns
+{
+public:
+  struct Column
+  {
+    std::string name;
+    hid_t typeID = -1;
+    void* data = nullptr;
+    bool writable = false;
+  };
+
+  H5CompoundColumns() = default;
+
+  ~H5CompoundColumns()
+  {
+    H5SUPPORT_MUTEX_LOCK_SHARED()
+
+    for(const auto& column : m_Columns)
+    {
+      if(column.typeID >= 0)
+      {
+        H5Tclose(column.typeID);
+      }
+    }
+  }
+
+  H5CompoundColumns(const H5CompoundColumns&) = delete;            // Copy Constructor Not Implemented
+  H5CompoundColumns(H5CompoundColumns&&) = delete;                 // Move Constructor Not Implemented
+  H5CompoundColumns& operator=(const H5CompoundColumns&) = delete; // Copy Assignment Not Implemented
+  H5CompoundColumns& operator=(H5CompoundColumns&&) = delete;      // Move Assignment Not Implemented
+
+  /**
+   * @brief Adds a column that can be written and read
+   * @param name The name of the compound member
+   * @param data The buffer, numElements * componentCount values
+   * @param componentCount Values per element. More than 1 stores an H5T_ARRAY member.
+   * @return Standard HDF5 error condition
+   */
+  template <typename T> herr_t add(const std::string& name, T* data, hsize_t componentCount = 1)
+  {
+    return addColumn(name, H5TypeTraits<T>::type(), data, componentCount, true);
+  }
+
+  /**
+   * @brief Adds a column that can only be written
+   * @param name The name of the compound member
+   * @param data The buffer, numElements * componentCount values
+   * @param componentCount Values per element. More than 1 stores an H5T_ARRAY member.
+   * @return Standard HDF5 error condition
+   */
+  template <typename T> herr_t add(const std::string& name, const T* data, hsize_t componentCount = 1)
+  {
+    return addColumn(name, H5TypeTraits<T>::type(), const_cast<T*>(data), componentCount, false);
+  }
+
+  const std::vector<Column>& getColumns() const
+  {
+    return m_Columns;
+  }
+
+  /**
+   * @brief Creates the packed compound type holding every column in the order they were
+   * added. The caller closes it.
+   * @return
+   */
+  hid_t createFileType() const
+  {
+    H5SUPPORT_MUTEX_LOCK_SHARED()
+
+    size_t size = 0;
+    for(const auto& column : m_Columns)
+    {
+      size += H5Tget_size(column.typeID);
+    }
+    hid_t typeID = H5Tcreate(H5T_COMPOUND, size);
+    size_t offset = 0;
+    for(const auto& column : m_Columns)
+    {
+      if(typeID >= 0 && H5Tinsert(typeID, column.name.c_str(), offset, column.typeID) < 0)
+      {
+        H5Tclose(typeID);
+        typeID = -1;
+      }
+      offset += H5Tget_size(column.typeID);
+    }
+    return typeID;
+  }
+
+private:
+  herr_t addColumn(const std::string& name, hid_t elementType, void* data, hsize_t componentCount, bool writable)
+  {
+    if(nullptr == data || componentCount == 0)
+    {
+      return -1;
+    }
+    for(const auto& column : m_Columns)
+    {
+      if(column.name == name)
+      {
+        std::cout << "H5CompoundColumns: Column '" << name << "' was already added" << std::endl;
+        return -2;
+      }
+    }
+
+    H5SUPPORT_MUTEX_LOCK_SHARED()
+
+    Column column;
+    column.name = name;
+    column.data = data;
+    column.writable = writable;
+    column.typeID = (componentCount == 1) ? H5Tcopy(elementType) : H5Tarray_create2(elementType, 1, &componentCount);
+    if(column.typeID < 0)
+    {
+      return static_cast<herr_t>(column.typeID);
+    }
+    m_Columns.push_back(column);
+    return 0;
+  }
+
+  std::vector<Column> m_Columns;
+};
+
+namespace H5Lite
+{
+/**
+ * @brief Creates a compound type holding the single member of column at offset 0. This is
+ * the memory type for moving that member alone. The caller closes it.
+ */
+inline hid_t createColumnMemoryType(const H5CompoundColumns::Column& column)
+{
+  hid_t typeID = H5Tcreate(H5T_COMPOUND, H5Tget_size(column.typeID));
+  if(typeID >= 0 && H5Tinsert(typeID, column.name.c_str(), 0, column.typeID) < 0)
+  {
+    H5Tclose(typeID);
+    return -1;
+  }
+  return typeID;
+}
+
+/**
+ * @brief Creates a compound dataset with one member per column and writes each column
+ * straight from its own buffer. HDF5 merges every member write into the stored records,
+ * so memory use stays at the size of the columns themselves.
+ * @param locationID The parent location for the dataset
+ * @param datasetName The name of the dataset
+ * @param dims The dimensions of the dataset. Every column holds prod(dims) elements.
+ * @param columns The columns
+ * @return Standard HDF5 error conditions
+ */
+inline herr_t writeCompoundColumnsDataset(hid_t locationID, const std::string& datasetName, const std::vector<hsize_t>& dims, const H5CompoundColumns& columns)
+{
+  H5SUPPORT_MUTEX_LOCK()
+
+  if(columns.getColumns().empty())
+  {
+    std::cout << "writeCompoundColumnsDataset: '" << datasetName << "' needs at least one column" << std::endl;
+    return -1;
+  }
+  herr_t error = 0;
+  herr_t returnError = 0;
+
+  hid_t fileTypeID = columns.createFileType();
+  if(fileTypeID < 0)
+  {
+    std::cout << "writeCompoundColumnsDataset: Error creating the compound type of '" << datasetName << "'" << std::endl;
+    return static_cast<herr_t>(fileTypeID);
+  }
+  hid_t dataspaceID = H5Screate_simple(static_cast<int>(dims.size()), dims.data(), nullptr);
+  if(dataspaceID >= 0)
+  {
+    hid_t datasetID = H5Dcreate(locationID, datasetName.c_str(), fileTypeID, dataspaceID, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+    if(datasetID >= 0)
+    {
+      for(const auto& column : columns.getColumns())
+      {
+        hid_t memoryTypeID = createColumnMemoryType(column);
+        error = (memoryTypeID < 0) ? static_cast<herr_t>(memoryTypeID) : H5Dwrite(datasetID, memoryTypeID, H5S_ALL, H5S_ALL, H5P_DEFAULT, column.data);
+        H5SUPPORT_INSTRUMENT_BYTES(error, H5Instrumentation::dataspaceBytes(dataspaceID, column.typeID))
+        if(error < 0)
+        {
+          std::cout << "writeCompoundColumnsDataset: Error writing column '" << column.name << "' of '" << datasetName << "'" << std::endl;
+          returnError = error;
+        }
+        if(memoryTypeID >= 0)
+        {
+          CloseH5T(memoryTypeID, error, returnError);
+        }
+        if(returnError < 0)
+        {
+          break;
+        }
+      }
+      CloseH5D(datasetID, error, returnError, datasetName);
+    }
+    else
+    {
+      std::cout << "writeCompoundColumnsDataset: Error creating Dataset '" << datasetName << "'" << std::endl;
+      returnError = static_cast<herr_t>(datasetID);
+    }
+    CloseH5S(dataspaceID, error, returnError);
+  }
+  else
+  {
+    returnError = static_cast<herr_t>(dataspaceID);
+  }
+  CloseH5T(fileTypeID, error, returnError);
+  return returnError;
+}
+
+/**
+ * @brief Reads members of a compound dataset into separate buffers, one H5Dread per
+ * column. Columns are matched to members by name; members without a column are skipped.
+ * @param locationID The parent location that contains the dataset to read
+ * @param datasetName The name of the dataset to read
+ * @param columns Writable columns, each with room for every element of the dataset
+ * @return Standard HDF5 error conditions. -2 if a column has no matching member, -3 if a column is read only.
+ */
+inline herr_t readCompoundColumnsDataset(hid_t locationID, const std::string& datasetName, const H5CompoundColumns& columns)
+{
+  H5SUPPORT_MUTEX_LOCK_SHARED()
+
+  herr_t error = 0;
+  herr_t returnError = 0;
+  hid_t datasetID = H5Dopen(locationID, datasetName.c_str(), H5P_DEFAULT);
+  if(datasetID < 0)
+  {
+    std::cout << "readCompoundColumnsDataset(" << __LINE__ << ") Error opening Dataset at locationID (" << locationID << ") with object name (" << datasetName << ")" << std::endl;
+    return -1;
+  }
+  hid_t fileTypeID = H5Dget_type(datasetID);
+  hid_t dataspaceID = H5Dget_space(datasetID);
+  if(fileTypeID < 0 || H5Tget_class(fileTypeID) != H5T_COMPOUND)
+  {
+    std::cout << "readCompoundColumnsDataset: '" << datasetName << "' is not a compound dataset" << std::endl;
+    returnError = -2;
+  }
+  for(const auto& column : columns.getColumns())
+  {
+    if(returnError < 0)
+    {
+      break;
+    }
+    if(!column.writable)
+    {
+      std::cout << "readCompoundColumnsDataset: Column '" << column.name << "' is read only" << std::endl;
+      returnError = -3;
+      break;
+    }
+    if(H5Tget_member_index(fileTypeID, column.name.c_str()) < 0)
+    {
+      std::cout << "readCompoundColumnsDataset: '" << datasetName << "' has no member '" << column.name << "'" << std::endl;
+      returnError = -2;
+      break;
+    }
+    hid_t memoryTypeID = createColumnMemoryType(column);
+    error = (memoryTypeID < 0) ? static_cast<herr_t>(memoryTypeID) : H5Dread(datasetID, memoryTypeID, H5S_ALL, H5S_ALL, H5P_DEFAULT, column.data);
+    H5SUPPORT_INSTRUMENT_BYTES(error, H5Instrumentation::dataspaceBytes(dataspaceID, column.typeID))
+    if(error < 0)
+    {
+      std::cout << "readCompoundColumnsDataset: Error reading column '" << column.name << "' of '" << datasetName << "'" << std::endl;
+      returnError = error;
+    }
+    if(memoryTypeID >= 0)
+    {
+      CloseH5T(memoryTypeID, error, returnError);
+    }
+  }
+  if(dataspaceID >= 0)
+  {
+    CloseH5S(dataspaceID, error, returnError);
+  }
+  if(fileTypeID >= 0)
+  {
+    CloseH5T(fileTypeID, error, returnError);
+  }
+  CloseH5D(datasetID, error, returnError, datasetName);
+  return returnError;
+}
+} // namespace H5Lite
+
+#if defined(H5Support_NAMESPACE)
+}
+#endif
@@ -0,0 +1,302 @@
+/* ============================================================================
+ * Copyright (c) 2007-2019 BlueQuartz Software, LLC
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+ * contributors may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The code contained herein was partially funded by the followig contracts:
+ *    United States Air Force Prime Contract FA8650-04-C-5229
+ *    United States Air Force Prime Contract FA8650-15-D-5231
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <iostream>
+#include <string>
+#include <type_traits>
+
+#include <hdf5.h>
+
+#include "H5Support/H5Support.h"
+#include "H5Support/H5TypeTraits.h"
+
+#if defined(H5Support_NAMESPACE)
+namespace H5Support_NAMESPACE
+{
+#endif
+
+/**
+ * @brief Describes the members of a struct that is stored as an HDF5 compound type.
+ * Specialize it with the H5SUPPORT_BEGIN_COMPOUND / H5SUPPORT_COMPOUND_MEMBER /
+ * H5SUPPORT_END_COMPOUND macros below; the primary template marks a type as not registered.
+ */
+template <typename T> struct H5CompoundDescription
+{
+  static constexpr bool k_Registered = false;
+};
+
+/**
+ * @brief Fills dims with the extents of a (multi dimensional) C array type
+ */
+template <typename M> struct H5ArrayExtents
+{
+  static void fill(hsize_t* /*dims*/)
+  {
+  }
+};
+
+template <typename M, size_t N> struct H5ArrayExtents<M[N]>
+{
+  static void fill(hsize_t* dims)
+  {
+    dims[0] = N;
+    H5ArrayExtents<M>::fill(dims + 1);
+  }
+};
+
+/**
+ * @brief Creates the HDF5 type of one compound member. The returned id is always a new id
+ * that the caller closes. C arrays become H5T_ARRAY types of their element type.
+ */
+template <typename M, bool IsArray = std::is_array<M>::value> struct H5CompoundMemberType
+{
+  static_assert(H5TypeTraits<M>::k_Supported, "Compound members must be primitive types, C arrays of them or registered compound types");
+
+  static hid_t create()
+  {
+    return H5Tcopy(H5TypeTraits<M>::type());
+  }
+};
+
+template <typename M> struct H5CompoundMemberType<M, true>
+{
+  using ElementType = typename std::remove_all_extents<M>::type;
+  static_assert(H5TypeTraits<ElementType>::k_Supported, "Compound array members must have primitive or registered compound elements");
+
+  static hid_t create()
+  {
+    hsize_t dims[std::rank<M>::value];
+    H5ArrayExtents<M>::fill(dims);
+    return H5Tarray_create2(H5TypeTraits<ElementType>::type(), static_cast<unsigned>(std::rank<M>::value), dims);
+  }
+};
+
+/**
+ * @brief The H5CompoundTypeBuilder class assembles the H5T_COMPOUND type of T one member at
+ * a time. The first failing call is kept and reported by release(). It only creates
+ * transient type ids, so it takes the shared lock and can run inside read functions.
+ */
+template <typename T> class H5CompoundTypeBuilder
+{
+public:
+  H5CompoundTypeBuilder()
+  {
+    H5SUPPORT_MUTEX_LOCK_SHARED()
+
+    m_TypeID = H5Tcreate(H5T_COMPOUND, sizeof(T));
+    if(m_TypeID < 0)
+    {
+      m_Error = static_cast<herr_t>(m_TypeID);
+    }
+  }
+
+  ~H5CompoundTypeBuilder()
+  {
+    if(m_TypeID >= 0)
+    {
+      H5SUPPORT_MUTEX_LOCK_SHARED()
+
+      H5Tclose(m_TypeID);
+    }
+  }
+
+  H5CompoundTypeBuilder(const H5CompoundTypeBuilder&) = delete;            // Copy Constructor Not Implemented
+  H5CompoundTypeBuilder(H5CompoundTypeBuilder&&) = delete;                 // Move Constructor Not Implemented
+  H5CompoundTypeBuilder& operator=(const H5CompoundTypeBuilder&) = delete; // Copy Assignment Not Implemented
+  H5CompoundTypeBuilder& operator=(H5CompoundTypeBuilder&&) = delete;      // Move Assignment Not Implemented
+
+  /**
+   * @brief Adds a member whose HDF5 type is derived from its C++ type M
+   * @param name The name of the member in the file
+   * @param offset The offset of the member in T, i.e. offsetof(T, member)
+   * @return
+   */
+  template <typename M> H5CompoundTypeBuilder& add(const std::string& name, size_t offset)
+  {
+    H5SUPPORT_MUTEX_LOCK_SHARED()
+
+    hid_t memberType = H5CompoundMemberType<M>::create();
+    add(name, offset, memberType);
+    if(memberType >= 0)
+    {
+      H5Tclose(memberType);
+    }
+    return *this;
+  }
+
+  /**
+   * @brief Adds a member with an explicit HDF5 type. The type is copied, the caller keeps ownership.
+   * @param name The name of the member in the file
+   * @param offset The offset of the member in T
+   * @param memberType The HDF5 type of the member
+   * @return
+   */
+  H5CompoundTypeBuilder& add(const std::string& name, size_t offset, hid_t memberType)
+  {
+    if(m_TypeID < 0 || m_Error < 0)
+    {
+      return *this;
+    }
+
+    H5SUPPORT_MUTEX_LOCK_SHARED()
+
+    herr_t error = (memberType < 0) ? static_cast<herr_t>(memberType) : H5Tinsert(m_TypeID, name.c_str(), offset, memberType);
+    if(error < 0)
+    {
+      std::cout << "H5CompoundTypeBuilder: Error adding member '" << name << "' at offset " << offset << std::endl;
+      m_Error = error;
+    }
+    return *this;
+  }
+
+  /**
+   * @brief Hands the finished type to the caller, who closes it
+   * @return The compound type or a negative value if any member failed
+   */
+  hid_t release()
+  {
+    if(m_Error < 0)
+    {
+      return m_Error;
+    }
+    hid_t typeID = m_TypeID;
+    m_TypeID = -1;
+    return typeID;
+  }
+
+private:
+  hid_t m_TypeID = -1;
+  herr_t m_Error = 0;
+};
+
+/**
+ * @brief H5TypeTraits of registered compound types. The type is built on first use and
+ * then cached for the life of the process, so it must not be closed by callers, just
+ * like the H5T_NATIVE_* types. The cache is not rebuilt if the application calls H5close().
+ */
+template <typename T> struct H5TypeTraits<T, typename std::enable_if<H5CompoundDescription<T>::k_Registered>::type>
+{
+  static_assert(std::is_standard_layout<T>::value, "Compound types need a standard layout so member offsets are well defined");
+
+  static constexpr bool k_Supported = true;
+
+  static hid_t type()
+  {
+    static std::atomic<hid_t> s_TypeID(-1);
+    hid_t typeID = s_TypeID.load(std::memory_order_acquire);
+    if(typeID >= 0)
+    {
+      return typeID;
+    }
+
+    // Shared is enough: the type is first needed inside read functions that only hold a
+    // shared lock. Two threads may race to build it; the loser closes its copy.
+    H5SUPPORT_MUTEX_LOCK_SHARED()
+
+    H5CompoundTypeBuilder<T> builder;
+    H5CompoundDescription<T>::describe(builder);
+    hid_t newTypeID = builder.release();
+    if(newTypeID < 0)
+    {
+      std::cout << "H5TypeTraits: Error creating the compound type for " << H5CompoundDescription<T>::name() << std::endl;
+      return newTypeID;
+    }
+    if(!s_TypeID.compare_exchange_strong(typeID, newTypeID, std::memory_order_acq_rel, std::memory_order_acquire))
+    {
+      H5Tclose(newTypeID);
+      return typeID;
+    }
+    return newTypeID;
+  }
+
+  static constexpr const char* name()
+  {
+    return H5CompoundDescription<T>::name();
+  }
+};
+
+#if defined(H5Support_NAMESPACE)
+#define H5SUPPORT_COMPOUND_SCOPE H5Support_NAMESPACE::
+#else
+#define H5SUPPORT_COMPOUND_SCOPE
+#endif
+
+/**
+ * @brief Registers a struct as an HDF5 compound type so every H5Lite function accepts it
+ * like a primitive, e.g. writeVectorDataset(fileID, "Grains", dims, grains). Use at global
+ * scope, before the first H5Lite call with the type:
+ * @code
+ * struct Grain
+ * {
+ *   int32_t id;
+ *   float position[3];
+ *   double phase;
+ * };
+ * H5SUPPORT_BEGIN_COMPOUND(Grain)
+ * H5SUPPORT_COMPOUND_MEMBER(id)
+ * H5SUPPORT_COMPOUND_MEMBER_NAMED(position, "Position")
+ * H5SUPPORT_COMPOUND_MEMBER(phase)
+ * H5SUPPORT_END_COMPOUND()
+ * @endcode
+ * Members are matched by name when reading, so a struct registered with a subset of the
+ * members of a file's compound type reads just those members.
+ */
+#define H5SUPPORT_BEGIN_COMPOUND(Type)                                                                                                                                                                 \
+  template <> struct H5SUPPORT_COMPOUND_SCOPE H5CompoundDescription<Type>                                                                                                                              \
+  {                                                                                                                                                                                                    \
+    using CompoundType = Type;                                                                                                                                                                         \
+    static constexpr bool k_Registered = true;                                                                                                                                                         \
+    static constexpr const char* name()                                                                                                                                                                \
+    {                                                                                                                                                                                                  \
+      return #Type;                                                                                                                                                                                    \
+    }                                                                                                                                                                                                  \
+    static void describe(H5SUPPORT_COMPOUND_SCOPE H5CompoundTypeBuilder<Type>& builder)                                                                                                                \
+    {
+
+#define H5SUPPORT_COMPOUND_MEMBER(member) builder.add<decltype(CompoundType::member)>(#member, offsetof(CompoundType, member));
+
+#define H5SUPPORT_COMPOUND_MEMBER_NAMED(member, memberName) builder.add<decltype(CompoundType::member)>(memberName, offsetof(CompoundType, member));
+
+#define H5SUPPORT_END_COMPOUND()                                                                                                                                                                       \
+  }                                                                                                                                                                                                    \
+  }                                                                                                                                                                                                    \
+  ;
+
+#if defined(H5Support_NAMESPACE)
+}
+#endif
@@ -0,0 +1,370 @@
+/* ============================================================================
+ * Copyright (c) 2007-2019 BlueQuartz Software, LLC
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+ * contributors may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The code contained herein was partially funded by the followig contracts:
+ *    United States Air Force Prime Contract FA8650-04-C-5229
+ *    United States Air Force Prime Contract FA8650-15-D-5231
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <numeric>
+#include <string>
+#include <vector>
+
+#include <hdf5.h>
+
+#include "H5Support/H5Lite.h"
+#include "H5Support/H5Support.h"
+
+#if defined(H5Support_NAMESPACE)
+namespace H5Support_NAMESPACE
+{
+#endif
+
+/**
+ * @brief The H5DatasetAppender class streams rows into a dataset whose first dimension
+ * grows without bound. The dataset is created chunked with H5S_UNLIMITED as its first
+ * maximum dimension; every row has the shape given by sliceDims (a scalar row if
+ * sliceDims is empty).
+ *
+ * Appended rows are collected in an internal buffer that holds exactly one chunk. When
+ * the buffer is full the dataset is extended with H5Dset_extent and the whole chunk is
+ * written, so memory use is bounded by the chunk size regardless of how large the
+ * dataset becomes. Appends that span whole chunks while the buffer is empty are written
+ * straight from the caller's memory. flush() writes a partially filled buffer; the
+ * destructor flushes and closes the dataset.
+ *
+ * The constructor never fails loudly: check isValid() before appending.
+ */
+template <typename T> class H5DatasetAppender
+{
+public:
+  /**
+   * @brief Creates the dataset
+   * @param locationID The hdf5 object id of the parent
+   * @param datasetName The name of the dataset to create
+   * @param sliceDims The dimensions of a single row. The dataset has rank sliceDims.size() + 1
+   * @param rowsPerChunk The number of rows per chunk and buffer. 0 picks a chunk close to H5Lite::k_ChunkMax bytes
+   */
+  H5DatasetAppender(hid_t locationID, const std::string& datasetName, const std::vector<hsize_t>& sliceDims, hsize_t rowsPerChunk = 0)
+  : m_DatasetName(datasetName)
+  , m_SliceDims(sliceDims)
+  {
+    m_RowElements = std::accumulate(m_SliceDims.cbegin(), m_SliceDims.cend(), static_cast<hsize_t>(1), std::multiplies<hsize_t>());
+    if(m_RowElements == 0)
+    {
+      std::cout << "H5DatasetAppender: Row dimensions of '" << datasetName << "' must not be zero" << std::endl;
+      return;
+    }
+    if(rowsPerChunk == 0)
+    {
+      rowsPerChunk = std::max(static_cast<hsize_t>(1), static_cast<hsize_t>(H5Lite::k_ChunkMax / (m_RowElements * sizeof(T))));
+    }
+    m_RowsPerChunk = rowsPerChunk;
+    m_DataType = H5TypeTraits<T>::type();
+    if(m_DataType < 0)
+    {
+      return;
+    }
+
+    H5SUPPORT_MUTEX_LOCK()
+
+    std::vector<hsize_t> dims = datasetDims(0);
+    std::vector<hsize_t> maxDims = dims;
+    maxDims[0] = H5S_UNLIMITED;
+    std::vector<hsize_t> chunkDims = datasetDims(m_RowsPerChunk);
+
+    hid_t dataspaceID = H5Screate_simple(static_cast<int>(dims.size()), dims.data(), maxDims.data());
+    hid_t propertyListID = H5Pcreate(H5P_DATASET_CREATE);
+    if(dataspaceID >= 0 && propertyListID >= 0 && H5Pset_chunk(propertyListID, static_cast<int>(chunkDims.size()), chunkDims.data()) >= 0)
+    {
+      m_DatasetID = H5Dcreate(locationID, datasetName.c_str(), m_DataType, dataspaceID, H5P_DEFAULT, propertyListID, H5P_DEFAULT);
+    }
+    if(m_DatasetID < 0)
+    {
+      std::cout << "H5DatasetAppender: Error creating dataset '" << datasetName << "'" << std::endl;
+    }
+    if(propertyListID >= 0)
+    {
+      H5Pclose(propertyListID);
+    }
+    if(dataspaceID >= 0)
+    {
+      H5Sclose(dataspaceID);
+    }
+  }
+
+  ~H5DatasetAppender()
+  {
+    close();
+  }
+
+  H5DatasetAppender(const H5DatasetAppender&) = delete;            // Copy Constructor Not Implemented
+  H5DatasetAppender(H5DatasetAppender&&) = delete;                 // Move Constructor Not Implemented
+  H5DatasetAppender& operator=(const H5DatasetAppender&) = delete; // Copy Assignment Not Implemented
+  H5DatasetAppender& operator=(H5DatasetAppender&&) = delete;      // Move Assignment Not Implemented
+
+  /**
+   * @brief Returns true if the dataset was created and has not been closed
+   * @return
+   */
+  bool isValid() const
+  {
+    return m_DatasetID >= 0;
+  }
+
+  /**
+   * @brief Appends numRows rows of getRowElementCount() elements each
+   * @param data Pointer to numRows * getRowElementCount() contiguous elements
+   * @param numRows
+   * @return Standard hdf5 error condition.
+   */
+  herr_t append(const T* data, hsize_t numRows)
+  {
+    if(!isValid())
+    {
+      return -1;
+    }
+    if(numRows == 0)
+    {
+      return 0;
+    }
+    if(nullptr == data)
+    {
+      return -2;
+    }
+    herr_t error = 0;
+    while(numRows > 0)
+    {
+      if(m_Buffer.empty() && numRows >= m_RowsPerChunk)
+      {
+        // Whole chunks go straight to the file without passing through the buffer
+        hsize_t directRows = numRows - numRows % m_RowsPerChunk;
+        error = writeRows(data, directRows);
+        if(error < 0)
+        {
+          return error;
+        }
+        data += directRows * m_RowElements;
+        numRows -= directRows;
+        continue;
+      }
+      hsize_t bufferedRows = m_Buffer.size() / m_RowElements;
+      hsize_t rowsToCopy = std::min(numRows, m_RowsPerChunk - bufferedRows);
+      if(m_Buffer.capacity() == 0)
+      {
+        m_Buffer.reserve(m_RowsPerChunk * m_RowElements);
+      }
+      m_Buffer.insert(m_Buffer.end(), data, data + rowsToCopy * m_RowElements);
+      data += rowsToCopy * m_RowElements;
+      numRows -= rowsToCopy;
+      if(m_Buffer.size() == m_RowsPerChunk * m_RowElements)
+      {
+        error = flush();
+        if(error < 0)
+        {
+          return error;
+        }
+      }
+    }
+    return error;
+  }
+
+  /**
+   * @brief Appends the rows held in a std::vector. The size of the vector must be a
+   * multiple of getRowElementCount().
+   * @param data
+   * @return Standard hdf5 error condition.
+   */
+  herr_t append(const std::vector<T>& data)
+  {
+    if(!isValid() || m_RowElements == 0)
+    {
+      return -1;
+    }
+    if(data.size() % m_RowElements != 0)
+    {
+      std::cout << "H5DatasetAppender: " << data.size() << " elements is not a whole number of rows of " << m_RowElements << " elements" << std::endl;
+      return -3;
+    }
+    return append(data.data(), data.size() / m_RowElements);
+  }
+
+  /**
+   * @brief Writes any buffered rows to the file. If the write fails the rows stay buffered,
+   * so a later flush() or close() tries them again.
+   * @return Standard hdf5 error condition.
+   */
+  herr_t flush()
+  {
+    if(!isValid())
+    {
+      return -1;
+    }
+    if(m_Buffer.empty())
+    {
+      return 0;
+    }
+    herr_t error = writeRows(m_Buffer.data(), m_Buffer.size() / m_RowElements);
+    if(error >= 0)
+    {
+      m_Buffer.clear();
+    }
+    return error;
+  }
+
+  /**
+   * @brief Flushes the buffered rows and closes the dataset
+   * @return Standard hdf5 error condition.
+   */
+  herr_t close()
+  {
+    if(!isValid())
+    {
+      return 0;
+    }
+    herr_t returnError = flush();
+    H5SUPPORT_MUTEX_LOCK()
+    herr_t error = H5Dclose(m_DatasetID);
+    if(error < 0)
+    {
+      std::cout << "H5DatasetAppender: Error Closing Dataset '" << m_DatasetName << "'" << std::endl;
+      returnError = error;
+    }
+    m_DatasetID = -1;
+    std::vector<T>().swap(m_Buffer);
+    return returnError;
+  }
+
+  /**
+   * @brief Returns the number of rows appended so far, including buffered ones
+   * @return
+   */
+  hsize_t getNumberOfRows() const
+  {
+    if(m_RowElements == 0)
+    {
+      return 0;
+    }
+    return m_WrittenRows + m_Buffer.size() / m_RowElements;
+  }
+
+  /**
+   * @brief Returns the number of rows that are currently written to the file
+   * @return
+   */
+  hsize_t getNumberOfWrittenRows() const
+  {
+    return m_WrittenRows;
+  }
+
+  /**
+   * @brief Returns the number of rows per chunk, which is also the buffer capacity
+   * @return
+   */
+  hsize_t getRowsPerChunk() const
+  {
+    return m_RowsPerChunk;
+  }
+
+  /**
+   * @brief Returns the number of elements in a single row
+   * @return
+   */
+  hsize_t getRowElementCount() const
+  {
+    return m_RowElements;
+  }
+
+private:
+  std::vector<hsize_t> datasetDims(hsize_t numRows) const
+  {
+    std::vector<hsize_t> dims(1, numRows);
+    dims.insert(dims.end(), m_SliceDims.cbegin(), m_SliceDims.cend());
+    return dims;
+  }
+
+  herr_t writeRows(const T* data, hsize_t numRows)
+  {
+    H5SUPPORT_MUTEX_LOCK()
+
+    std::vector<hsize_t> newDims = datasetDims(m_WrittenRows + numRows);
+    herr_t error = H5Dset_extent(m_DatasetID, newDims.data());
+    if(error < 0)
+    {
+      std::cout << "H5DatasetAppender: Error extending dataset '" << m_DatasetName << "'" << std::endl;
+      return error;
+    }
+    std::vector<hsize_t> offset(newDims.size(), 0);
+    offset[0] = m_WrittenRows;
+    std::vector<hsize_t> count = datasetDims(numRows);
+    hid_t fileSpaceID = H5Dget_space(m_DatasetID);
+    hid_t memSpaceID = H5Screate_simple(static_cast<int>(count.size()), count.data(), nullptr);
+    error = (fileSpaceID < 0 || memSpaceID < 0) ? -1 : H5Sselect_hyperslab(fileSpaceID, H5S_SELECT_SET, offset.data(), nullptr, count.data(), nullptr);
+    if(error >= 0)
+    {
+      error = H5Dwrite(m_DatasetID, m_DataType, memSpaceID, fileSpaceID, H5P_DEFAULT, data);
+      H5SUPPORT_INSTRUMENT_BYTES(error, numRows * m_RowElements * sizeof(T))
+    }
+    if(error < 0)
+    {
+      std::cout << "H5DatasetAppender: Error writing rows " << m_WrittenRows << " to " << (m_WrittenRows + numRows) << " of dataset '" << m_DatasetName << "'" << std::endl;
+    }
+    else
+    {
+      m_WrittenRows += numRows;
+    }
+    if(memSpaceID >= 0)
+    {
+      H5Sclose(memSpaceID);
+    }
+    if(fileSpaceID >= 0)
+    {
+      H5Sclose(fileSpaceID);
+    }
+    return error;
+  }
+
+  std::string m_DatasetName;
+  std::vector<hsize_t> m_SliceDims;
+  hsize_t m_RowElements = 0;
+  hsize_t m_RowsPerChunk = 0;
+  hsize_t m_WrittenRows = 0;
+  hid_t m_DataType = -1;
+  hid_t m_DatasetID = -1;
+  std::vector<T> m_Buffer;
+};
+
+#if defined(H5Support_NAMESPACE)
+}
+#endif
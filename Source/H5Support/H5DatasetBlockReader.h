@@ -0,0 +1,376 @@
+/* ============================================================================
+ * Copyright (c) 2007-2019 BlueQuartz Software, LLC
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+ * contributors may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The code contained herein was partially funded by the followig contracts:
+ *    United States Air Force Prime Contract FA8650-04-C-5229
+ *    United States Air Force Prime Contract FA8650-15-D-5231
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#pragma once
+
+#include <algorithm>
+#include <iostream>
+#include <numeric>
+#include <string>
+#include <vector>
+
+#include <hdf5.h>
+
+#include "H5Support/H5Lite.h"
+#include "H5Support/H5Support.h"
+
+#if defined(H5Support_NAMESPACE)
+namespace H5Support_NAMESPACE
+{
+#endif
+
+/**
+ * @brief The H5DatasetBlockReader class walks a dataset in blocks of whole rows along
+ * its first dimension, reusing a single buffer, so that reductions and conversions over
+ * datasets larger than RAM run with sequential I/O.
+ *
+ * When no block size is given a block holds as many rows as fit in k_DefaultBlockBytes,
+ * rounded down to a whole number of chunk rows when at least one chunk row fits so that
+ * every chunk is read exactly once. A block always holds at least one row, so a dataset
+ * whose rows are larger than k_DefaultBlockBytes reads one row per block and the buffer
+ * grows to that row size.
+ *
+ * Usage:
+ * <code>
+ * H5DatasetBlockReader<float> reader(fileID, "Volume");
+ * while(reader.next())
+ * {
+ *   process(reader.data(), reader.getBlockElementCount());
+ * }
+ * if(reader.getError() < 0) { ... }
+ * </code>
+ */
+template <typename T> class H5DatasetBlockReader
+{
+public:
+  static constexpr size_t k_DefaultBlockBytes = 16 * 1024 * 1024;
+
+  /**
+   * @brief Opens the dataset
+   * @param locationID The parent location that contains the dataset to read
+   * @param datasetName The name of the dataset to read
+   * @param rowsPerBlock The number of rows (indices along the first dimension) per block. 0 picks a size from k_DefaultBlockBytes
+   */
+  H5DatasetBlockReader(hid_t locationID, const std::string& datasetName, hsize_t rowsPerBlock = 0)
+  : m_DatasetName(datasetName)
+  {
+    m_DataType = H5TypeTraits<T>::type();
+    if(m_DataType < 0)
+    {
+      m_Error = -1;
+      return;
+    }
+
+    H5SUPPORT_MUTEX_LOCK_SHARED()
+
+    m_DatasetID = H5Dopen(locationID, datasetName.c_str(), H5P_DEFAULT);
+    if(m_DatasetID < 0)
+    {
+      std::cout << "H5DatasetBlockReader: Error opening Dataset at locationID (" << locationID << ") with object name (" << datasetName << ")" << std::endl;
+      m_Error = -1;
+      return;
+    }
+    hid_t dataspaceID = H5Dget_space(m_DatasetID);
+    int32_t rank = (dataspaceID < 0) ? -1 : H5Sget_simple_extent_ndims(dataspaceID);
+    if(rank >= 0)
+    {
+      m_Dims.resize(static_cast<size_t>(rank));
+      H5Sget_simple_extent_dims(dataspaceID, m_Dims.data(), nullptr);
+    }
+    if(dataspaceID >= 0)
+    {
+      H5Sclose(dataspaceID);
+    }
+    if(rank < 0)
+    {
+      std::cout << "H5DatasetBlockReader: Error getting the dataspace of '" << datasetName << "'" << std::endl;
+      close();
+      m_Error = -1;
+      return;
+    }
+
+    // A scalar dataset is read as a single row of one element
+    m_NumRows = m_Dims.empty() ? 1 : m_Dims[0];
+    m_RowElements = std::accumulate(m_Dims.cbegin() + (m_Dims.empty() ? 0 : 1), m_Dims.cend(), static_cast<hsize_t>(1), std::multiplies<hsize_t>());
+    m_RowsPerBlock = (rowsPerBlock > 0) ? rowsPerBlock : defaultRowsPerBlock();
+  }
+
+  ~H5DatasetBlockReader()
+  {
+    close();
+  }
+
+  H5DatasetBlockReader(const H5DatasetBlockReader&) = delete;            // Copy Constructor Not Implemented
+  H5DatasetBlockReader(H5DatasetBlockReader&&) = delete;                 // Move Constructor Not Implemented
+  H5DatasetBlockReader& operator=(const H5DatasetBlockReader&) = delete; // Copy Assignment Not Implemented
+  H5DatasetBlockReader& operator=(H5DatasetBlockReader&&) = delete;      // Move Assignment Not Implemented
+
+  /**
+   * @brief Returns true if the dataset is open
+   * @return
+   */
+  bool isValid() const
+  {
+    return m_DatasetID >= 0;
+  }
+
+  /**
+   * @brief Reads the next block into the internal buffer
+   * @return false once every block has been read or if an error occurred (see getError())
+   */
+  bool next()
+  {
+    if(!isValid() || m_Error < 0)
+    {
+      return false;
+    }
+    hsize_t rowOffset = m_BlockRowOffset + m_BlockRowCount;
+    if(rowOffset >= m_NumRows)
+    {
+      m_BlockRowOffset = m_NumRows;
+      m_BlockRowCount = 0;
+      return false;
+    }
+    hsize_t rowCount = std::min(m_RowsPerBlock, m_NumRows - rowOffset);
+    m_Error = readRows(rowOffset, rowCount);
+    if(m_Error < 0)
+    {
+      m_BlockRowCount = 0;
+      return false;
+    }
+    m_BlockRowOffset = rowOffset;
+    m_BlockRowCount = rowCount;
+    return true;
+  }
+
+  /**
+   * @brief Starts the iteration over from the first block
+   */
+  void rewind()
+  {
+    m_BlockRowOffset = 0;
+    m_BlockRowCount = 0;
+  }
+
+  /**
+   * @brief Calls visitor(const T* data, hsize_t rowOffset, hsize_t rowCount) for every
+   * remaining block. A negative return value from the visitor stops the walk and is
+   * returned.
+   * @param visitor
+   * @return Standard hdf5 error condition.
+   */
+  template <typename Visitor> herr_t visit(Visitor&& visitor)
+  {
+    while(next())
+    {
+      herr_t error = visitor(static_cast<const T*>(m_Buffer.data()), m_BlockRowOffset, m_BlockRowCount);
+      if(error < 0)
+      {
+        return error;
+      }
+    }
+    return m_Error;
+  }
+
+  /**
+   * @brief Closes the dataset and releases the buffer
+   */
+  void close()
+  {
+    if(m_DatasetID >= 0)
+    {
+      H5SUPPORT_MUTEX_LOCK_SHARED()
+      H5Dclose(m_DatasetID);
+      m_DatasetID = -1;
+    }
+    std::vector<T>().swap(m_Buffer);
+  }
+
+  /**
+   * @brief Returns the data of the current block
+   * @return
+   */
+  const T* data() const
+  {
+    return m_Buffer.data();
+  }
+
+  /**
+   * @brief Returns the dimensions of the whole dataset
+   * @return
+   */
+  const std::vector<hsize_t>& getDimensions() const
+  {
+    return m_Dims;
+  }
+
+  /**
+   * @brief Returns the index of the first row of the current block
+   * @return
+   */
+  hsize_t getBlockRowOffset() const
+  {
+    return m_BlockRowOffset;
+  }
+
+  /**
+   * @brief Returns the number of rows in the current block
+   * @return
+   */
+  hsize_t getBlockRowCount() const
+  {
+    return m_BlockRowCount;
+  }
+
+  /**
+   * @brief Returns the number of elements in the current block
+   * @return
+   */
+  hsize_t getBlockElementCount() const
+  {
+    return m_BlockRowCount * m_RowElements;
+  }
+
+  /**
+   * @brief Returns the number of rows read per block. The last block may be shorter.
+   * @return
+   */
+  hsize_t getRowsPerBlock() const
+  {
+    return m_RowsPerBlock;
+  }
+
+  /**
+   * @brief Returns the number of elements in a single row
+   * @return
+   */
+  hsize_t getRowElementCount() const
+  {
+    return m_RowElements;
+  }
+
+  /**
+   * @brief Returns the first error that occurred or 0
+   * @return
+   */
+  herr_t getError() const
+  {
+    return m_Error;
+  }
+
+private:
+  hsize_t defaultRowsPerBlock() const
+  {
+    hsize_t rowBytes = std::max(static_cast<hsize_t>(1), m_RowElements * sizeof(T));
+    hsize_t rows = std::max(static_cast<hsize_t>(1), static_cast<hsize_t>(k_DefaultBlockBytes) / rowBytes);
+
+    hid_t propertyListID = H5Dget_create_plist(m_DatasetID);
+    if(propertyListID >= 0)
+    {
+      if(H5Pget_layout(propertyListID) == H5D_CHUNKED && !m_Dims.empty())
+      {
+        std::vector<hsize_t> chunkDims(m_Dims.size(), 0);
+        if(H5Pget_chunk(propertyListID, static_cast<int>(chunkDims.size()), chunkDims.data()) >= 0 && chunkDims[0] > 0)
+        {
+          // Round down to a whole number of chunk rows so every chunk is decoded exactly
+          // once, but never grow the block past k_DefaultBlockBytes to reach a chunk row
+          if(rows >= chunkDims[0])
+          {
+            rows -= rows % chunkDims[0];
+          }
+        }
+      }
+      H5Pclose(propertyListID);
+    }
+    return std::min(rows, std::max(static_cast<hsize_t>(1), m_NumRows));
+  }
+
+  herr_t readRows(hsize_t rowOffset, hsize_t rowCount)
+  {
+    if(m_Buffer.empty())
+    {
+      m_Buffer.resize(std::min(m_RowsPerBlock, m_NumRows) * m_RowElements);
+    }
+
+    H5SUPPORT_MUTEX_LOCK_SHARED()
+
+    if(m_Dims.empty())
+    {
+      herr_t error = H5Dread(m_DatasetID, m_DataType, H5S_ALL, H5S_ALL, H5P_DEFAULT, m_Buffer.data());
+      H5SUPPORT_INSTRUMENT_BYTES(error, sizeof(T))
+      return error;
+    }
+    std::vector<hsize_t> offset(m_Dims.size(), 0);
+    offset[0] = rowOffset;
+    std::vector<hsize_t> count = m_Dims;
+    count[0] = rowCount;
+    hid_t fileSpaceID = H5Dget_space(m_DatasetID);
+    hid_t memSpaceID = H5Screate_simple(static_cast<int>(count.size()), count.data(), nullptr);
+    herr_t error = (fileSpaceID < 0 || memSpaceID < 0) ? -1 : H5Sselect_hyperslab(fileSpaceID, H5S_SELECT_SET, offset.data(), nullptr, count.data(), nullptr);
+    if(error >= 0)
+    {
+      error = H5Dread(m_DatasetID, m_DataType, memSpaceID, fileSpaceID, H5P_DEFAULT, m_Buffer.data());
+      H5SUPPORT_INSTRUMENT_BYTES(error, rowCount * m_RowElements * sizeof(T))
+    }
+    if(error < 0)
+    {
+      std::cout << "H5DatasetBlockReader: Error reading rows " << rowOffset << " to " << (rowOffset + rowCount) << " of dataset '" << m_DatasetName << "'" << std::endl;
+    }
+    if(memSpaceID >= 0)
+    {
+      H5Sclose(memSpaceID);
+    }
+    if(fileSpaceID >= 0)
+    {
+      H5Sclose(fileSpaceID);
+    }
+    return error;
+  }
+
+  std::string m_DatasetName;
+  std::vector<hsize_t> m_Dims;
+  hsize_t m_NumRows = 0;
+  hsize_t m_RowElements = 0;
+  hsize_t m_RowsPerBlock = 0;
+  hsize_t m_BlockRowOffset = 0;
+  hsize_t m_BlockRowCount = 0;
+  hid_t m_DataType = -1;
+  hid_t m_DatasetID = -1;
+  herr_t m_Error = 0;
+  std::vector<T> m_Buffer;
+};
+
+#if defined(H5Support_NAMESPACE)
+}
+#endif
@@ -0,0 +1,505 @@
+/* ============================================================================
+ * Copyright (c) 2007-2019 BlueQuartz Software, LLC
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+ * contributors may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The code contained herein was partially funded by the followig contracts:
+ *    United States Air Force Prime Contract FA8650-04-C-5229
+ *    United States Air Force Prime Contract FA8650-15-D-5231
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#pragma once
+
+#include <functional>
+#include <iostream>
+#include <numeric>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <hdf5.h>
+
+#include "H5Support/H5Lite.h"
+#include "H5Support/H5Support.h"
+
+#if defined(H5Support_NAMESPACE)
+namespace H5Support_NAMESPACE
+{
+#endif
+
+/**
+ * @brief The H5DatasetHandle class keeps a dataset open so several operations on it do
+ * not each resolve the path with H5Dopen again. The dimensions, type, layout, chunk
+ * dimensions and filter pipeline are queried once when the handle is opened (and again
+ * by refresh()).
+ *
+ * The handle is move only; the dataset is closed when the owning handle is destroyed.
+ * An invalid handle is returned when the dataset can not be opened, check isValid().
+ */
+class H5DatasetHandle
+{
+public:
+  H5DatasetHandle() = default;
+
+  ~H5DatasetHandle()
+  {
+    close();
+  }
+
+  H5DatasetHandle(const H5DatasetHandle&) = delete;            // Copy Constructor Not Implemented
+  H5DatasetHandle& operator=(const H5DatasetHandle&) = delete; // Copy Assignment Not Implemented
+
+  H5DatasetHandle(H5DatasetHandle&& other) noexcept
+  {
+    swap(other);
+  }
+
+  H5DatasetHandle& operator=(H5DatasetHandle&& other) noexcept
+  {
+    if(this != &other)
+    {
+      close();
+      swap(other);
+    }
+    return *this;
+  }
+
+  /**
+   * @brief Opens an existing dataset and caches its metadata
+   * @param locationID The parent location that contains the dataset
+   * @param datasetName The name of the dataset
+   * @return The handle. isValid() is false if the dataset could not be opened
+   */
+  static H5DatasetHandle open(hid_t locationID, const std::string& datasetName)
+  {
+    H5SUPPORT_MUTEX_LOCK_SHARED()
+
+    H5DatasetHandle handle;
+    handle.m_Name = datasetName;
+    handle.m_DatasetID = H5Dopen(locationID, datasetName.c_str(), H5P_DEFAULT);
+    if(handle.m_DatasetID < 0)
+    {
+      std::cout << "H5DatasetHandle::open(" << __LINE__ << ") Error opening Dataset at locationID (" << locationID << ") with object name (" << datasetName << ")" << std::endl;
+      return handle;
+    }
+    if(handle.refresh() < 0)
+    {
+      handle.close();
+    }
+    return handle;
+  }
+
+  /**
+   * @brief Queries the metadata of the open dataset again, e.g. after H5Dset_extent
+   * @return Standard hdf5 error condition.
+   */
+  herr_t refresh()
+  {
+    if(!isValid())
+    {
+      return -1;
+    }
+
+    H5SUPPORT_MUTEX_LOCK_SHARED()
+
+    herr_t returnError = 0;
+    hid_t dataspaceID = H5Dget_space(m_DatasetID);
+    int32_t rank = (dataspaceID < 0) ? -1 : H5Sget_simple_extent_ndims(dataspaceID);
+    if(rank >= 0)
+    {
+      m_Dims.assign(static_cast<size_t>(rank), 0);
+      H5Sget_simple_extent_dims(dataspaceID, m_Dims.data(), nullptr);
+    }
+    else
+    {
+      std::cout << "H5DatasetHandle::refresh(" << __LINE__ << ") Error getting the dataspace of '" << m_Name << "'" << std::endl;
+      returnError = -1;
+    }
+    if(dataspaceID >= 0)
+    {
+      H5Sclose(dataspaceID);
+    }
+
+    hid_t typeID = H5Dget_type(m_DatasetID);
+    if(typeID >= 0)
+    {
+      m_ClassType = H5Tget_class(typeID);
+      m_TypeSize = H5Tget_size(typeID);
+      H5Tclose(typeID);
+    }
+    else
+    {
+      std::cout << "H5DatasetHandle::refresh(" << __LINE__ << ") Error getting the type of '" << m_Name << "'" << std::endl;
+      returnError = -1;
+    }
+
+    m_ChunkDims.clear();
+    m_Filters.clear();
+    hid_t propertyListID = H5Dget_create_plist(m_DatasetID);
+    if(propertyListID >= 0)
+    {
+      m_Layout = H5Pget_layout(propertyListID);
+      if(m_Layout == H5D_CHUNKED && rank > 0)
+      {
+        m_ChunkDims.assign(static_cast<size_t>(rank), 0);
+        H5Pget_chunk(propertyListID, rank, m_ChunkDims.data());
+      }
+      int numFilters = H5Pget_nfilters(propertyListID);
+      for(int i = 0; i < numFilters; ++i)
+      {
+        unsigned flags = 0;
+        size_t numValues = 0;
+        m_Filters.push_back(H5Pget_filter2(propertyListID, static_cast<unsigned>(i), &flags, &numValues, nullptr, 0, nullptr, nullptr));
+      }
+      H5Pclose(propertyListID);
+    }
+    else
+    {
+      std::cout << "H5DatasetHandle::refresh(" << __LINE__ << ") Error getting the creation properties of '" << m_Name << "'" << std::endl;
+      returnError = -1;
+    }
+    return returnError;
+  }
+
+  /**
+   * @brief Closes the dataset. Safe to call more than once.
+   * @return Standard hdf5 error condition.
+   */
+  herr_t close()
+  {
+    if(m_DatasetID < 0)
+    {
+      return 0;
+    }
+
+    // Closing only releases the id, and handles are closed inside read only scopes such as open()
+    H5SUPPORT_MUTEX_LOCK_SHARED()
+
+    herr_t error = H5Dclose(m_DatasetID);
+    if(error < 0)
+    {
+      std::cout << "Error Closing Dataset '" << m_Name << "'" << std::endl;
+    }
+    m_DatasetID = -1;
+    return error;
+  }
+
+  bool isValid() const
+  {
+    return m_DatasetID >= 0;
+  }
+
+  hid_t getId() const
+  {
+    return m_DatasetID;
+  }
+
+  const std::string& getName() const
+  {
+    return m_Name;
+  }
+
+  const std::vector<hsize_t>& getDimensions() const
+  {
+    return m_Dims;
+  }
+
+  /**
+   * @brief Returns the number of elements in the dataset
+   * @return
+   */
+  hsize_t getNumberOfElements() const
+  {
+    return std::accumulate(m_Dims.cbegin(), m_Dims.cend(), static_cast<hsize_t>(1), std::multiplies<hsize_t>());
+  }
+
+  H5T_class_t getClassType() const
+  {
+    return m_ClassType;
+  }
+
+  size_t getTypeSize() const
+  {
+    return m_TypeSize;
+  }
+
+  H5D_layout_t getLayout() const
+  {
+    return m_Layout;
+  }
+
+  /**
+   * @brief Returns the chunk dimensions. Empty unless the layout is H5D_CHUNKED.
+   * @return
+   */
+  const std::vector<hsize_t>& getChunkDimensions() const
+  {
+    return m_ChunkDims;
+  }
+
+  /**
+   * @brief Returns the filter identifiers of the filter pipeline in order
+   * @return
+   */
+  const std::vector<H5Z_filter_t>& getFilters() const
+  {
+    return m_Filters;
+  }
+
+  /**
+   * @brief Reads the whole dataset into a pre-allocated pointer
+   * @param data Room for getNumberOfElements() elements
+   * @return Standard hdf5 error condition.
+   */
+  template <typename T> herr_t read(T* data) const
+  {
+    hid_t dataType = H5TypeTraits<T>::type();
+    if(!isValid() || dataType < 0 || nullptr == data)
+    {
+      return -1;
+    }
+
+    H5SUPPORT_MUTEX_LOCK_SHARED()
+
+    herr_t error = H5Dread(m_DatasetID, dataType, H5S_ALL, H5S_ALL, H5P_DEFAULT, data);
+    H5SUPPORT_INSTRUMENT_BYTES(error, getNumberOfElements() * sizeof(T))
+    if(error < 0)
+    {
+      std::cout << "Error Reading Data.'" << m_Name << "'" << std::endl;
+    }
+    return error;
+  }
+
+  /**
+   * @brief Reads the whole dataset into a std::vector, which WILL be resized
+   * @param data
+   * @return Standard hdf5 error condition.
+   */
+  template <typename T, typename Allocator> herr_t read(std::vector<T, Allocator>& data) const
+  {
+    if(!isValid())
+    {
+      return -1;
+    }
+    data.resize(getNumberOfElements());
+    return read(data.data());
+  }
+
+  /**
+   * @brief Reads a hyperslab into a pre-allocated pointer, see H5Lite::readPointerDatasetSlab()
+   * @return Standard hdf5 error condition.
+   */
+  template <typename T> herr_t readSlab(int32_t rank, const hsize_t* offset, const hsize_t* count, const hsize_t* stride, const hsize_t* block, T* data) const
+  {
+    return readSlabImpl(rank, offset, count, stride, block, H5TypeTraits<T>::type(), data);
+  }
+
+  /**
+   * @brief Reads a hyperslab into a std::vector, see H5Lite::readVectorDatasetSlab(). The
+   * vector WILL be resized to prod(count[i] * block[i]) elements.
+   * @return Standard hdf5 error condition.
+   */
+  template <typename T, typename Allocator>
+  herr_t readSlab(const std::vector<hsize_t>& offset, const std::vector<hsize_t>& count, std::vector<T, Allocator>& data, const std::vector<hsize_t>& stride = {},
+                  const std::vector<hsize_t>& block = {}) const
+  {
+    hsize_t numElements = slabElementCount(offset, count, stride, block);
+    if(numElements == 0)
+    {
+      return -3;
+    }
+    data.resize(numElements);
+    return readSlab(static_cast<int32_t>(offset.size()), offset.data(), count.data(), stride.empty() ? nullptr : stride.data(), block.empty() ? nullptr : block.data(), data.data());
+  }
+
+  /**
+   * @brief Overwrites the whole dataset
+   * @param data getNumberOfElements() elements
+   * @return Standard hdf5 error condition.
+   */
+  template <typename T> herr_t write(const T* data)
+  {
+    hid_t dataType = H5TypeTraits<T>::type();
+    if(!isValid() || dataType < 0 || nullptr == data)
+    {
+      return -1;
+    }
+
+    H5SUPPORT_MUTEX_LOCK()
+
+    herr_t error = H5Dwrite(m_DatasetID, dataType, H5S_ALL, H5S_ALL, H5P_DEFAULT, data);
+    H5SUPPORT_INSTRUMENT_BYTES(error, getNumberOfElements() * sizeof(T))
+    if(error < 0)
+    {
+      std::cout << "Error Writing Data '" << m_Name << "'" << std::endl;
+    }
+    return error;
+  }
+
+  /**
+   * @brief Overwrites the whole dataset from a std::vector holding getNumberOfElements() elements
+   * @param data
+   * @return Standard hdf5 error condition.
+   */
+  template <typename T, typename Allocator> herr_t write(const std::vector<T, Allocator>& data)
+  {
+    if(data.size() != getNumberOfElements())
+    {
+      std::cout << "H5DatasetHandle::write(" << __LINE__ << ") '" << m_Name << "' holds " << getNumberOfElements() << " elements but the vector holds " << data.size() << std::endl;
+      return -3;
+    }
+    return write(data.data());
+  }
+
+  /**
+   * @brief Writes a hyperslab from a pointer, see H5Lite::writePointerDatasetSlab()
+   * @return Standard hdf5 error condition.
+   */
+  template <typename T> herr_t writeSlab(int32_t rank, const hsize_t* offset, const hsize_t* count, const hsize_t* stride, const hsize_t* block, const T* data)
+  {
+    return writeSlabImpl(rank, offset, count, stride, block, H5TypeTraits<T>::type(), data);
+  }
+
+  /**
+   * @brief Writes a hyperslab from a std::vector, see H5Lite::writeVectorDatasetSlab()
+   * @return Standard hdf5 error condition.
+   */
+  template <typename T, typename Allocator>
+  herr_t writeSlab(const std::vector<hsize_t>& offset, const std::vector<hsize_t>& count, const std::vector<T, Allocator>& data, const std::vector<hsize_t>& stride = {},
+                   const std::vector<hsize_t>& block = {})
+  {
+    hsize_t numElements = slabElementCount(offset, count, stride, block);
+    if(numElements == 0 || numElements != data.size())
+    {
+      std::cout << "H5DatasetHandle::writeSlab(" << __LINE__ << ") The slab holds " << numElements << " elements but the vector holds " << data.size() << std::endl;
+      return -3;
+    }
+    return writeSlab(static_cast<int32_t>(offset.size()), offset.data(), count.data(), stride.empty() ? nullptr : stride.data(), block.empty() ? nullptr : block.data(), data.data());
+  }
+
+private:
+  void swap(H5DatasetHandle& other) noexcept
+  {
+    std::swap(m_DatasetID, other.m_DatasetID);
+    std::swap(m_Name, other.m_Name);
+    std::swap(m_Dims, other.m_Dims);
+    std::swap(m_ClassType, other.m_ClassType);
+    std::swap(m_TypeSize, other.m_TypeSize);
+    std::swap(m_Layout, other.m_Layout);
+    std::swap(m_ChunkDims, other.m_ChunkDims);
+    std::swap(m_Filters, other.m_Filters);
+  }
+
+  /**
+   * @brief Returns prod(count[i] * block[i]) or 0 if the vector sizes do not match
+   */
+  static hsize_t slabElementCount(const std::vector<hsize_t>& offset, const std::vector<hsize_t>& count, const std::vector<hsize_t>& stride, const std::vector<hsize_t>& block)
+  {
+    if(count.size() != offset.size() || (!stride.empty() && stride.size() != offset.size()) || (!block.empty() && block.size() != offset.size()))
+    {
+      std::cout << "H5DatasetHandle: offset, count, stride and block must have the same size" << std::endl;
+      return 0;
+    }
+    hsize_t numElements = std::accumulate(count.cbegin(), count.cend(), static_cast<hsize_t>(1), std::multiplies<hsize_t>());
+    return std::accumulate(block.cbegin(), block.cend(), numElements, std::multiplies<hsize_t>());
+  }
+
+  /**
+   * @brief Reads a hyperslab into data under the shared lock
+   */
+  herr_t readSlabImpl(int32_t rank, const hsize_t* offset, const hsize_t* count, const hsize_t* stride, const hsize_t* block, hid_t dataType, void* data) const
+  {
+    if(!isValid() || dataType < 0 || nullptr == data)
+    {
+      return -1;
+    }
+
+    H5SUPPORT_MUTEX_LOCK_SHARED()
+
+    hid_t fileSpaceID = -1;
+    hid_t memSpaceID = -1;
+    herr_t error = H5Lite::selectDatasetSlab(m_DatasetID, rank, offset, count, stride, block, fileSpaceID, memSpaceID);
+    if(error < 0)
+    {
+      return error;
+    }
+    error = H5Dread(m_DatasetID, dataType, memSpaceID, fileSpaceID, H5P_DEFAULT, data);
+    H5SUPPORT_INSTRUMENT_BYTES(error, H5Instrumentation::dataspaceBytes(memSpaceID, dataType))
+    return closeSlab(error, fileSpaceID, memSpaceID, "Reading");
+  }
+
+  /**
+   * @brief Writes a hyperslab from data under the exclusive lock
+   */
+  herr_t writeSlabImpl(int32_t rank, const hsize_t* offset, const hsize_t* count, const hsize_t* stride, const hsize_t* block, hid_t dataType, const void* data)
+  {
+    if(!isValid() || dataType < 0 || nullptr == data)
+    {
+      return -1;
+    }
+
+    H5SUPPORT_MUTEX_LOCK()
+
+    hid_t fileSpaceID = -1;
+    hid_t memSpaceID = -1;
+    herr_t error = H5Lite::selectDatasetSlab(m_DatasetID, rank, offset, count, stride, block, fileSpaceID, memSpaceID);
+    if(error < 0)
+    {
+      return error;
+    }
+    error = H5Dwrite(m_DatasetID, dataType, memSpaceID, fileSpaceID, H5P_DEFAULT, data);
+    H5SUPPORT_INSTRUMENT_BYTES(error, H5Instrumentation::dataspaceBytes(memSpaceID, dataType))
+    return closeSlab(error, fileSpaceID, memSpaceID, "Writing");
+  }
+
+  /**
+   * @brief Reports a failed slab transfer and closes its dataspaces
+   */
+  herr_t closeSlab(herr_t error, hid_t fileSpaceID, hid_t memSpaceID, const char* action) const
+  {
+    if(error < 0)
+    {
+      std::cout << "Error " << action << " Slab of '" << m_Name << "'" << std::endl;
+    }
+    H5Sclose(memSpaceID);
+    H5Sclose(fileSpaceID);
+    return error;
+  }
+
+  hid_t m_DatasetID = -1;
+  std::string m_Name;
+  std::vector<hsize_t> m_Dims;
+  H5T_class_t m_ClassType = H5T_NO_CLASS;
+  size_t m_TypeSize = 0;
+  H5D_layout_t m_Layout = H5D_LAYOUT_ERROR;
+  std::vector<hsize_t> m_ChunkDims;
+  std::vector<H5Z_filter_t> m_Filters;
+};
+
+#if defined(H5Support_NAMESPACE)
+}
+#endif
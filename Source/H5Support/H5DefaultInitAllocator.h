@@ -0,0 +1,94 @@
+/* ============================================================================
+ * Copyright (c) 2007-2019 BlueQuartz Software, LLC
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+ * contributors may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The code contained herein was partially funded by the followig contracts:
+ *    United States Air Force Prime Contract FA8650-04-C-5229
+ *    United States Air Force Prime Contract FA8650-15-D-5231
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#pragma once
+
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if defined(H5Support_NAMESPACE)
+namespace H5Support_NAMESPACE
+{
+#endif
+
+/**
+ * @brief The DefaultInitAllocator class is an allocator adaptor that default-initializes
+ * instead of value-initializing elements. std::vector::resize() with this allocator leaves
+ * trivial types such as float or int32_t uninitialized, so a large buffer that H5Dread is
+ * about to overwrite is not zero filled first and every page is only written once.
+ * Every other construct() call is forwarded to the wrapped allocator.
+ */
+template <typename T, typename Base = std::allocator<T>> class DefaultInitAllocator : public Base
+{
+  using BaseTraits = std::allocator_traits<Base>;
+
+public:
+  template <typename U> struct rebind
+  {
+    using other = DefaultInitAllocator<U, typename BaseTraits::template rebind_alloc<U>>;
+  };
+
+  using Base::Base;
+
+  DefaultInitAllocator() = default;
+
+  template <typename U, typename OtherBase>
+  DefaultInitAllocator(const DefaultInitAllocator<U, OtherBase>& other) noexcept
+  : Base(static_cast<const OtherBase&>(other))
+  {
+  }
+
+  template <typename U> void construct(U* pointer) noexcept(std::is_nothrow_default_constructible<U>::value)
+  {
+    ::new(static_cast<void*>(pointer)) U;
+  }
+
+  template <typename U, typename... Args> void construct(U* pointer, Args&&... args)
+  {
+    BaseTraits::construct(static_cast<Base&>(*this), pointer, std::forward<Args>(args)...);
+  }
+};
+
+/**
+ * @brief A std::vector whose resize() does not zero fill trivial element types. It can be
+ * passed to every H5Lite::read*Vector* function.
+ */
+template <typename T> using UninitializedVector = std::vector<T, DefaultInitAllocator<T>>;
+
+#if defined(H5Support_NAMESPACE)
+}
+#endif
@@ -0,0 +1,348 @@
+/* ============================================================================
+ * Copyright (c) 2007-2019 BlueQuartz Software, LLC
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+ * contributors may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The code contained herein was partially funded by the followig contracts:
+ *    United States Air Force Prime Contract FA8650-04-C-5229
+ *    United States Air Force Prime Contract FA8650-15-D-5231
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <hdf5.h>
+
+#if defined(H5Support_NAMESPACE)
+namespace H5Support_NAMESPACE
+{
+#endif
+
+/**
+ * @brief The H5FunctionCounters struct holds the running totals for a single instrumented
+ * function. Instances are owned by H5Instrumentation and are never moved or destroyed so
+ * call sites can cache a reference to them.
+ */
+struct H5FunctionCounters
+{
+  std::atomic<uint64_t> calls{0};
+  std::atomic<uint64_t> bytes{0};
+  std::atomic<uint64_t> wallTimeNs{0};
+  std::atomic<uint64_t> lockWaitNs{0};
+};
+
+/**
+ * @brief The H5FunctionStats struct is a plain copy of H5FunctionCounters taken by
+ * H5Instrumentation::snapshot()
+ */
+struct H5FunctionStats
+{
+  std::string name;
+  uint64_t calls = 0;
+  uint64_t bytes = 0;
+  uint64_t wallTimeNs = 0;
+  uint64_t lockWaitNs = 0;
+};
+
+/**
+ * @brief The H5Instrumentation class is the process wide registry of per function
+ * statistics. It is only fed by the H5Lite/H5Utilities entry points when the library is
+ * compiled with H5Support_ENABLE_INSTRUMENTATION. Wall times are inclusive, so a function
+ * that calls other instrumented functions also accounts for the time spent in them.
+ */
+class H5Instrumentation
+{
+public:
+  ~H5Instrumentation() = default;
+
+  H5Instrumentation(const H5Instrumentation&) = delete;            // Copy Constructor Not Implemented
+  H5Instrumentation(H5Instrumentation&&) = delete;                 // Move Constructor Not Implemented
+  H5Instrumentation& operator=(const H5Instrumentation&) = delete; // Copy Assignment Not Implemented
+  H5Instrumentation& operator=(H5Instrumentation&&) = delete;      // Move Assignment Not Implemented
+
+  /**
+   * @brief Returns the process wide instance
+   * @return
+   */
+  static H5Instrumentation& instance()
+  {
+    static H5Instrumentation s_Instance;
+    return s_Instance;
+  }
+
+  /**
+   * @brief Returns the counters for the given function name, creating them on first use.
+   * The returned reference stays valid for the lifetime of the process.
+   * @param functionName
+   * @return
+   */
+  H5FunctionCounters& counters(const std::string& functionName)
+  {
+    std::lock_guard<std::mutex> guard(m_Mutex);
+    std::unique_ptr<H5FunctionCounters>& entry = m_Counters[functionName];
+    if(entry == nullptr)
+    {
+      entry.reset(new H5FunctionCounters());
+    }
+    return *entry;
+  }
+
+  /**
+   * @brief Returns a copy of the statistics of every function that has been called at
+   * least once, sorted by name
+   * @return
+   */
+  std::vector<H5FunctionStats> snapshot() const
+  {
+    std::vector<H5FunctionStats> stats;
+    std::lock_guard<std::mutex> guard(m_Mutex);
+    for(const auto& entry : m_Counters)
+    {
+      H5FunctionStats current;
+      current.name = entry.first;
+      current.calls = entry.second->calls.load(std::memory_order_relaxed);
+      if(current.calls == 0)
+      {
+        continue;
+      }
+      current.bytes = entry.second->bytes.load(std::memory_order_relaxed);
+      current.wallTimeNs = entry.second->wallTimeNs.load(std::memory_order_relaxed);
+      current.lockWaitNs = entry.second->lockWaitNs.load(std::memory_order_relaxed);
+      stats.push_back(current);
+    }
+    return stats;
+  }
+
+  /**
+   * @brief Sets every counter back to zero. Calls that are in flight while this runs may
+   * be attributed to either side of the reset.
+   */
+  void reset()
+  {
+    std::lock_guard<std::mutex> guard(m_Mutex);
+    for(auto& entry : m_Counters)
+    {
+      entry.second->calls = 0;
+      entry.second->bytes = 0;
+      entry.second->wallTimeNs = 0;
+      entry.second->lockWaitNs = 0;
+    }
+  }
+
+  /**
+   * @brief Writes the current snapshot as a JSON document to the given stream
+   * @param out
+   */
+  void writeJson(std::ostream& out) const
+  {
+    std::vector<H5FunctionStats> stats = snapshot();
+    out << "{\n  \"functions\": [";
+    for(size_t i = 0; i < stats.size(); ++i)
+    {
+      const H5FunctionStats& current = stats[i];
+      out << (i == 0 ? "\n" : ",\n");
+      out << "    {\"name\": \"" << escapeJson(current.name) << "\", \"calls\": " << current.calls << ", \"bytes\": " << current.bytes << ", \"wall_time_ns\": " << current.wallTimeNs
+          << ", \"lock_wait_ns\": " << current.lockWaitNs << "}";
+    }
+    out << (stats.empty() ? "]\n}\n" : "\n  ]\n}\n");
+  }
+
+  /**
+   * @brief Returns the current snapshot as a JSON document
+   * @return
+   */
+  std::string toJson() const
+  {
+    std::stringstream ss;
+    writeJson(ss);
+    return ss.str();
+  }
+
+  /**
+   * @brief Writes the current snapshot as a JSON document to the given file
+   * @param filePath
+   * @return Negative value on error
+   */
+  herr_t writeJson(const std::string& filePath) const
+  {
+    std::ofstream out(filePath, std::ios::out | std::ios::trunc);
+    if(!out.is_open())
+    {
+      return -1;
+    }
+    writeJson(out);
+    return out.good() ? 0 : -1;
+  }
+
+  /**
+   * @brief Returns the number of bytes described by the selection of a dataspace for the
+   * given memory type
+   * @param dataspaceID
+   * @param typeID
+   * @return
+   */
+  static uint64_t dataspaceBytes(hid_t dataspaceID, hid_t typeID)
+  {
+    hssize_t numElements = H5Sget_select_npoints(dataspaceID);
+    size_t typeSize = H5Tget_size(typeID);
+    if(numElements < 0)
+    {
+      return 0;
+    }
+    return static_cast<uint64_t>(numElements) * typeSize;
+  }
+
+  /**
+   * @brief Returns the number of bytes a full read/write of a dataset moves for the given
+   * memory type
+   * @param datasetID
+   * @param typeID
+   * @return
+   */
+  static uint64_t datasetBytes(hid_t datasetID, hid_t typeID)
+  {
+    hid_t dataspaceID = H5Dget_space(datasetID);
+    if(dataspaceID < 0)
+    {
+      return 0;
+    }
+    uint64_t numBytes = dataspaceBytes(dataspaceID, typeID);
+    H5Sclose(dataspaceID);
+    return numBytes;
+  }
+
+  /**
+   * @brief Returns the number of bytes a full read/write of an attribute moves for the
+   * given memory type
+   * @param attributeID
+   * @param typeID
+   * @return
+   */
+  static uint64_t attributeBytes(hid_t attributeID, hid_t typeID)
+  {
+    hid_t dataspaceID = H5Aget_space(attributeID);
+    if(dataspaceID < 0)
+    {
+      return 0;
+    }
+    uint64_t numBytes = dataspaceBytes(dataspaceID, typeID);
+    H5Sclose(dataspaceID);
+    return numBytes;
+  }
+
+protected:
+  H5Instrumentation() = default;
+
+private:
+  static std::string escapeJson(const std::string& value)
+  {
+    std::string escaped;
+    escaped.reserve(value.size());
+    for(char c : value)
+    {
+      if(c == '"' || c == '\\')
+      {
+        escaped.push_back('\\');
+      }
+      escaped.push_back(c);
+    }
+    return escaped;
+  }
+
+  mutable std::mutex m_Mutex;
+  std::map<std::string, std::unique_ptr<H5FunctionCounters>> m_Counters;
+};
+
+/**
+ * @brief The H5ScopedInstrumentation class records one call of an instrumented function.
+ * The wall time runs from construction to destruction; the lock wait is the time between
+ * construction and the call to lockAcquired().
+ */
+class H5ScopedInstrumentation
+{
+public:
+  using Clock = std::chrono::steady_clock;
+
+  explicit H5ScopedInstrumentation(H5FunctionCounters& counters)
+  : m_Counters(counters)
+  , m_Start(Clock::now())
+  {
+  }
+
+  ~H5ScopedInstrumentation()
+  {
+    m_Counters.calls.fetch_add(1, std::memory_order_relaxed);
+    m_Counters.wallTimeNs.fetch_add(elapsedNs(m_Start), std::memory_order_relaxed);
+  }
+
+  H5ScopedInstrumentation(const H5ScopedInstrumentation&) = delete;            // Copy Constructor Not Implemented
+  H5ScopedInstrumentation(H5ScopedInstrumentation&&) = delete;                 // Move Constructor Not Implemented
+  H5ScopedInstrumentation& operator=(const H5ScopedInstrumentation&) = delete; // Copy Assignment Not Implemented
+  H5ScopedInstrumentation& operator=(H5ScopedInstrumentation&&) = delete;      // Move Assignment Not Implemented
+
+  /**
+   * @brief Marks the point at which the H5SupportMutex was acquired
+   */
+  void lockAcquired()
+  {
+    m_Counters.lockWaitNs.fetch_add(elapsedNs(m_Start), std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Adds to the number of bytes moved by this call
+   * @param numBytes
+   */
+  void addBytes(uint64_t numBytes)
+  {
+    m_Counters.bytes.fetch_add(numBytes, std::memory_order_relaxed);
+  }
+
+private:
+  static uint64_t elapsedNs(Clock::time_point start)
+  {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count());
+  }
+
+  H5FunctionCounters& m_Counters;
+  Clock::time_point m_Start;
+};
+
+#if defined(H5Support_NAMESPACE)
+}
+#endif
@@ -41,16 +41,118 @@
 #include <cstring>
 #include <iostream>
 #include <map>
+#include <memory>
 #include <numeric>
 #include <string>
 #include <type_traits>
-#include <typeinfo>
 #include <vector>
 
 #include <hdf5.h>
 
 #include "H5Support/H5Macros.h"
 #include "H5Support/H5Support.h"
+#include "H5Support/H5TypeTraits.h"
+
+#if defined(H5Support_NAMESPACE)
+namespace H5Support_NAMESPACE
+{
+#endif
+
+/**
+ * @brief The H5FilterPipeline struct describes the HDF5 filters a chunked dataset is written
+ * through. The filters run in the order of the members: a registered element transform,
+ * scale-offset or N-bit first, since they need the datatype, then shuffle, deflate, a
+ * registered codec and the Fletcher32 checksum.
+ * @code
+ * // Byte shuffle ahead of deflate, which usually pays off for integer label volumes
+ * H5FilterPipeline pipeline = H5FilterPipeline::Deflate(6);
+ * pipeline.shuffle = true;
+ * H5Lite::writeVectorDatasetCompressed(fileID, "FeatureIds", dims, featureIds, cDims, pipeline);
+ * @endcode
+ */
+struct H5FilterPipeline
+{
+  /**
+   * @brief A registered filter that sees the raw elements, such as the delta and run-length
+   * filters of H5CodecFilters.h, and its client data values. H5Z_FILTER_NONE skips it.
+   */
+  H5Z_filter_t transform = H5Z_FILTER_NONE;
+  std::vector<uint32_t> transformValues;
+  /**
+   * @brief Scale-offset filter. Integers keep scaleFactor bits (0 lets HDF5 compute the minimum
+   * lossless bit count). Floats are quantized to scaleFactor decimal digits relative to the minimum
+   * of each chunk, which is lossy: values come back within 10^-scaleFactor.
+   */
+  bool scaleOffset = false;
+  int32_t scaleFactor = 0;
+  /**
+   * @brief N-bit filter for integer data. A value between 1 and the type size in bits stores
+   * the dataset with that many significant bits, counting the sign bit of signed types; every
+   * value must fit in them. 0 disables it.
+   */
+  size_t nbitPrecision = 0;
+  bool shuffle = false;
+  /**
+   * @brief Deflate level 0 - 9, or -1 to skip deflate
+   */
+  int32_t deflateLevel = -1;
+  /**
+   * @brief A registered filter run after deflate, such as the codecs of H5CodecFilters.h, and
+   * its client data values. H5Z_FILTER_NONE skips it.
+   */
+  H5Z_filter_t codec = H5Z_FILTER_NONE;
+  std::vector<uint32_t> codecValues;
+  bool fletcher32 = false;
+  /**
+   * @brief Whether chunks that hang over the edge of the dataset go through the filters.
+   * Leaving them unfiltered saves the work of compressing the padding of small edge chunks.
+   * This needs the 1.10 chunk layout, so the file must allow H5F_LIBVER_V110 as upper bound;
+   * files made by H5Utilities::createFile() stay readable by 1.8 and reject it.
+   */
+  bool filterPartialEdgeChunks = true;
+
+  /**
+   * @brief Returns the pipeline the compressionLevel overloads use: deflate only
+   * @param level
+   * @return
+   */
+  static H5FilterPipeline Deflate(int32_t level)
+  {
+    H5FilterPipeline pipeline;
+    pipeline.deflateLevel = level;
+    return pipeline;
+  }
+
+  /**
+   * @brief Returns a pipeline that byte shuffles the data and runs it through a registered codec
+   * @param filter The filter id of the codec
+   * @param values The client data values of the codec
+   * @return
+   */
+  static H5FilterPipeline Codec(H5Z_filter_t filter, const std::vector<uint32_t>& values = {})
+  {
+    H5FilterPipeline pipeline;
+    pipeline.shuffle = true;
+    pipeline.codec = filter;
+    pipeline.codecValues = values;
+    return pipeline;
+  }
+
+  /**
+   * @brief Returns a pipeline that runs the elements through a registered transform and then,
+   * optionally, a registered codec
+   * @param filter The filter id of the transform
+   * @param codec The filter id of the codec or H5Z_FILTER_NONE
+   * @return
+   */
+  static H5FilterPipeline Transform(H5Z_filter_t filter, H5Z_filter_t codec = H5Z_FILTER_NONE)
+  {
+    H5FilterPipeline pipeline;
+    pipeline.transform = filter;
+    pipeline.codec = codec;
+    return pipeline;
+  }
+};
 
 /**
  * @brief Namespace to bring together some high level methods to read/write data to HDF5 files.
@@ -81,7 +183,7 @@ constexpr size_t k_ChunkMax = 1024 * 1024;
  */
 inline herr_t find_dataset(hid_t /*locationID*/, const char* name, void* op_data)
 {
-  H5SUPPORT_MUTEX_LOCK()
+  H5SUPPORT_MUTEX_LOCK_SHARED()
   /* Define a default zero value for return. This will cause the iterator to continue if
    * the dataset is not found yet.
    */
@@ -111,7 +213,7 @@ inline herr_t find_dataset(hid_t /*locationID*/, const char* name, void* op_data
 // -----------------------------------------------------------------------------
 inline herr_t find_attr(hid_t /*locationID*/, const char* name, const H5A_info_t* /*info*/, void* op_data)
 {
-  H5SUPPORT_MUTEX_LOCK()
+  H5SUPPORT_MUTEX_LOCK_SHARED()
   /* Define a default zero value for return. This will cause the iterator to continue if
    * the palette attribute is not found yet.
    */
@@ -169,7 +271,7 @@ inline void disableErrorHandlers()
  */
 inline hid_t openId(hid_t locationID, const std::string& objectName, H5O_type_t objectType)
 {
-  H5SUPPORT_MUTEX_LOCK()
+  H5SUPPORT_MUTEX_LOCK_SHARED()
 
   hid_t objectID = -1;
 
@@ -208,7 +310,7 @@ inline hid_t openId(hid_t locationID, const std::string& objectName, H5O_type_t
  */
 inline herr_t closeId(hid_t objectID, int32_t objectType)
 {
-  H5SUPPORT_MUTEX_LOCK()
+  H5SUPPORT_MUTEX_LOCK_SHARED()
 
   switch(objectType)
   {
@@ -302,7 +404,7 @@ inline std::string StringForHDFClassType(H5T_class_t classType)
  */
 inline hid_t HDFTypeFromString(const std::string& value)
 {
-  H5SUPPORT_MUTEX_LOCK()
+  H5SUPPORT_MUTEX_LOCK_SHARED()
 
   if(value == "H5T_STRING")
   {
@@ -365,7 +467,7 @@ inline hid_t HDFTypeFromString(const std::string& value)
  */
 inline std::string StringForHDFType(hid_t dataTypeIdentifier)
 {
-  H5SUPPORT_MUTEX_LOCK()
+  H5SUPPORT_MUTEX_LOCK_SHARED()
 
   if(dataTypeIdentifier == H5T_STRING)
   {
@@ -427,216 +529,23 @@ inline std::string StringForHDFType(hid_t dataTypeIdentifier)
  * from
  * @return A std::string representing the HDF5 Type
  */
-template <typename T> inline std::string HDFTypeForPrimitiveAsStr(T value)
+template <typename T> inline std::string HDFTypeForPrimitiveAsStr(T /*value*/)
 {
-  H5SUPPORT_MUTEX_LOCK()
-
-  if(std::is_same<T, int8_t>::value)
-  {
-    return "H5T_NATIVE_INT8";
-  }
-  if(std::is_same<T, uint8_t>::value)
-  {
-    return "H5T_NATIVE_UINT8";
-  }
-
-  if(std::is_same<T, int16_t>::value)
-  {
-    return "H5T_NATIVE_INT16";
-  }
-  if(std::is_same<T, uint16_t>::value)
-  {
-    return "H5T_NATIVE_UINT16";
-  }
-
-  if(std::is_same<T, int32_t>::value)
-  {
-    return "H5T_NATIVE_INT32";
-  }
-  if(std::is_same<T, uint32_t>::value)
-  {
-    return "H5T_NATIVE_UINT32";
-  }
-
-  if(std::is_same<T, int64_t>::value)
-  {
-    return "H5T_NATIVE_INT64";
-  }
-  if(std::is_same<T, uint64_t>::value)
-  {
-    return "H5T_NATIVE_UINT64";
-  }
-
-  if(std::is_same<T, float>::value)
-  {
-    return "H5T_NATIVE_FLOAT";
-  }
-  if(std::is_same<T, double>::value)
-  {
-    return "H5T_NATIVE_DOUBLE";
-  }
-
-  // if (typeid(value) == typeid(bool)) return "H5T_NATIVE_UINT8";
-
-  std::cout << "Error: HDFTypeForPrimitiveAsStr - Unknown Type: " << typeid(value).name() << std::endl;
-  return "";
+  static_assert(H5TypeTraits<T>::k_Supported, "HDFTypeForPrimitiveAsStr: there is no HDF5 type for T, see H5TypeTraits");
+  return H5TypeTraits<T>::name();
 }
 
 /**
- * @brief Returns the HDF Type for a given primitive value.
+ * @brief Returns the HDF Type for a given primitive value. The type is selected at compile
+ * time through H5TypeTraits; types without a mapping do not compile.
  * @param value A value to use. Can be anything. Just used to get the type info
  * from
  * @return The HDF5 native type for the value
  */
-template <typename T> inline hid_t HDFTypeForPrimitive(T value)
+template <typename T> inline hid_t HDFTypeForPrimitive(T /*value*/)
 {
-  H5SUPPORT_MUTEX_LOCK()
-
-  if(std::is_same<T, float>::value)
-  {
-    return H5T_NATIVE_FLOAT;
-  }
-  if(std::is_same<T, double>::value)
-  {
-    return H5T_NATIVE_DOUBLE;
-  }
-
-  if(std::is_same<T, int8_t>::value)
-  {
-    return H5T_NATIVE_INT8;
-  }
-  if(std::is_same<T, uint8_t>::value)
-  {
-    return H5T_NATIVE_UINT8;
-  }
-#if CMP_TYPE_CHAR_IS_SIGNED
-  if(std::is_same<T, char>::value)
-  {
-    return H5T_NATIVE_INT8;
-  }
-#else
-  if(std::is_same<T, char>::value)
-  {
-    return H5T_NATIVE_UINT8;
-  }
-#endif
-  if(std::is_same<T, signed char>::value)
-  {
-    return H5T_NATIVE_INT8;
-  }
-  if(std::is_same<T, unsigned char>::value)
-  {
-    return H5T_NATIVE_UINT8;
-  }
-
-  if(std::is_same<T, int16_t>::value)
-  {
-    return H5T_NATIVE_INT16;
-  }
-  if(std::is_same<T, short>::value)
-  {
-    return H5T_NATIVE_INT16;
-  }
-  if(std::is_same<T, signed short>::value)
-  {
-    return H5T_NATIVE_INT16;
-  }
-  if(std::is_same<T, uint16_t>::value)
-  {
-    return H5T_NATIVE_UINT16;
-  }
-  if(std::is_same<T, unsigned short>::value)
-  {
-    return H5T_NATIVE_UINT16;
-  }
-
-  if(std::is_same<T, int32_t>::value)
-  {
-    return H5T_NATIVE_INT32;
-  }
-  if(std::is_same<T, uint32_t>::value)
-  {
-    return H5T_NATIVE_UINT32;
-  }
-#if(CMP_SIZEOF_INT == 4)
-  if(std::is_same<T, int>::value)
-  {
-    return H5T_NATIVE_INT32;
-  }
-  if(std::is_same<T, signed int>::value)
-  {
-    return H5T_NATIVE_INT32;
-  }
-  if(std::is_same<T, unsigned int>::value)
-  {
-    return H5T_NATIVE_UINT32;
-  }
-#endif
-
-#if(CMP_SIZEOF_LONG == 4)
-  if(std::is_same<T, long int>::value)
-  {
-    return H5T_NATIVE_INT32;
-  }
-  if(std::is_same<T, signed long int>::value)
-  {
-    return H5T_NATIVE_INT32;
-  }
-  if(std::is_same<T, unsigned long int>::value)
-  {
-    return H5T_NATIVE_UINT32;
-  }
-#elif(CMP_SIZEOF_LONG == 8)
-  if(std::is_same<T, long int>::value)
-  {
-    return H5T_NATIVE_INT64;
-  }
-  if(std::is_same<T, signed long int>::value)
-  {
-    return H5T_NATIVE_INT64;
-  }
-  if(std::is_same<T, unsigned long int>::value)
-  {
-    return H5T_NATIVE_UINT64;
-  }
-#endif
-
-#if(CMP_SIZEOF_LONG_LONG == 8)
-  if(std::is_same<T, long long int>::value)
-  {
-    return H5T_NATIVE_INT64;
-  }
-  if(std::is_same<T, signed long long int>::value)
-  {
-    return H5T_NATIVE_INT64;
-  }
-  if(std::is_same<T, unsigned long long int>::value)
-  {
-    return H5T_NATIVE_UINT64;
-  }
-#endif
-  if(std::is_same<T, int64_t>::value)
-  {
-    return H5T_NATIVE_INT64;
-  }
-  if(std::is_same<T, uint64_t>::value)
-  {
-    return H5T_NATIVE_UINT64;
-  }
-
-  if(std::is_same<T, bool>::value)
-  {
-    return H5T_NATIVE_UINT8;
-  }
-
-  std::cout << "Error: HDFTypeForPrimitive - Unknown Type: " << (typeid(value).name()) << std::endl;
-  const char* name = typeid(value).name();
-  if(nullptr != name && name[0] == 'l')
-  {
-    std::cout << "You are using 'long int' as a type which is not 32/64 bit safe. Suggest you use one of the H5SupportTypes defined in <Common/H5SupportTypes.h> such as int32_t or uint32_t."
-              << std::endl;
-  }
-  return -1;
+  static_assert(H5TypeTraits<T>::k_Supported, "HDFTypeForPrimitive: there is no HDF5 type for T, see H5TypeTraits");
+  return H5TypeTraits<T>::type();
 }
 
 /**
@@ -647,7 +556,7 @@ template <typename T> inline hid_t HDFTypeForPrimitive(T value)
  */
 inline herr_t findAttribute(hid_t locationID, const std::string& attributeName)
 {
-  H5SUPPORT_MUTEX_LOCK()
+  H5SUPPORT_MUTEX_LOCK_SHARED()
 
   hsize_t attributeNum;
   herr_t returnError = 0;
@@ -666,7 +575,7 @@ inline herr_t findAttribute(hid_t locationID, const std::string& attributeName)
  */
 inline bool datasetExists(hid_t locationID, const std::string& datasetName)
 {
-  H5SUPPORT_MUTEX_LOCK()
+  H5SUPPORT_MUTEX_LOCK_SHARED()
 
   H5O_info_t objectInfo{};
   HDF_ERROR_HANDLER_OFF
@@ -697,7 +606,7 @@ template <typename T> inline herr_t writePointerDataset(hid_t locationID, const
   {
     return -2;
   }
-  hid_t dataType = HDFTypeForPrimitive(data[0]);
+  hid_t dataType = H5TypeTraits<T>::type();
   if(dataType == -1)
   {
     return -1;
@@ -714,6 +623,7 @@ template <typename T> inline herr_t writePointerDataset(hid_t locationID, const
   if(datasetID >= 0)
   {
     error = H5Dwrite(datasetID, dataType, H5S_ALL, H5S_ALL, H5P_DEFAULT, data);
+    H5SUPPORT_INSTRUMENT_BYTES(error, H5Instrumentation::dataspaceBytes(dataspaceID, dataType))
     if(error < 0)
     {
       std::cout << "Error Writing Data '" << datasetName << "'" << std::endl;
@@ -773,7 +683,7 @@ template <typename T> inline herr_t replacePointerDataset(hid_t locationID, cons
     return -2;
   }
 
-  hid_t dataType = H5Lite::HDFTypeForPrimitive(data[0]);
+  hid_t dataType = H5TypeTraits<T>::type();
   if(dataType == -1)
   {
     return -1;
@@ -795,6 +705,7 @@ template <typename T> inline herr_t replacePointerDataset(hid_t locationID, cons
   if(datasetID >= 0)
   {
     error = H5Dwrite(datasetID, dataType, H5S_ALL, H5S_ALL, H5P_DEFAULT, data);
+    H5SUPPORT_INSTRUMENT_BYTES(error, H5Instrumentation::dataspaceBytes(dataspaceID, dataType))
     if(error < 0)
     {
       std::cout << "Error Writing Data" << std::endl;
@@ -852,6 +763,165 @@ template <typename T> inline herr_t writeVectorDataset(hid_t locationID, const s
   return writePointerDataset(locationID, datasetName, static_cast<int32_t>(dims.size()), dims.data(), data.data());
 }
 
+/**
+ * @brief Selects a hyperslab in the file dataspace of an open dataset and creates the
+ * matching contiguous memory dataspace. Both dataspaces must be closed by the caller
+ * when this function succeeds.
+ * @param datasetID The open dataset
+ * @param rank The number of dimensions of offset, count, stride and block. Must match the rank of the dataset
+ * @param offset The starting index of the slab in each dimension
+ * @param count The number of blocks to select in each dimension
+ * @param stride The distance between the start of consecutive blocks in each dimension. nullptr means 1
+ * @param block The size of a block in each dimension. nullptr means 1
+ * @param fileSpaceID Receives the file dataspace with the hyperslab selected
+ * @param memSpaceID Receives the memory dataspace
+ * @return Standard hdf5 error condition.
+ */
+inline herr_t selectDatasetSlab(hid_t datasetID, int32_t rank, const hsize_t* offset, const hsize_t* count, const hsize_t* stride, const hsize_t* block, hid_t& fileSpaceID, hid_t& memSpaceID)
+{
+  H5SUPPORT_MUTEX_LOCK_SHARED()
+
+  fileSpaceID = -1;
+  memSpaceID = -1;
+  if(nullptr == offset || nullptr == count)
+  {
+    std::cout << "H5Lite.h::selectDatasetSlab(" << __LINE__ << ") The offset and count arrays must not be nullptr" << std::endl;
+    return -2;
+  }
+  hid_t dataspaceID = H5Dget_space(datasetID);
+  if(dataspaceID < 0)
+  {
+    std::cout << "H5Lite.h::selectDatasetSlab(" << __LINE__ << ") Error getting the dataspace of the dataset" << std::endl;
+    return static_cast<herr_t>(dataspaceID);
+  }
+  if(H5Sget_simple_extent_ndims(dataspaceID) != rank)
+  {
+    std::cout << "H5Lite.h::selectDatasetSlab(" << __LINE__ << ") The rank of the slab (" << rank << ") does not match the rank of the dataset (" << H5Sget_simple_extent_ndims(dataspaceID) << ")"
+              << std::endl;
+    H5Sclose(dataspaceID);
+    return -3;
+  }
+  herr_t error = H5Sselect_hyperslab(dataspaceID, H5S_SELECT_SET, offset, stride, count, block);
+  if(error < 0 || H5Sselect_valid(dataspaceID) <= 0)
+  {
+    std::cout << "H5Lite.h::selectDatasetSlab(" << __LINE__ << ") The slab does not fit inside the dataset" << std::endl;
+    H5Sclose(dataspaceID);
+    return -4;
+  }
+  std::vector<hsize_t> memDims(count, count + rank);
+  if(nullptr != block)
+  {
+    for(int32_t i = 0; i < rank; ++i)
+    {
+      memDims[i] *= block[i];
+    }
+  }
+  memSpaceID = H5Screate_simple(rank, memDims.data(), nullptr);
+  if(memSpaceID < 0)
+  {
+    std::cout << "H5Lite.h::selectDatasetSlab(" << __LINE__ << ") Error creating the memory dataspace" << std::endl;
+    H5Sclose(dataspaceID);
+    return static_cast<herr_t>(memSpaceID);
+  }
+  fileSpaceID = dataspaceID;
+  return 0;
+}
+
+/**
+ * @brief Writes the data of a pointer into a hyperslab of an existing dataset. The
+ * data is a contiguous array holding prod(count[i] * block[i]) elements in C order.
+ * @param locationID The hdf5 object id of the parent
+ * @param datasetName The name of the existing dataset to write to
+ * @param rank The number of dimensions. Must match the rank of the dataset
+ * @param offset The starting index of the slab in each dimension
+ * @param count The number of blocks to write in each dimension
+ * @param stride The distance between the start of consecutive blocks in each dimension. nullptr means 1
+ * @param block The size of a block in each dimension. nullptr means 1
+ * @param data The data to be written.
+ * @return Standard hdf5 error condition.
+ */
+template <typename T>
+inline herr_t writePointerDatasetSlab(hid_t locationID, const std::string& datasetName, int32_t rank, const hsize_t* offset, const hsize_t* count, const hsize_t* stride, const hsize_t* block, const T* data)
+{
+  H5SUPPORT_MUTEX_LOCK()
+
+  herr_t error = 0;
+  herr_t returnError = 0;
+  if(nullptr == data)
+  {
+    return -2;
+  }
+  hid_t dataType = H5TypeTraits<T>::type();
+  if(dataType == -1)
+  {
+    return -1;
+  }
+  hid_t datasetID = H5Dopen(locationID, datasetName.c_str(), H5P_DEFAULT);
+  if(datasetID < 0)
+  {
+    std::cout << "H5Lite.h::writePointerDatasetSlab(" << __LINE__ << ") Error opening Dataset at locationID (" << locationID << ") with object name (" << datasetName << ")" << std::endl;
+    return -1;
+  }
+  hid_t fileSpaceID = -1;
+  hid_t memSpaceID = -1;
+  error = selectDatasetSlab(datasetID, rank, offset, count, stride, block, fileSpaceID, memSpaceID);
+  if(error >= 0)
+  {
+    error = H5Dwrite(datasetID, dataType, memSpaceID, fileSpaceID, H5P_DEFAULT, data);
+    H5SUPPORT_INSTRUMENT_BYTES(error, H5Instrumentation::dataspaceBytes(memSpaceID, dataType))
+    if(error < 0)
+    {
+      std::cout << "Error Writing Slab of '" << datasetName << "'" << std::endl;
+      returnError = error;
+    }
+    H5Sclose(memSpaceID);
+    H5Sclose(fileSpaceID);
+  }
+  else
+  {
+    returnError = error;
+  }
+  error = H5Dclose(datasetID);
+  if(error < 0)
+  {
+    std::cout << "Error Closing Dataset." << std::endl;
+    returnError = error;
+  }
+  return returnError;
+}
+
+/**
+ * @brief Writes a std::vector into a hyperslab of an existing dataset. The rank of the
+ * slab is offset.size(). Empty stride or block vectors mean 1 in every dimension.
+ * @param locationID The hdf5 object id of the parent
+ * @param datasetName The name of the existing dataset to write to
+ * @param offset The starting index of the slab in each dimension
+ * @param count The number of blocks to write in each dimension
+ * @param data The data to be written. Must hold prod(count[i] * block[i]) elements
+ * @param stride The distance between the start of consecutive blocks in each dimension
+ * @param block The size of a block in each dimension
+ * @return Standard hdf5 error condition.
+ */
+template <typename T>
+inline herr_t writeVectorDatasetSlab(hid_t locationID, const std::string& datasetName, const std::vector<hsize_t>& offset, const std::vector<hsize_t>& count, const std::vector<T>& data,
+                                     const std::vector<hsize_t>& stride = {}, const std::vector<hsize_t>& block = {})
+{
+  if(count.size() != offset.size() || (!stride.empty() && stride.size() != offset.size()) || (!block.empty() && block.size() != offset.size()))
+  {
+    std::cout << "H5Lite.h::writeVectorDatasetSlab(" << __LINE__ << ") offset, count, stride and block must have the same size" << std::endl;
+    return -3;
+  }
+  hsize_t numElements = std::accumulate(count.cbegin(), count.cend(), static_cast<hsize_t>(1), std::multiplies<hsize_t>());
+  numElements = std::accumulate(block.cbegin(), block.cend(), numElements, std::multiplies<hsize_t>());
+  if(numElements != data.size())
+  {
+    std::cout << "H5Lite.h::writeVectorDatasetSlab(" << __LINE__ << ") The slab holds " << numElements << " elements but the vector holds " << data.size() << std::endl;
+    return -3;
+  }
+  return writePointerDatasetSlab(locationID, datasetName, static_cast<int32_t>(offset.size()), offset.data(), count.data(), stride.empty() ? nullptr : stride.data(), block.empty() ? nullptr : block.data(),
+                                 data.data());
+}
+
 /**
  * @brief Returns a guess for the vector of chunk dimensions based on the input parameters.
  * @param dims The vector dimensions of the dataset
@@ -918,9 +988,93 @@ inline std::vector<hsize_t> guessChunkSize(int32_t rank, const hsize_t* dims, si
   return guessChunkSize(vDims, typeSize);
 }
 
+/**
+ * @brief Adds the filters of a pipeline to a dataset creation property list
+ * @param propertyListID A dataset creation property list that already has a chunk layout
+ * @param pipeline The filters to add
+ * @param dataType The memory type of the data. Selects the scale-offset mode.
+ * @return Standard HDF5 error conditions
+ */
+inline herr_t applyFilterPipeline(hid_t propertyListID, const H5FilterPipeline& pipeline, hid_t dataType)
+{
+  H5SUPPORT_MUTEX_LOCK_SHARED()
+
+  herr_t error = 0;
+  H5T_class_t classType = H5Tget_class(dataType);
+  if(static_cast<int32_t>(pipeline.transform != H5Z_FILTER_NONE) + static_cast<int32_t>(pipeline.scaleOffset) + static_cast<int32_t>(pipeline.nbitPrecision > 0) > 1)
+  {
+    std::cout << "H5Lite.h::applyFilterPipeline(" << __LINE__ << ") Only one of the transform, scale-offset and N-bit filters can be used" << std::endl;
+    return -1;
+  }
+  if(pipeline.transform != H5Z_FILTER_NONE)
+  {
+    error = H5Pset_filter(propertyListID, pipeline.transform, H5Z_FLAG_MANDATORY, pipeline.transformValues.size(), pipeline.transformValues.data());
+  }
+  if(error >= 0 && pipeline.scaleOffset)
+  {
+    if(classType == H5T_INTEGER)
+    {
+      error = H5Pset_scaleoffset(propertyListID, H5Z_SO_INT, pipeline.scaleFactor);
+    }
+    else if(classType == H5T_FLOAT)
+    {
+      error = H5Pset_scaleoffset(propertyListID, H5Z_SO_FLOAT_DSCALE, pipeline.scaleFactor);
+    }
+    else
+    {
+      std::cout << "H5Lite.h::applyFilterPipeline(" << __LINE__ << ") The scale-offset filter needs integer or floating point data" << std::endl;
+      return -1;
+    }
+  }
+  if(error >= 0 && pipeline.nbitPrecision > 0)
+  {
+    if(classType != H5T_INTEGER || pipeline.nbitPrecision > H5Tget_size(dataType) * 8)
+    {
+      std::cout << "H5Lite.h::applyFilterPipeline(" << __LINE__ << ") The N-bit filter needs integer data of at least " << pipeline.nbitPrecision << " bits" << std::endl;
+      return -1;
+    }
+    error = H5Pset_nbit(propertyListID);
+  }
+  if(error >= 0 && pipeline.shuffle)
+  {
+    error = H5Pset_shuffle(propertyListID);
+  }
+  if(error >= 0 && pipeline.deflateLevel >= 0)
+  {
 #ifdef H5_HAVE_FILTER_DEFLATE
+    error = H5Pset_deflate(propertyListID, static_cast<uint32_t>(pipeline.deflateLevel));
+#else
+    std::cout << "H5Lite.h::applyFilterPipeline(" << __LINE__ << ") This HDF5 library was built without the deflate filter" << std::endl;
+    return -1;
+#endif
+  }
+  if(error >= 0 && pipeline.codec != H5Z_FILTER_NONE)
+  {
+    error = H5Pset_filter(propertyListID, pipeline.codec, H5Z_FLAG_MANDATORY, pipeline.codecValues.size(), pipeline.codecValues.data());
+  }
+  if(error >= 0 && pipeline.fletcher32)
+  {
+    error = H5Pset_fletcher32(propertyListID);
+  }
+  if(error >= 0 && !pipeline.filterPartialEdgeChunks)
+  {
+#if H5_VERSION_GE(1, 10, 0)
+    error = H5Pset_chunk_opts(propertyListID, H5D_CHUNK_DONT_FILTER_PARTIAL_CHUNKS);
+#else
+    std::cout << "H5Lite.h::applyFilterPipeline(" << __LINE__ << ") Skipping the filters on partial edge chunks needs HDF5 1.10" << std::endl;
+    return -1;
+#endif
+  }
+  if(error < 0)
+  {
+    std::cout << "H5Lite.h::applyFilterPipeline(" << __LINE__ << ") Error adding the filters to the property list" << std::endl;
+  }
+  return error;
+}
+
 /**
- * @brief Creates a Dataset with the given name at the location defined by locationID with the given compression
+ * @brief Creates a chunked Dataset with the given name at the location defined by locationID,
+ * writing it through the filters of a pipeline
  *
  * @param locationID The Parent location to store the data
  * @param datasetName The name of the dataset
@@ -929,12 +1083,12 @@ inline std::vector<hsize_t> guessChunkSize(int32_t rank, const hsize_t* dims, si
  * @param data The data to write to the file
  * @param cRank The number of dimensions for cDims
  * @param cDims The chunk dimensions
- * @param compressionLevel The compression level (0-9)
+ * @param pipeline The filters to apply
  * @return Standard HDF5 error conditions
  */
 template <typename T>
 inline herr_t writePointerDatasetCompressed(hid_t locationID, const std::string& datasetName, int32_t rank, const hsize_t* dims, const T* data, int32_t cRank, const hsize_t* cDims,
-                                            int32_t compressionLevel)
+                                            const H5FilterPipeline& pipeline)
 {
   H5SUPPORT_MUTEX_LOCK()
 
@@ -946,7 +1100,7 @@ inline herr_t writePointerDatasetCompressed(hid_t locationID, const std::string&
     return -100;
   }
 
-  hid_t dataType = HDFTypeForPrimitive(data[0]);
+  hid_t dataType = H5TypeTraits<T>::type();
 
   if(dataType == -1)
   {
@@ -978,41 +1132,31 @@ inline herr_t writePointerDatasetCompressed(hid_t locationID, const std::string&
   error = H5Pset_chunk(propertListID, cRank, cDims);
   if(error < 0)
   {
-    error = H5Pclose(propertListID);
-    if(error < 0)
-    {
-      returnError = -105;
-    }
-    error = H5Sclose(dataspaceID);
-    if(error < 0)
-    {
-      returnError = -106;
-    }
-    return returnError;
+    returnError = -105;
+  }
+  else if(applyFilterPipeline(propertListID, pipeline, dataType) < 0)
+  {
+    returnError = -107;
   }
 
-  error = H5Pset_deflate(propertListID, compressionLevel);
-  if(error < 0)
+  // The N-bit filter packs the significant bits of a narrower file type
+  hid_t fileType = dataType;
+  if(returnError == 0 && pipeline.nbitPrecision > 0)
   {
-    error = H5Pclose(propertListID);
-    if(error < 0)
-    {
-      returnError = -107;
-    }
-    error = H5Sclose(dataspaceID);
-    if(error < 0)
+    fileType = H5Tcopy(dataType);
+    if(fileType < 0 || H5Tset_precision(fileType, pipeline.nbitPrecision) < 0)
     {
-      returnError = -108;
+      returnError = -109;
     }
-    return returnError;
   }
 
   // Create the Dataset
 
-  hid_t datasetID = H5Dcreate(locationID, datasetName.c_str(), dataType, dataspaceID, H5P_DEFAULT, propertListID, H5P_DEFAULT);
+  hid_t datasetID = (returnError < 0) ? -1 : H5Dcreate(locationID, datasetName.c_str(), fileType, dataspaceID, H5P_DEFAULT, propertListID, H5P_DEFAULT);
   if(datasetID >= 0)
   {
     error = H5Dwrite(datasetID, dataType, H5S_ALL, H5S_ALL, H5P_DEFAULT, data);
+    H5SUPPORT_INSTRUMENT_BYTES(error, H5Instrumentation::dataspaceBytes(dataspaceID, dataType))
     if(error < 0)
     {
       std::cout << "Error Writing Data" << std::endl;
@@ -1025,13 +1169,17 @@ inline herr_t writePointerDatasetCompressed(hid_t locationID, const std::string&
       returnError = -110;
     }
   }
-  else
+  else if(returnError == 0)
   {
     returnError = -111;
   }
 
   // Terminate access to the data space and property list.
 
+  if(fileType >= 0 && fileType != dataType)
+  {
+    H5Tclose(fileType);
+  }
   error = H5Pclose(propertListID);
   if(error < 0)
   {
@@ -1048,6 +1196,46 @@ inline herr_t writePointerDatasetCompressed(hid_t locationID, const std::string&
   return returnError;
 }
 
+/**
+ * @brief Creates a chunked Dataset with the given name at the location defined by locationID,
+ * writing it through the filters of a pipeline
+ *
+ * @param locationID The Parent location to store the data
+ * @param datasetName The name of the dataset
+ * @param dims The dimensions of the dataset
+ * @param data The data to write to the file
+ * @param cDims The chunk dimensions
+ * @param pipeline The filters to apply
+ * @return Standard HDF5 error conditions
+ */
+template <typename T>
+inline herr_t writeVectorDatasetCompressed(hid_t locationID, const std::string& datasetName, const std::vector<hsize_t>& dims, const std::vector<T>& data, const std::vector<hsize_t>& cDims,
+                                           const H5FilterPipeline& pipeline)
+{
+  return writePointerDatasetCompressed(locationID, datasetName, static_cast<int32_t>(dims.size()), dims.data(), data.data(), static_cast<int32_t>(cDims.size()), cDims.data(), pipeline);
+}
+
+#ifdef H5_HAVE_FILTER_DEFLATE
+/**
+ * @brief Creates a Dataset with the given name at the location defined by locationID with the given compression
+ *
+ * @param locationID The Parent location to store the data
+ * @param datasetName The name of the dataset
+ * @param rank The number of dimensions
+ * @param dims The dimensions of the dataset
+ * @param data The data to write to the file
+ * @param cRank The number of dimensions for cDims
+ * @param cDims The chunk dimensions
+ * @param compressionLevel The compression level (0-9)
+ * @return Standard HDF5 error conditions
+ */
+template <typename T>
+inline herr_t writePointerDatasetCompressed(hid_t locationID, const std::string& datasetName, int32_t rank, const hsize_t* dims, const T* data, int32_t cRank, const hsize_t* cDims,
+                                            int32_t compressionLevel)
+{
+  return writePointerDatasetCompressed(locationID, datasetName, rank, dims, data, cRank, cDims, H5FilterPipeline::Deflate(compressionLevel));
+}
+
 /**
  * @brief Creates a Dataset with the given name at the location defined by locationID with the given compression
  *
@@ -1101,7 +1289,7 @@ template <typename T> inline herr_t writeScalarDataset(hid_t locationID, const s
   herr_t returnError = 0;
   hsize_t dims = 1;
   hid_t rank = 1;
-  hid_t dataType = HDFTypeForPrimitive(value);
+  hid_t dataType = H5TypeTraits<T>::type();
   if(dataType == -1)
   {
     return -1;
@@ -1117,6 +1305,7 @@ template <typename T> inline herr_t writeScalarDataset(hid_t locationID, const s
   if(datasetID >= 0)
   {
     error = H5Dwrite(datasetID, dataType, H5S_ALL, H5S_ALL, H5P_DEFAULT, &value);
+    H5SUPPORT_INSTRUMENT_BYTES(error, sizeof(value))
     if(error < 0)
     {
       std::cout << "Error Writing Data" << std::endl;
@@ -1186,6 +1375,7 @@ inline herr_t writeStringDataset(hid_t locationID, const std::string& datasetNam
             if(!data.empty())
             {
               error = H5Dwrite(datasetID, typeID, H5S_ALL, H5S_ALL, H5P_DEFAULT, data.c_str());
+              H5SUPPORT_INSTRUMENT_BYTES(error, data.size())
               if(error < 0)
               {
                 std::cout << "Error Writing String Data" << std::endl;
@@ -1257,6 +1447,7 @@ inline herr_t writeStringDataset(hid_t locationID, const std::string& datasetNam
             if(nullptr != data)
             {
               error = H5Dwrite(datasetID, typeID, H5S_ALL, H5S_ALL, H5P_DEFAULT, data);
+              H5SUPPORT_INSTRUMENT_BYTES(error, H5Instrumentation::dataspaceBytes(dataspaceID, typeID))
               if(error < 0)
               {
                 std::cout << "Error Writing String Data" << std::endl;
@@ -1271,74 +1462,202 @@ inline herr_t writeStringDataset(hid_t locationID, const std::string& datasetNam
           }
           CloseH5D(datasetID, error, returnError, datasetName);
         }
-        CloseH5S(dataspaceID, error, returnError);
+        CloseH5S(dataspaceID, error, returnError);
+      }
+    }
+    CloseH5T(typeID, error, returnError);
+  }
+  return returnError;
+}
+
+/**
+ * @brief Writes a vector of strings to a one dimensional variable length string dataset
+ * with a single H5Dwrite call. Large string tables can optionally be chunked and
+ * compressed.
+ * @param locationID The parent location for the dataset
+ * @param datasetName The name of the dataset
+ * @param data The strings to write
+ * @param chunkSize The number of strings per chunk. 0 writes a contiguous dataset unless
+ * compression is requested, in which case a chunk size is guessed.
+ * @param compressionLevel The deflate level (0 = no compression, 1-9)
+ * @return Standard HDF5 error conditions
+ */
+inline herr_t writeVectorOfStringsDataset(hid_t locationID, const std::string& datasetName, const std::vector<std::string>& data, hsize_t chunkSize = 0, int32_t compressionLevel = 0)
+{
+  H5SUPPORT_MUTEX_LOCK()
+
+  hid_t dataspaceID = -1;
+  hid_t datatype = -1;
+  hid_t propertyListID = H5P_DEFAULT;
+  hid_t datasetID = -1;
+  herr_t error = -1;
+  herr_t returnError = 0;
+
+  std::vector<const char*> strings(data.size(), nullptr);
+  size_t numBytes = 0;
+  for(size_t i = 0; i < data.size(); ++i)
+  {
+    strings[i] = data[i].c_str();
+    numBytes += data[i].size();
+  }
+
+  std::array<hsize_t, 1> dims = {data.size()};
+  if((dataspaceID = H5Screate_simple(static_cast<int>(dims.size()), dims.data(), nullptr)) < 0)
+  {
+    return static_cast<herr_t>(dataspaceID);
+  }
+
+  datatype = H5Tcopy(H5T_C_S1);
+  H5Tset_size(datatype, H5T_VARIABLE);
+
+  if(compressionLevel > 0 && chunkSize == 0 && !data.empty())
+  {
+    chunkSize = guessChunkSize(static_cast<int32_t>(dims.size()), dims.data(), sizeof(hvl_t)).front();
+  }
+  if(chunkSize > 0 && !data.empty())
+  {
+    hsize_t chunkDims = std::min(chunkSize, dims[0]);
+    propertyListID = H5Pcreate(H5P_DATASET_CREATE);
+    error = H5Pset_chunk(propertyListID, 1, &chunkDims);
+    if(error >= 0 && compressionLevel > 0)
+    {
+#ifdef H5_HAVE_FILTER_DEFLATE
+      error = H5Pset_deflate(propertyListID, static_cast<uint32_t>(compressionLevel));
+#else
+      std::cout << "Deflate compression is not available in this HDF5 library" << std::endl;
+      error = -1;
+#endif
+    }
+    if(error < 0)
+    {
+      std::cout << "Error setting up the chunked storage of '" << datasetName << "'" << std::endl;
+      returnError = error;
+    }
+  }
+
+  if(returnError >= 0)
+  {
+    if((datasetID = H5Dcreate(locationID, datasetName.c_str(), datatype, dataspaceID, H5P_DEFAULT, propertyListID, H5P_DEFAULT)) >= 0)
+    {
+      if(!strings.empty())
+      {
+        error = H5Dwrite(datasetID, datatype, H5S_ALL, H5S_ALL, H5P_DEFAULT, strings.data());
+        H5SUPPORT_INSTRUMENT_BYTES(error, numBytes)
+        if(error < 0)
+        {
+          std::cout << "Error Writing String Data: " __FILE__ << "(" << __LINE__ << ")" << std::endl;
+          returnError = error;
+        }
       }
+      CloseH5D(datasetID, error, returnError, datasetName);
+    }
+    else
+    {
+      std::cout << "Error Creating Dataset '" << datasetName << "'" << std::endl;
+      returnError = static_cast<herr_t>(datasetID);
     }
-    CloseH5T(typeID, error, returnError);
   }
+  if(propertyListID != H5P_DEFAULT)
+  {
+    H5Pclose(propertyListID);
+  }
+  H5Tclose(datatype);
+  CloseH5S(dataspaceID, error, returnError);
   return returnError;
 }
 
 /**
- * @brief Writes a vector of null terminated strings to an HDF dataset.
- * @param locationID
- * @param datasetName
- * @param size
- * @param data
- * @return
+ * @brief Writes an attribute to an object that is already open, replacing any existing
+ * attribute with the same name. Batched attribute writes use this so the object is only
+ * opened once for the whole set.
+ * @param objectID The open object that is getting the attribute
+ * @param attributeName The Name of the Attribute
+ * @param dataType The HDF5 type of the attribute data in memory and in the file
+ * @param dataspaceID The dataspace of the attribute
+ * @param data The Attribute Data to write
+ * @return Standard HDF Error Condition
  */
-inline herr_t writeVectorOfStringsDataset(hid_t locationID, const std::string& datasetName, const std::vector<std::string>& data)
+inline herr_t writeObjectAttribute(hid_t objectID, const std::string& attributeName, hid_t dataType, hid_t dataspaceID, const void* data)
 {
   H5SUPPORT_MUTEX_LOCK()
 
-  hid_t dataspaceID = -1;
-  hid_t memSpace = -1;
-  hid_t datatype = -1;
-  hid_t datasetID = -1;
-  herr_t error = -1;
+  herr_t error = 0;
   herr_t returnError = 0;
-
-  std::array<hsize_t, 1> dims = {data.size()};
-  if((dataspaceID = H5Screate_simple(static_cast<int>(dims.size()), dims.data(), nullptr)) >= 0)
+  htri_t hasAttribute = H5Aexists(objectID, attributeName.c_str());
+  if(hasAttribute < 0)
   {
-    dims[0] = 1;
-
-    if((memSpace = H5Screate_simple(static_cast<int>(dims.size()), dims.data(), nullptr)) >= 0)
+    std::cout << "Error checking for Attribute '" << attributeName << "'" << std::endl;
+    return static_cast<herr_t>(hasAttribute);
+  }
+  /* The attribute already exists, delete it */
+  if(hasAttribute > 0)
+  {
+    error = H5Adelete(objectID, attributeName.c_str());
+    if(error < 0)
     {
+      std::cout << "Error Deleting Existing Attribute '" << attributeName << "'" << std::endl;
+      return error;
+    }
+  }
 
-      datatype = H5Tcopy(H5T_C_S1);
-      H5Tset_size(datatype, H5T_VARIABLE);
+  hid_t attributeID = H5Acreate(objectID, attributeName.c_str(), dataType, dataspaceID, H5P_DEFAULT, H5P_DEFAULT);
+  if(attributeID < 0)
+  {
+    std::cout << "Error Creating Attribute '" << attributeName << "'" << std::endl;
+    return static_cast<herr_t>(attributeID);
+  }
+  error = H5Awrite(attributeID, dataType, data);
+  H5SUPPORT_INSTRUMENT_BYTES(error, H5Instrumentation::dataspaceBytes(dataspaceID, dataType))
+  if(error < 0)
+  {
+    std::cout << "Error Writing Attribute '" << attributeName << "'" << std::endl;
+    returnError = error;
+  }
+  CloseH5A(attributeID, error, returnError);
+  return returnError;
+}
 
-      if((datasetID = H5Dcreate(locationID, datasetName.c_str(), datatype, dataspaceID, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT)) >= 0)
-      {
-        // Select the "memory" to be written out - just 1 record.
-        hsize_t offset[] = {0};
-        hsize_t count[] = {1};
-        H5Sselect_hyperslab(memSpace, H5S_SELECT_SET, offset, nullptr, count, nullptr);
-        hsize_t pos = 0;
-        for(const auto& element : data)
-        {
-          // Select the file position, 1 record at position 'pos'
-          hsize_t count[] = {1};
-          hsize_t offset[] = {pos};
-          pos++;
-          H5Sselect_hyperslab(dataspaceID, H5S_SELECT_SET, offset, nullptr, count, nullptr);
-          const char* strPtr = element.c_str();
-          error = H5Dwrite(datasetID, datatype, memSpace, dataspaceID, H5P_DEFAULT, &strPtr);
-          if(error < 0)
-          {
-            std::cout << "Error Writing String Data: " __FILE__ << "(" << __LINE__ << ")" << std::endl;
-            returnError = error;
-          }
-        }
-        CloseH5D(datasetID, error, returnError, datasetName);
-      }
-      H5Tclose(datatype);
-      CloseH5S(memSpace, error, returnError);
-    }
+/**
+ * @brief Writes a string as a null terminated attribute of an object that is already open
+ * @param objectID The open object that is getting the attribute
+ * @param attributeName The name of the Attribute
+ * @param data The string to write as the attribute
+ * @return Standard HDF error conditions
+ */
+inline herr_t writeObjectStringAttribute(hid_t objectID, const std::string& attributeName, const std::string& data)
+{
+  H5SUPPORT_MUTEX_LOCK()
 
-    CloseH5S(dataspaceID, error, returnError);
+  herr_t error = 0;
+  herr_t returnError = 0;
+  hid_t attributeType = H5Tcopy(H5T_C_S1);
+  if(attributeType < 0)
+  {
+    return static_cast<herr_t>(attributeType);
+  }
+  returnError = H5Tset_size(attributeType, data.size() + 1);
+  if(returnError >= 0)
+  {
+    returnError = H5Tset_strpad(attributeType, H5T_STR_NULLTERM);
+  }
+  if(returnError >= 0)
+  {
+    hid_t attributeSpaceID = H5Screate(H5S_SCALAR);
+    if(attributeSpaceID >= 0)
+    {
+      returnError = writeObjectAttribute(objectID, attributeName, attributeType, attributeSpaceID, data.c_str());
+      CloseH5S(attributeSpaceID, error, returnError);
+    }
+    else
+    {
+      returnError = static_cast<herr_t>(attributeSpaceID);
+    }
+  }
+  else
+  {
+    std::cout << "Error creating the string type for Attribute '" << attributeName << "'" << std::endl;
   }
+  CloseH5T(attributeType, error, returnError);
   return returnError;
 }
 
@@ -1361,8 +1680,7 @@ template <typename T> inline herr_t writePointerAttribute(hid_t locationID, cons
   H5O_info_t objectInfo;
   herr_t error = 0;
   herr_t returnError = 0;
-  T test = 0x00;
-  hid_t dataType = HDFTypeForPrimitive(test);
+  hid_t dataType = H5TypeTraits<T>::type();
   if(dataType == -1)
   {
     std::cout << "dataType was unknown" << std::endl;
@@ -1408,6 +1726,7 @@ template <typename T> inline herr_t writePointerAttribute(hid_t locationID, cons
       {
         /* Write the attribute data. */
         error = H5Awrite(attributeID, dataType, data);
+        H5SUPPORT_INSTRUMENT_BYTES(error, H5Instrumentation::dataspaceBytes(dataspaceID, dataType))
         if(error < 0)
         {
           std::cout << "Error Writing Attribute" << std::endl;
@@ -1533,6 +1852,7 @@ inline herr_t writeStringAttribute(hid_t locationID, const std::string& objectNa
                 if(attributeID >= 0)
                 {
                   error = H5Awrite(attributeID, attributeType, data);
+                  H5SUPPORT_INSTRUMENT_BYTES(error, H5Instrumentation::dataspaceBytes(attributeSpaceID, attributeType))
                   if(error < 0)
                   {
                     std::cout << "Error Writing String attribute." << std::endl;
@@ -1590,16 +1910,36 @@ inline herr_t writeStringAttributes(hid_t locationID, const std::string& objectN
 {
   H5SUPPORT_MUTEX_LOCK()
 
-  herr_t error = 0;
+  H5O_info_t objectInfo{};
+  herr_t error = H5Oget_info_by_name(locationID, objectName.c_str(), &objectInfo, H5P_DEFAULT);
+  if(error < 0)
+  {
+    std::cout << "Error getting object info at locationID (" << locationID << ") with object name (" << objectName << ")" << std::endl;
+    return error;
+  }
+  /* Open the object once for the whole set */
+  hid_t objectID = openId(locationID, objectName, objectInfo.type);
+  if(objectID < 0)
+  {
+    std::cout << "Error opening Object for Attribute operations." << std::endl;
+    return static_cast<herr_t>(objectID);
+  }
+  herr_t returnError = 0;
   for(const auto& attribute : attributes)
   {
-    error = writeStringAttribute(locationID, objectName, attribute.first, attribute.second);
-    if(error < 0)
+    returnError = writeObjectStringAttribute(objectID, attribute.first, attribute.second);
+    if(returnError < 0)
     {
-      return error;
+      break;
     }
   }
-  return error;
+  error = closeId(objectID, objectInfo.type);
+  if(error < 0)
+  {
+    std::cout << "Error Closing Object Id" << std::endl;
+    returnError = error;
+  }
+  return returnError;
 }
 
 /**
@@ -1610,7 +1950,7 @@ inline herr_t writeStringAttributes(hid_t locationID, const std::string& objectN
  */
 inline hsize_t getNumberOfElements(hid_t locationID, const std::string& datasetName)
 {
-  H5SUPPORT_MUTEX_LOCK()
+  H5SUPPORT_MUTEX_LOCK_SHARED()
 
   hid_t datasetID;
   herr_t error = 0;
@@ -1678,7 +2018,7 @@ template <typename T> inline herr_t writeScalarAttribute(hid_t locationID, const
   herr_t returnError = 0;
   hsize_t dims = 1;
   int32_t rank = 1;
-  hid_t dataType = HDFTypeForPrimitive(data);
+  hid_t dataType = H5TypeTraits<T>::type();
   if(dataType == -1)
   {
     return -1;
@@ -1724,6 +2064,7 @@ template <typename T> inline herr_t writeScalarAttribute(hid_t locationID, const
       {
         /* Write the attribute data. */
         error = H5Awrite(attributeID, dataType, &data);
+        H5SUPPORT_INSTRUMENT_BYTES(error, sizeof(data))
         if(error < 0)
         {
           std::cout << "Error Writing Attribute" << std::endl;
@@ -1770,14 +2111,13 @@ template <typename T> inline herr_t writeScalarAttribute(hid_t locationID, const
  */
 template <typename T> inline herr_t readPointerDataset(hid_t locationID, const std::string& datasetName, T* data)
 {
-  H5SUPPORT_MUTEX_LOCK()
+  H5SUPPORT_MUTEX_LOCK_SHARED()
 
   hid_t datasetID;
   herr_t error = 0;
   herr_t returnError = 0;
   hid_t dataType = 0;
-  T test = 0x00;
-  dataType = HDFTypeForPrimitive(test);
+  dataType = H5TypeTraits<T>::type();
   if(dataType == -1)
   {
     std::cout << "dataType was not supported." << std::endl;
@@ -1802,6 +2142,7 @@ template <typename T> inline herr_t readPointerDataset(hid_t locationID, const s
   if(datasetID >= 0)
   {
     error = H5Dread(datasetID, dataType, H5S_ALL, H5S_ALL, H5P_DEFAULT, data);
+    H5SUPPORT_INSTRUMENT_BYTES(error, H5Instrumentation::datasetBytes(datasetID, dataType))
     if(error < 0)
     {
       std::cout << "Error Reading Data." << std::endl;
@@ -1817,6 +2158,142 @@ template <typename T> inline herr_t readPointerDataset(hid_t locationID, const s
   return returnError;
 }
 
+/**
+ * @brief Reads the whole of an already open dataset into storage holding numElements
+ * elements. The caller holds the lock and closes the dataset.
+ * @param datasetID The open dataset
+ * @param datasetName The name of the dataset, used for error messages
+ * @param data The pointer to store the data into
+ * @param numElements The number of elements in the dataset
+ * @return Standard HDF error condition
+ */
+template <typename T> inline herr_t readOpenDataset(hid_t datasetID, const std::string& datasetName, T* data, hsize_t numElements)
+{
+  hid_t dataType = H5TypeTraits<T>::type();
+  if(dataType == -1)
+  {
+    std::cout << "dataType was not supported." << std::endl;
+    return -10;
+  }
+  if(nullptr == data && numElements > 0)
+  {
+    std::cout << "The Pointer to hold the data is nullptr. This is NOT allowed." << std::endl;
+    return -3;
+  }
+  herr_t error = H5Dread(datasetID, dataType, H5S_ALL, H5S_ALL, H5P_DEFAULT, data);
+  if(error < 0)
+  {
+    std::cout << "Error Reading Data.'" << datasetName << "'" << std::endl;
+  }
+  return error;
+}
+
+/**
+ * @brief Reads data from the HDF5 File into caller owned storage after checking that the
+ * storage is large enough. Use getNumberOfElements() to size the storage first.
+ * @param locationID The parent location that contains the dataset to read
+ * @param datasetName The name of the dataset to read
+ * @param data The pointer to store the data into
+ * @param numElements The number of elements data has room for
+ * @return Standard HDF error condition. -4 if the dataset holds more than numElements elements
+ */
+template <typename T> inline herr_t readPointerDataset(hid_t locationID, const std::string& datasetName, T* data, hsize_t numElements)
+{
+  H5SUPPORT_MUTEX_LOCK_SHARED()
+
+  hid_t datasetID = H5Dopen(locationID, datasetName.c_str(), H5P_DEFAULT);
+  if(datasetID < 0)
+  {
+    std::cout << "H5Lite.h::readPointerDataset(" << __LINE__ << ") Error opening Dataset at locationID (" << locationID << ") with object name (" << datasetName << ")" << std::endl;
+    return -1;
+  }
+  hid_t dataspaceID = H5Dget_space(datasetID);
+  hssize_t datasetElements = (dataspaceID < 0) ? -1 : H5Sget_simple_extent_npoints(dataspaceID);
+  if(dataspaceID >= 0)
+  {
+    H5Sclose(dataspaceID);
+  }
+  herr_t returnError = 0;
+  if(datasetElements < 0)
+  {
+    std::cout << "Error Opening SpaceID" << std::endl;
+    returnError = -1;
+  }
+  else if(static_cast<hsize_t>(datasetElements) > numElements)
+  {
+    std::cout << "H5Lite.h::readPointerDataset(" << __LINE__ << ") Dataset '" << datasetName << "' holds " << datasetElements << " elements but the storage only has room for " << numElements
+              << std::endl;
+    returnError = -4;
+  }
+  else
+  {
+    returnError = readOpenDataset(datasetID, datasetName, data, static_cast<hsize_t>(datasetElements));
+    H5SUPPORT_INSTRUMENT_BYTES(returnError, datasetElements * sizeof(T))
+  }
+  herr_t error = H5Dclose(datasetID);
+  if(error < 0)
+  {
+    std::cout << "Error Closing Dataset id" << std::endl;
+    returnError = error;
+  }
+  return returnError;
+}
+
+/**
+ * @brief Reads data from the HDF5 File into a newly allocated array. The array is
+ * allocated with new T[] so trivial types are not zero filled before H5Dread writes them.
+ * @param locationID The parent location that contains the dataset to read
+ * @param datasetName The name of the dataset to read
+ * @param data Receives the array. It is reset if the read fails
+ * @param numElements Receives the number of elements in the array
+ * @return Standard HDF error condition
+ */
+template <typename T> inline herr_t readUniquePtrDataset(hid_t locationID, const std::string& datasetName, std::unique_ptr<T[]>& data, hsize_t& numElements)
+{
+  H5SUPPORT_MUTEX_LOCK_SHARED()
+
+  numElements = 0;
+  data.reset();
+  hid_t datasetID = H5Dopen(locationID, datasetName.c_str(), H5P_DEFAULT);
+  if(datasetID < 0)
+  {
+    std::cout << "H5Lite.h::readUniquePtrDataset(" << __LINE__ << ") Error opening Dataset at locationID (" << locationID << ") with object name (" << datasetName << ")" << std::endl;
+    return -1;
+  }
+  hid_t dataspaceID = H5Dget_space(datasetID);
+  hssize_t datasetElements = (dataspaceID < 0) ? -1 : H5Sget_simple_extent_npoints(dataspaceID);
+  if(dataspaceID >= 0)
+  {
+    H5Sclose(dataspaceID);
+  }
+  herr_t returnError = 0;
+  if(datasetElements < 0)
+  {
+    std::cout << "Error Opening SpaceID" << std::endl;
+    returnError = -1;
+  }
+  else
+  {
+    std::unique_ptr<T[]> buffer(new T[static_cast<size_t>(datasetElements)]);
+    returnError = readOpenDataset(datasetID, datasetName, buffer.get(), static_cast<hsize_t>(datasetElements));
+    H5SUPPORT_INSTRUMENT_BYTES(returnError, datasetElements * sizeof(T))
+    if(returnError >= 0)
+    {
+      data = std::move(buffer);
+      numElements = static_cast<hsize_t>(datasetElements);
+    }
+  }
+  herr_t error = H5Dclose(datasetID);
+  if(error < 0)
+  {
+    std::cout << "Error Closing Dataset id" << std::endl;
+    data.reset();
+    numElements = 0;
+    returnError = error;
+  }
+  return returnError;
+}
+
 /**
  * @brief Reads data from the HDF5 File into an std::vector<T> object. If the dataset
  * is very large this can be an expensive method to use. It is here for convenience
@@ -1825,20 +2302,20 @@ template <typename T> inline herr_t readPointerDataset(hid_t locationID, const s
  * @param datasetName The name of the dataset to read
  * @param data A std::vector<T>. Note the vector WILL be resized to fit the data.
  * The best idea is to just allocate the vector but not to size it. The method
- * will size it for you.
+ * will size it for you. Use an UninitializedVector (H5DefaultInitAllocator.h) to skip
+ * zero filling the vector before it is overwritten.
  * @return Standard HDF error condition
  */
-template <typename T> inline herr_t readVectorDataset(hid_t locationID, const std::string& datasetName, std::vector<T>& data)
+template <typename T, typename Allocator> inline herr_t readVectorDataset(hid_t locationID, const std::string& datasetName, std::vector<T, Allocator>& data)
 {
-  H5SUPPORT_MUTEX_LOCK()
+  H5SUPPORT_MUTEX_LOCK_SHARED()
 
   hid_t datasetID;
   herr_t error = 0;
   herr_t returnError = 0;
   hid_t spaceId;
   hid_t dataType;
-  T test = static_cast<T>(0x00);
-  dataType = HDFTypeForPrimitive(test);
+  dataType = H5TypeTraits<T>::type();
   if(dataType == -1)
   {
     return -1;
@@ -1864,6 +2341,7 @@ template <typename T> inline herr_t readVectorDataset(hid_t locationID, const st
         // Resize the vector
         data.resize(numElements);
         error = H5Dread(datasetID, dataType, H5S_ALL, H5S_ALL, H5P_DEFAULT, data.data());
+        H5SUPPORT_INSTRUMENT_BYTES(error, numElements * sizeof(T))
         if(error < 0)
         {
           std::cout << "Error Reading Data.'" << datasetName << "'" << std::endl;
@@ -1892,6 +2370,100 @@ template <typename T> inline herr_t readVectorDataset(hid_t locationID, const st
   return returnError;
 }
 
+/**
+ * @brief Reads a hyperslab of a dataset into a pre-allocated pointer. Only the selected
+ * region is read from the file. The data is stored contiguously in C order and must have
+ * room for prod(count[i] * block[i]) elements.
+ * @param locationID The parent location that contains the dataset to read
+ * @param datasetName The name of the dataset to read
+ * @param rank The number of dimensions. Must match the rank of the dataset
+ * @param offset The starting index of the slab in each dimension
+ * @param count The number of blocks to read in each dimension
+ * @param stride The distance between the start of consecutive blocks in each dimension. nullptr means 1
+ * @param block The size of a block in each dimension. nullptr means 1
+ * @param data The pointer to store the data into
+ * @return Standard HDF error condition
+ */
+template <typename T>
+inline herr_t readPointerDatasetSlab(hid_t locationID, const std::string& datasetName, int32_t rank, const hsize_t* offset, const hsize_t* count, const hsize_t* stride, const hsize_t* block, T* data)
+{
+  H5SUPPORT_MUTEX_LOCK_SHARED()
+
+  herr_t error = 0;
+  herr_t returnError = 0;
+  hid_t dataType = H5TypeTraits<T>::type();
+  if(dataType == -1)
+  {
+    std::cout << "dataType was not supported." << std::endl;
+    return -10;
+  }
+  if(nullptr == data)
+  {
+    std::cout << "The Pointer to hold the data is nullptr. This is NOT allowed." << std::endl;
+    return -3;
+  }
+  hid_t datasetID = H5Dopen(locationID, datasetName.c_str(), H5P_DEFAULT);
+  if(datasetID < 0)
+  {
+    std::cout << "H5Lite.h::readPointerDatasetSlab(" << __LINE__ << ") Error opening Dataset at locationID (" << locationID << ") with object name (" << datasetName << ")" << std::endl;
+    return -1;
+  }
+  hid_t fileSpaceID = -1;
+  hid_t memSpaceID = -1;
+  error = selectDatasetSlab(datasetID, rank, offset, count, stride, block, fileSpaceID, memSpaceID);
+  if(error >= 0)
+  {
+    error = H5Dread(datasetID, dataType, memSpaceID, fileSpaceID, H5P_DEFAULT, data);
+    H5SUPPORT_INSTRUMENT_BYTES(error, H5Instrumentation::dataspaceBytes(memSpaceID, dataType))
+    if(error < 0)
+    {
+      std::cout << "Error Reading Slab of '" << datasetName << "'" << std::endl;
+      returnError = error;
+    }
+    H5Sclose(memSpaceID);
+    H5Sclose(fileSpaceID);
+  }
+  else
+  {
+    returnError = error;
+  }
+  error = H5Dclose(datasetID);
+  if(error < 0)
+  {
+    std::cout << "Error Closing Dataset id" << std::endl;
+    returnError = error;
+  }
+  return returnError;
+}
+
+/**
+ * @brief Reads a hyperslab of a dataset into a std::vector. The rank of the slab is
+ * offset.size(). Empty stride or block vectors mean 1 in every dimension.
+ * @param locationID The parent location that contains the dataset to read
+ * @param datasetName The name of the dataset to read
+ * @param offset The starting index of the slab in each dimension
+ * @param count The number of blocks to read in each dimension
+ * @param data The vector WILL be resized to prod(count[i] * block[i]) elements
+ * @param stride The distance between the start of consecutive blocks in each dimension
+ * @param block The size of a block in each dimension
+ * @return Standard HDF error condition
+ */
+template <typename T, typename Allocator>
+inline herr_t readVectorDatasetSlab(hid_t locationID, const std::string& datasetName, const std::vector<hsize_t>& offset, const std::vector<hsize_t>& count, std::vector<T, Allocator>& data,
+                                    const std::vector<hsize_t>& stride = {}, const std::vector<hsize_t>& block = {})
+{
+  if(count.size() != offset.size() || (!stride.empty() && stride.size() != offset.size()) || (!block.empty() && block.size() != offset.size()))
+  {
+    std::cout << "H5Lite.h::readVectorDatasetSlab(" << __LINE__ << ") offset, count, stride and block must have the same size" << std::endl;
+    return -3;
+  }
+  hsize_t numElements = std::accumulate(count.cbegin(), count.cend(), static_cast<hsize_t>(1), std::multiplies<hsize_t>());
+  numElements = std::accumulate(block.cbegin(), block.cend(), numElements, std::multiplies<hsize_t>());
+  data.resize(numElements);
+  return readPointerDatasetSlab(locationID, datasetName, static_cast<int32_t>(offset.size()), offset.data(), count.data(), stride.empty() ? nullptr : stride.data(), block.empty() ? nullptr : block.data(),
+                                data.data());
+}
+
 /**
  * @brief Reads a dataset that consists of a single scalar value
  * @param locationID The HDF5 file or group id
@@ -1901,14 +2473,14 @@ template <typename T> inline herr_t readVectorDataset(hid_t locationID, const st
  */
 template <typename T> inline herr_t readScalarDataset(hid_t locationID, const std::string& datasetName, T& data)
 {
-  H5SUPPORT_MUTEX_LOCK()
+  H5SUPPORT_MUTEX_LOCK_SHARED()
 
   hid_t datasetID = 0;
   herr_t error = 0;
   herr_t returnError = 0;
   hid_t spaceId = 0;
 
-  hid_t dataType = HDFTypeForPrimitive(data);
+  hid_t dataType = H5TypeTraits<T>::type();
   if(dataType == -1)
   {
     return -1;
@@ -1926,6 +2498,7 @@ template <typename T> inline herr_t readScalarDataset(hid_t locationID, const st
     if(spaceId > 0)
     {
       error = H5Dread(datasetID, dataType, H5S_ALL, H5S_ALL, H5P_DEFAULT, &data);
+      H5SUPPORT_INSTRUMENT_BYTES(error, sizeof(data))
       if(error < 0)
       {
         std::cout << "Error Reading Data at locationID (" << locationID << ") with object name (" << datasetName << ")" << std::endl;
@@ -1962,7 +2535,7 @@ template <typename T> inline herr_t readScalarDataset(hid_t locationID, const st
  */
 inline herr_t readVectorOfStringDataset(hid_t locationID, const std::string& datasetName, std::vector<std::string>& data)
 {
-  H5SUPPORT_MUTEX_LOCK()
+  H5SUPPORT_MUTEX_LOCK_SHARED()
 
   hid_t datasetID; // dataset id
   hid_t typeID;    // type id
@@ -2052,7 +2625,7 @@ inline herr_t readVectorOfStringDataset(hid_t locationID, const std::string& dat
  */
 inline herr_t readStringDataset(hid_t locationID, const std::string& datasetName, std::string& data)
 {
-  H5SUPPORT_MUTEX_LOCK()
+  H5SUPPORT_MUTEX_LOCK_SHARED()
 
   hid_t datasetID; // dataset id
   hid_t typeID;    // type id
@@ -2093,6 +2666,7 @@ inline herr_t readStringDataset(hid_t locationID, const std::string& datasetName
       size = H5Dget_storage_size(datasetID);
       std::vector<char> buffer(static_cast<size_t>(size + 1), 0x00); // Allocate and Zero and array
       error = H5Dread(datasetID, typeID, H5S_ALL, H5S_ALL, H5P_DEFAULT, buffer.data());
+      H5SUPPORT_INSTRUMENT_BYTES(error, buffer.size())
       if(error < 0)
       {
         std::cout << "Error Reading string dataset." << std::endl;
@@ -2119,7 +2693,7 @@ inline herr_t readStringDataset(hid_t locationID, const std::string& datasetName
  */
 inline herr_t readStringDataset(hid_t locationID, const std::string& datasetName, char* data)
 {
-  H5SUPPORT_MUTEX_LOCK()
+  H5SUPPORT_MUTEX_LOCK_SHARED()
 
   hid_t datasetID; // dataset id
   hid_t typeID;    // type id
@@ -2136,6 +2710,7 @@ inline herr_t readStringDataset(hid_t locationID, const std::string& datasetName
   if(typeID >= 0)
   {
     error = H5Dread(datasetID, typeID, H5S_ALL, H5S_ALL, H5P_DEFAULT, data);
+    H5SUPPORT_INSTRUMENT_BYTES(error, H5Instrumentation::datasetBytes(datasetID, typeID))
     if(error < 0)
     {
       std::cout << "Error Reading string dataset." << std::endl;
@@ -2163,7 +2738,7 @@ inline herr_t readStringDataset(hid_t locationID, const std::string& datasetName
  */
 inline herr_t getAttributeInfo(hid_t locationID, const std::string& objectName, const std::string& attributeName, std::vector<hsize_t>& dims, H5T_class_t& typeClass, size_t& typeSize, hid_t& typeID)
 {
-  H5SUPPORT_MUTEX_LOCK()
+  H5SUPPORT_MUTEX_LOCK_SHARED()
 
   /* identifiers */
   hid_t objectID;
@@ -2250,12 +2825,13 @@ inline herr_t getAttributeInfo(hid_t locationID, const std::string& objectName,
  * @param locationID The Parent object that holds the object to which you want to read an attribute
  * @param objectName The name of the object to which the attribute is to be read
  * @param attributeName The name of the Attribute to read
- * @param data The memory to store the data
+ * @param data The memory to store the data. Use an UninitializedVector (H5DefaultInitAllocator.h)
+ * to skip zero filling the vector before it is overwritten.
  * @return Standard HDF Error condition
  */
-template <typename T> inline herr_t readVectorAttribute(hid_t locationID, const std::string& objectName, const std::string& attributeName, std::vector<T>& data)
+template <typename T, typename Allocator> inline herr_t readVectorAttribute(hid_t locationID, const std::string& objectName, const std::string& attributeName, std::vector<T, Allocator>& data)
 {
-  H5SUPPORT_MUTEX_LOCK()
+  H5SUPPORT_MUTEX_LOCK_SHARED()
 
   /* identifiers */
   hid_t objectID;
@@ -2264,8 +2840,7 @@ template <typename T> inline herr_t readVectorAttribute(hid_t locationID, const
   herr_t returnError = 0;
   hid_t attributeID;
   hid_t typeID;
-  T test = 0x00;
-  hid_t dataType = HDFTypeForPrimitive(test);
+  hid_t dataType = H5TypeTraits<T>::type();
   if(dataType == -1)
   {
     return -1;
@@ -2293,6 +2868,7 @@ template <typename T> inline herr_t readVectorAttribute(hid_t locationID, const
       // std::cout << "    Vector Attribute has " << numElements << " elements." << std::endl;
       data.resize(numElements);
       error = H5Aread(attributeID, dataType, data.data());
+      H5SUPPORT_INSTRUMENT_BYTES(error, data.size() * sizeof(T))
       if(error < 0)
       {
         std::cout << "Error Reading Attribute." << error << std::endl;
@@ -2329,7 +2905,7 @@ template <typename T> inline herr_t readVectorAttribute(hid_t locationID, const
  */
 template <typename T> inline herr_t readScalarAttribute(hid_t locationID, const std::string& objectName, const std::string& attributeName, T& data)
 {
-  H5SUPPORT_MUTEX_LOCK()
+  H5SUPPORT_MUTEX_LOCK_SHARED()
 
   /* identifiers */
   hid_t objectID;
@@ -2337,8 +2913,7 @@ template <typename T> inline herr_t readScalarAttribute(hid_t locationID, const
   herr_t error = 0;
   herr_t returnError = 0;
   hid_t attributeID;
-  T test = 0x00;
-  hid_t dataType = HDFTypeForPrimitive(test);
+  hid_t dataType = H5TypeTraits<T>::type();
   if(dataType == -1)
   {
     return -1;
@@ -2358,6 +2933,7 @@ template <typename T> inline herr_t readScalarAttribute(hid_t locationID, const
     if(attributeID >= 0)
     {
       error = H5Aread(attributeID, dataType, &data);
+      H5SUPPORT_INSTRUMENT_BYTES(error, sizeof(data))
       if(error < 0)
       {
         std::cout << "Error Reading Attribute." << std::endl;
@@ -2394,7 +2970,7 @@ template <typename T> inline herr_t readScalarAttribute(hid_t locationID, const
  */
 template <typename T> inline herr_t readPointerAttribute(hid_t locationID, const std::string& objectName, const std::string& attributeName, T* data)
 {
-  H5SUPPORT_MUTEX_LOCK()
+  H5SUPPORT_MUTEX_LOCK_SHARED()
 
   /* identifiers */
   hid_t objectID;
@@ -2402,8 +2978,7 @@ template <typename T> inline herr_t readPointerAttribute(hid_t locationID, const
   herr_t error = 0;
   herr_t returnError = 0;
   hid_t attributeID;
-  T test = 0x00;
-  hid_t dataType = HDFTypeForPrimitive(test);
+  hid_t dataType = H5TypeTraits<T>::type();
   if(dataType == -1)
   {
     return -1;
@@ -2423,6 +2998,7 @@ template <typename T> inline herr_t readPointerAttribute(hid_t locationID, const
     if(attributeID >= 0)
     {
       error = H5Aread(attributeID, dataType, data);
+      H5SUPPORT_INSTRUMENT_BYTES(error, H5Instrumentation::attributeBytes(attributeID, dataType))
       if(error < 0)
       {
         std::cout << "Error Reading Attribute." << error << std::endl;
@@ -2459,7 +3035,7 @@ template <typename T> inline herr_t readPointerAttribute(hid_t locationID, const
  */
 inline herr_t readStringAttribute(hid_t locationID, const std::string& objectName, const std::string& attributeName, std::string& data)
 {
-  H5SUPPORT_MUTEX_LOCK()
+  H5SUPPORT_MUTEX_LOCK_SHARED()
 
   /* identifiers */
   hid_t objectID;
@@ -2503,6 +3079,7 @@ inline herr_t readStringAttribute(hid_t locationID, const std::string& objectNam
       if(attributeType >= 0)
       {
         error = H5Aread(attributeID, attributeType, attributeOutput.data());
+        H5SUPPORT_INSTRUMENT_BYTES(error, attributeOutput.size())
         if(error < 0)
         {
           std::cout << "Error Reading Attribute." << std::endl;
@@ -2545,7 +3122,7 @@ inline herr_t readStringAttribute(hid_t locationID, const std::string& objectNam
  */
 inline herr_t readStringAttribute(hid_t locationID, const std::string& objectName, const std::string& attributeName, char* data)
 {
-  H5SUPPORT_MUTEX_LOCK()
+  H5SUPPORT_MUTEX_LOCK_SHARED()
 
   /* identifiers */
   hid_t objectID;
@@ -2575,6 +3152,7 @@ inline herr_t readStringAttribute(hid_t locationID, const std::string& objectNam
       if(attributeType >= 0)
       {
         error = H5Aread(attributeID, attributeType, data);
+        H5SUPPORT_INSTRUMENT_BYTES(error, H5Instrumentation::attributeBytes(attributeID, attributeType))
         if(error < 0)
         {
           std::cout << "Error Reading Attribute." << std::endl;
@@ -2608,7 +3186,7 @@ inline herr_t readStringAttribute(hid_t locationID, const std::string& objectNam
  */
 inline herr_t getAttributeNDims(hid_t locationID, const std::string& objectName, const std::string& attributeName, hid_t& rank)
 {
-  H5SUPPORT_MUTEX_LOCK()
+  H5SUPPORT_MUTEX_LOCK_SHARED()
 
   /* identifiers */
   hid_t objectID;
@@ -2662,7 +3240,7 @@ inline herr_t getAttributeNDims(hid_t locationID, const std::string& objectName,
  */
 inline herr_t getDatasetNDims(hid_t locationID, const std::string& datasetName, hid_t& rank)
 {
-  H5SUPPORT_MUTEX_LOCK()
+  H5SUPPORT_MUTEX_LOCK_SHARED()
 
   hid_t datasetID;
   hid_t dataspaceID;
@@ -2715,7 +3293,7 @@ inline herr_t getDatasetNDims(hid_t locationID, const std::string& datasetName,
  */
 inline hid_t getDatasetType(hid_t locationID, const std::string& datasetName)
 {
-  H5SUPPORT_MUTEX_LOCK()
+  H5SUPPORT_MUTEX_LOCK_SHARED()
 
   herr_t error = 0;
   herr_t returnError = 0;
@@ -2747,7 +3325,7 @@ inline hid_t getDatasetType(hid_t locationID, const std::string& datasetName)
  */
 inline herr_t getDatasetInfo(hid_t locationID, const std::string& datasetName, std::vector<hsize_t>& dims, H5T_class_t& classType, size_t& sizeType)
 {
-  H5SUPPORT_MUTEX_LOCK()
+  H5SUPPORT_MUTEX_LOCK_SHARED()
 
   hid_t datasetID;
   hid_t typeID;
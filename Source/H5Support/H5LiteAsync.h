@@ -0,0 +1,152 @@
+/* ============================================================================
+ * Copyright (c) 2007-2019 BlueQuartz Software, LLC
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+ * contributors may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The code contained herein was partially funded by the followig contracts:
+ *    United States Air Force Prime Contract FA8650-04-C-5229
+ *    United States Air Force Prime Contract FA8650-15-D-5231
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#pragma once
+
+#include <future>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <hdf5.h>
+
+#include "H5Support/H5Lite.h"
+#include "H5Support/H5Support.h"
+#include "H5Support/H5TaskExecutor.h"
+
+#if defined(H5Support_NAMESPACE)
+namespace H5Support_NAMESPACE
+{
+#endif
+
+namespace H5Lite
+{
+/**
+ * @brief Asynchronous versions of the H5Lite read/write functions.
+ *
+ * Every call is queued onto a single, process wide I/O thread so the HDF5 library is
+ * only ever entered from that thread while the calling thread goes on computing. The
+ * returned future yields the same error code that the synchronous function returns.
+ *
+ * Any buffer handed to these functions by pointer or by reference must stay alive and
+ * untouched until the future is ready. Do not wait on one of these futures while holding
+ * the H5SupportMutex: the I/O thread needs that lock to make progress.
+ */
+namespace async
+{
+constexpr size_t k_IOQueueCapacity = 64;
+
+/**
+ * @brief Returns the executor that owns the dedicated HDF5 I/O thread
+ * @return
+ */
+inline H5TaskExecutor& ioExecutor()
+{
+  static H5TaskExecutor s_Executor(1, k_IOQueueCapacity);
+  return s_Executor;
+}
+
+/**
+ * @brief Runs an arbitrary callable on the I/O thread. Use this to group several
+ * HDF5 calls (open a group, write a few datasets, close the group) into one task.
+ * @param function The callable to run
+ * @return Future holding the return value of the callable
+ */
+template <typename Function> inline std::future<typename std::result_of<Function()>::type> run(Function&& function)
+{
+  return ioExecutor().submit(std::forward<Function>(function));
+}
+
+/**
+ * @brief Queues H5Lite::writePointerDataset onto the I/O thread
+ * @param locationID The hdf5 object id of the parent
+ * @param datasetName The name of the dataset to write to
+ * @param rank The number of dimensions
+ * @param dims The sizes of each dimension. These are copied before returning.
+ * @param data The data to be written. Must stay valid until the future is ready.
+ * @return Future holding the standard hdf5 error condition.
+ */
+template <typename T> inline std::future<herr_t> writePointerDataset(hid_t locationID, const std::string& datasetName, int32_t rank, const hsize_t* dims, const T* data)
+{
+  std::vector<hsize_t> dimsCopy(dims, dims + rank);
+  return run([locationID, datasetName, dimsCopy, data]() { return H5Lite::writePointerDataset(locationID, datasetName, static_cast<int32_t>(dimsCopy.size()), dimsCopy.data(), data); });
+}
+
+/**
+ * @brief Queues H5Lite::writeVectorDataset onto the I/O thread. The vector is taken by
+ * value so callers can std::move() their buffer in and forget about it.
+ * @param locationID The Parent location to store the data
+ * @param datasetName The name of the dataset
+ * @param dims The dimensions of the dataset
+ * @param data The data to write to the file
+ * @return Future holding the standard hdf5 error condition.
+ */
+template <typename T> inline std::future<herr_t> writeVectorDataset(hid_t locationID, const std::string& datasetName, const std::vector<hsize_t>& dims, std::vector<T> data)
+{
+  auto buffer = std::make_shared<std::vector<T>>(std::move(data));
+  return run([locationID, datasetName, dims, buffer]() { return H5Lite::writeVectorDataset(locationID, datasetName, dims, *buffer); });
+}
+
+/**
+ * @brief Queues H5Lite::readPointerDataset onto the I/O thread
+ * @param locationID The parent location that contains the dataset to read
+ * @param datasetName The name of the dataset to read
+ * @param data Preallocated destination. Must stay valid until the future is ready.
+ * @return Future holding the standard hdf5 error condition.
+ */
+template <typename T> inline std::future<herr_t> readPointerDataset(hid_t locationID, const std::string& datasetName, T* data)
+{
+  return run([locationID, datasetName, data]() { return H5Lite::readPointerDataset(locationID, datasetName, data); });
+}
+
+/**
+ * @brief Queues H5Lite::readVectorDataset onto the I/O thread
+ * @param locationID The parent location that contains the dataset to read
+ * @param datasetName The name of the dataset to read
+ * @param data Destination vector. It is resized on the I/O thread so it must not be
+ * touched until the future is ready.
+ * @return Future holding the standard hdf5 error condition.
+ */
+template <typename T, typename Allocator> inline std::future<herr_t> readVectorDataset(hid_t locationID, const std::string& datasetName, std::vector<T, Allocator>& data)
+{
+  std::vector<T, Allocator>* destination = &data;
+  return run([locationID, datasetName, destination]() { return H5Lite::readVectorDataset(locationID, datasetName, *destination); });
+}
+
+} // namespace async
+} // namespace H5Lite
+
+#if defined(H5Support_NAMESPACE)
+}
+#endif
@@ -0,0 +1,317 @@
+/* ============================================================================
+ * Copyright (c) 2007-2019 BlueQuartz Software, LLC
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+ * contributors may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The code contained herein was partially funded by the followig contracts:
+ *    United States Air Force Prime Contract FA8650-04-C-5229
+ *    United States Air Force Prime Contract FA8650-15-D-5231
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#pragma once
+
+#include <cstring>
+#include <iostream>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <hdf5.h>
+
+#include "H5Support/H5Lite.h"
+#include "H5Support/H5Macros.h"
+#include "H5Support/H5Support.h"
+
+#if defined(H5Support_NAMESPACE)
+namespace H5Support_NAMESPACE
+{
+#endif
+
+/**
+ * @brief One attribute as read by H5Lite::readAllAttributes(). Integers are widened to
+ * 64 bit (signed or unsigned following the file type), floating point values to double
+ * and strings, fixed or variable length, to std::string. Attributes of any other class
+ * only carry their class, size and dimensions.
+ */
+struct H5AttributeValue
+{
+  H5T_class_t classType = H5T_NO_CLASS;
+  size_t typeSize = 0;
+  bool isSigned = false;
+  std::vector<hsize_t> dims;
+  std::vector<int64_t> intValues;
+  std::vector<uint64_t> uintValues;
+  std::vector<double> floatValues;
+  std::vector<std::string> stringValues;
+
+  /**
+   * @brief Returns the number of stored elements, 1 for a scalar dataspace
+   * @return
+   */
+  hsize_t getNumberOfElements() const
+  {
+    hsize_t numElements = 1;
+    for(hsize_t dim : dims)
+    {
+      numElements *= dim;
+    }
+    return numElements;
+  }
+
+  /**
+   * @brief Returns the numeric values converted to T. Empty for non numeric attributes.
+   * @return
+   */
+  template <typename T> std::vector<T> getValues() const
+  {
+    if(classType == H5T_FLOAT)
+    {
+      return std::vector<T>(floatValues.cbegin(), floatValues.cend());
+    }
+    if(isSigned)
+    {
+      return std::vector<T>(intValues.cbegin(), intValues.cend());
+    }
+    return std::vector<T>(uintValues.cbegin(), uintValues.cend());
+  }
+
+  /**
+   * @brief Returns the first numeric value converted to T, or T{} if there is none
+   * @return
+   */
+  template <typename T> T getValue() const
+  {
+    std::vector<T> values = getValues<T>();
+    return values.empty() ? T{} : values.front();
+  }
+
+  /**
+   * @brief Returns the first string value, or an empty string
+   * @return
+   */
+  std::string getString() const
+  {
+    return stringValues.empty() ? std::string() : stringValues.front();
+  }
+};
+
+using H5AttributeMap = std::map<std::string, H5AttributeValue>;
+
+namespace H5Lite
+{
+struct ReadAllAttributesContext
+{
+  H5AttributeMap* attributes = nullptr;
+  size_t numBytes = 0;
+  herr_t error = 0;
+};
+
+/**
+ * @brief Reads the values of one open attribute into value, which already holds the class and size
+ * @return Standard HDF5 error condition
+ */
+inline herr_t readAttributeValues(hid_t attributeID, hid_t typeID, hsize_t numElements, H5AttributeValue& value, size_t& numBytes)
+{
+  herr_t error = 0;
+  herr_t returnError = 0;
+  if(value.classType == H5T_INTEGER)
+  {
+    value.isSigned = H5Tget_sign(typeID) != H5T_SGN_NONE;
+    if(value.isSigned)
+    {
+      value.intValues.resize(numElements);
+      returnError = H5Aread(attributeID, H5T_NATIVE_INT64, value.intValues.data());
+    }
+    else
+    {
+      value.uintValues.resize(numElements);
+      returnError = H5Aread(attributeID, H5T_NATIVE_UINT64, value.uintValues.data());
+    }
+    numBytes += numElements * sizeof(int64_t);
+  }
+  else if(value.classType == H5T_FLOAT)
+  {
+    value.isSigned = true;
+    value.floatValues.resize(numElements);
+    returnError = H5Aread(attributeID, H5T_NATIVE_DOUBLE, value.floatValues.data());
+    numBytes += numElements * sizeof(double);
+  }
+  else if(value.classType == H5T_STRING && H5Tis_variable_str(typeID) > 0)
+  {
+    hid_t memoryTypeID = H5Tcopy(H5T_C_S1);
+    H5Tset_size(memoryTypeID, H5T_VARIABLE);
+    std::vector<char*> strings(numElements, nullptr);
+    returnError = H5Aread(attributeID, memoryTypeID, strings.data());
+    if(returnError >= 0)
+    {
+      for(char* string : strings)
+      {
+        value.stringValues.emplace_back(string == nullptr ? "" : string);
+        numBytes += value.stringValues.back().size();
+      }
+      hid_t dataspaceID = H5Aget_space(attributeID);
+      H5Dvlen_reclaim(memoryTypeID, dataspaceID, H5P_DEFAULT, strings.data());
+      CloseH5S(dataspaceID, error, returnError);
+    }
+    CloseH5T(memoryTypeID, error, returnError);
+  }
+  else if(value.classType == H5T_STRING)
+  {
+    std::vector<char> buffer(numElements * value.typeSize + 1, 0);
+    returnError = H5Aread(attributeID, typeID, buffer.data());
+    if(returnError >= 0)
+    {
+      for(hsize_t i = 0; i < numElements; ++i)
+      {
+        const char* string = buffer.data() + i * value.typeSize;
+        value.stringValues.emplace_back(string, strnlen(string, value.typeSize));
+      }
+    }
+    numBytes += buffer.size() - 1;
+  }
+  if(returnError < 0)
+  {
+    std::cout << "Error Reading Attribute." << std::endl;
+  }
+  return returnError;
+}
+
+/**
+ * @brief H5Aiterate2 callback of readAllAttributes()
+ */
+inline herr_t readAllAttributesOperator(hid_t locationID, const char* name, const H5A_info_t* /*info*/, void* opData)
+{
+  auto* context = static_cast<ReadAllAttributesContext*>(opData);
+  herr_t error = 0;
+  herr_t returnError = 0;
+  hid_t attributeID = H5Aopen(locationID, name, H5P_DEFAULT);
+  if(attributeID < 0)
+  {
+    context->error = static_cast<herr_t>(attributeID);
+    return -1;
+  }
+
+  H5AttributeValue value;
+  hid_t typeID = H5Aget_type(attributeID);
+  hid_t dataspaceID = H5Aget_space(attributeID);
+  if(typeID >= 0 && dataspaceID >= 0)
+  {
+    value.classType = H5Tget_class(typeID);
+    value.typeSize = H5Tget_size(typeID);
+    int rank = H5Sget_simple_extent_ndims(dataspaceID);
+    value.dims.resize(static_cast<size_t>(rank > 0 ? rank : 0));
+    H5Sget_simple_extent_dims(dataspaceID, value.dims.data(), nullptr);
+    hssize_t numElements = H5Sget_simple_extent_npoints(dataspaceID);
+    returnError = readAttributeValues(attributeID, typeID, static_cast<hsize_t>(numElements > 0 ? numElements : 0), value, context->numBytes);
+  }
+  else
+  {
+    returnError = -1;
+  }
+  if(dataspaceID >= 0)
+  {
+    CloseH5S(dataspaceID, error, returnError);
+  }
+  if(typeID >= 0)
+  {
+    CloseH5T(typeID, error, returnError);
+  }
+  CloseH5A(attributeID, error, returnError);
+
+  if(returnError < 0)
+  {
+    std::cout << "Error Reading Attribute '" << name << "'" << std::endl;
+    context->error = returnError;
+    return -1;
+  }
+  (*context->attributes)[name] = std::move(value);
+  return 0;
+}
+
+/**
+ * @brief Reads every attribute of an open object in one H5Aiterate2 pass. Each attribute is
+ * opened exactly once; its type and dimensions come from that same open handle.
+ * @param objectID The open object whose attributes are read
+ * @param attributes Receives the attributes by name. Existing entries are kept unless overwritten.
+ * @return Standard HDF5 error condition
+ */
+inline herr_t readAllAttributes(hid_t objectID, H5AttributeMap& attributes)
+{
+  H5SUPPORT_MUTEX_LOCK_SHARED()
+
+  ReadAllAttributesContext context;
+  context.attributes = &attributes;
+  hsize_t index = 0;
+  herr_t error = H5Aiterate2(objectID, H5_INDEX_NAME, H5_ITER_INC, &index, readAllAttributesOperator, &context);
+  H5SUPPORT_INSTRUMENT_BYTES(error, context.numBytes)
+  if(context.error < 0)
+  {
+    return context.error;
+  }
+  return error;
+}
+
+/**
+ * @brief Reads every attribute of an object, see readAllAttributes(hid_t, H5AttributeMap&)
+ * @param locationID The location to look for objectName
+ * @param objectName The object whose attributes are read
+ * @param attributes Receives the attributes by name. The map is cleared first.
+ * @return Standard HDF5 error condition
+ */
+inline herr_t readAllAttributes(hid_t locationID, const std::string& objectName, H5AttributeMap& attributes)
+{
+  H5SUPPORT_MUTEX_LOCK_SHARED()
+
+  attributes.clear();
+  H5O_info_t objectInfo{};
+  herr_t error = H5Oget_info_by_name(locationID, objectName.c_str(), &objectInfo, H5P_DEFAULT);
+  if(error < 0)
+  {
+    std::cout << "Error getting object info at locationID (" << locationID << ") with object name (" << objectName << ")" << std::endl;
+    return error;
+  }
+  hid_t objectID = openId(locationID, objectName, objectInfo.type);
+  if(objectID < 0)
+  {
+    std::cout << "Error opening Object for Attribute operations." << std::endl;
+    return static_cast<herr_t>(objectID);
+  }
+  herr_t returnError = readAllAttributes(objectID, attributes);
+  error = closeId(objectID, objectInfo.type);
+  if(error < 0)
+  {
+    std::cout << "Error Closing Object" << std::endl;
+    returnError = error;
+  }
+  return returnError;
+}
+} // namespace H5Lite
+
+#if defined(H5Support_NAMESPACE)
+}
+#endif
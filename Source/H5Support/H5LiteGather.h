@@ -0,0 +1,328 @@
+/* ============================================================================
+ * Copyright (c) 2007-2019 BlueQuartz Software, LLC
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+ * contributors may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The code contained herein was partially funded by the followig contracts:
+ *    United States Air Force Prime Contract FA8650-04-C-5229
+ *    United States Air Force Prime Contract FA8650-15-D-5231
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#pragma once
+
+#include <functional>
+#include <iostream>
+#include <numeric>
+#include <string>
+#include <vector>
+
+#include <hdf5.h>
+
+#include "H5Support/H5Instrumentation.h"
+#include "H5Support/H5Lite.h"
+#include "H5Support/H5Macros.h"
+#include "H5Support/H5Support.h"
+#include "H5Support/H5TypeTraits.h"
+
+#if defined(H5Support_NAMESPACE)
+namespace H5Support_NAMESPACE
+{
+#endif
+
+/**
+ * @brief The H5Hyperslab struct describes one region of a dataset in the terms of
+ * H5Sselect_hyperslab. Empty stride or block vectors mean 1 in every dimension.
+ */
+struct H5Hyperslab
+{
+  std::vector<hsize_t> offset;
+  std::vector<hsize_t> count;
+  std::vector<hsize_t> stride;
+  std::vector<hsize_t> block;
+
+  /**
+   * @brief Returns the number of elements the region covers on its own
+   * @return
+   */
+  hsize_t getNumberOfElements() const
+  {
+    hsize_t numElements = std::accumulate(count.cbegin(), count.cend(), static_cast<hsize_t>(1), std::multiplies<hsize_t>());
+    return std::accumulate(block.cbegin(), block.cend(), numElements, std::multiplies<hsize_t>());
+  }
+};
+
+namespace H5Lite
+{
+/**
+ * @brief Selects a list of elements of a dataset. The memory dataspace is a packed one
+ * dimensional array that receives the elements in the order they are listed.
+ * @param datasetID The dataset
+ * @param numPoints The number of elements
+ * @param coords numPoints * rank coordinates, one row of rank indices per element
+ * @param fileSpaceID Receives the file dataspace holding the point selection
+ * @param memSpaceID Receives the memory dataspace
+ * @return Standard hdf5 error condition.
+ */
+inline herr_t selectDatasetPoints(hid_t datasetID, size_t numPoints, const hsize_t* coords, hid_t& fileSpaceID, hid_t& memSpaceID)
+{
+  H5SUPPORT_MUTEX_LOCK_SHARED()
+
+  fileSpaceID = -1;
+  memSpaceID = -1;
+  if(nullptr == coords || numPoints == 0)
+  {
+    std::cout << "H5LiteGather.h::selectDatasetPoints(" << __LINE__ << ") At least one point must be given" << std::endl;
+    return -2;
+  }
+  hid_t dataspaceID = H5Dget_space(datasetID);
+  if(dataspaceID < 0)
+  {
+    std::cout << "H5LiteGather.h::selectDatasetPoints(" << __LINE__ << ") Error getting the dataspace of the dataset" << std::endl;
+    return static_cast<herr_t>(dataspaceID);
+  }
+  herr_t error = H5Sselect_elements(dataspaceID, H5S_SELECT_SET, numPoints, coords);
+  if(error < 0 || H5Sselect_valid(dataspaceID) <= 0)
+  {
+    std::cout << "H5LiteGather.h::selectDatasetPoints(" << __LINE__ << ") The points do not fit inside the dataset" << std::endl;
+    H5Sclose(dataspaceID);
+    return -4;
+  }
+  hsize_t memDims = static_cast<hsize_t>(numPoints);
+  memSpaceID = H5Screate_simple(1, &memDims, nullptr);
+  if(memSpaceID < 0)
+  {
+    std::cout << "H5LiteGather.h::selectDatasetPoints(" << __LINE__ << ") Error creating the memory dataspace" << std::endl;
+    H5Sclose(dataspaceID);
+    return static_cast<herr_t>(memSpaceID);
+  }
+  fileSpaceID = dataspaceID;
+  return 0;
+}
+
+/**
+ * @brief Selects the union of several hyperslabs of a dataset with H5S_SELECT_OR. The memory
+ * dataspace is a packed one dimensional array. HDF5 visits a union in C order of the dataset,
+ * not in the order the regions are listed, and elements covered by more than one region are
+ * selected once.
+ * @param datasetID The dataset
+ * @param regions The hyperslabs. Each must have the rank of the dataset.
+ * @param fileSpaceID Receives the file dataspace holding the union
+ * @param memSpaceID Receives the memory dataspace
+ * @return Standard hdf5 error condition.
+ */
+inline herr_t selectDatasetRegions(hid_t datasetID, const std::vector<H5Hyperslab>& regions, hid_t& fileSpaceID, hid_t& memSpaceID)
+{
+  H5SUPPORT_MUTEX_LOCK_SHARED()
+
+  fileSpaceID = -1;
+  memSpaceID = -1;
+  if(regions.empty())
+  {
+    std::cout << "H5LiteGather.h::selectDatasetRegions(" << __LINE__ << ") At least one region must be given" << std::endl;
+    return -2;
+  }
+  hid_t dataspaceID = H5Dget_space(datasetID);
+  if(dataspaceID < 0)
+  {
+    std::cout << "H5LiteGather.h::selectDatasetRegions(" << __LINE__ << ") Error getting the dataspace of the dataset" << std::endl;
+    return static_cast<herr_t>(dataspaceID);
+  }
+  size_t rank = static_cast<size_t>(H5Sget_simple_extent_ndims(dataspaceID));
+  herr_t error = 0;
+  for(size_t i = 0; i < regions.size() && error >= 0; ++i)
+  {
+    const H5Hyperslab& region = regions[i];
+    if(region.offset.size() != rank || region.count.size() != rank || (!region.stride.empty() && region.stride.size() != rank) || (!region.block.empty() && region.block.size() != rank))
+    {
+      std::cout << "H5LiteGather.h::selectDatasetRegions(" << __LINE__ << ") Region " << i << " does not match the rank of the dataset (" << rank << ")" << std::endl;
+      H5Sclose(dataspaceID);
+      return -3;
+    }
+    error = H5Sselect_hyperslab(dataspaceID, (i == 0) ? H5S_SELECT_SET : H5S_SELECT_OR, region.offset.data(), region.stride.empty() ? nullptr : region.stride.data(), region.count.data(),
+                                region.block.empty() ? nullptr : region.block.data());
+  }
+  if(error < 0 || H5Sselect_valid(dataspaceID) <= 0)
+  {
+    std::cout << "H5LiteGather.h::selectDatasetRegions(" << __LINE__ << ") The regions do not fit inside the dataset" << std::endl;
+    H5Sclose(dataspaceID);
+    return -4;
+  }
+  hsize_t memDims = static_cast<hsize_t>(H5Sget_select_npoints(dataspaceID));
+  memSpaceID = H5Screate_simple(1, &memDims, nullptr);
+  if(memSpaceID < 0)
+  {
+    std::cout << "H5LiteGather.h::selectDatasetRegions(" << __LINE__ << ") Error creating the memory dataspace" << std::endl;
+    H5Sclose(dataspaceID);
+    return static_cast<herr_t>(memSpaceID);
+  }
+  fileSpaceID = dataspaceID;
+  return 0;
+}
+
+/**
+ * @brief Opens a dataset, builds a selection with the given function and moves the whole
+ * selection with a single H5Dread into the buffer returned by getBuffer
+ * @param locationID The parent location that contains the dataset to read
+ * @param datasetName The name of the dataset to read
+ * @param dataType The memory type of the buffer
+ * @param select Builds the file and memory dataspaces for the open dataset
+ * @param getBuffer Receives the number of selected elements and returns the buffer to read into
+ * @return Standard hdf5 error condition.
+ */
+inline herr_t gatherDataset(hid_t locationID, const std::string& datasetName, hid_t dataType, const std::function<herr_t(hid_t, hid_t&, hid_t&)>& select,
+                            const std::function<void*(hsize_t)>& getBuffer)
+{
+  H5SUPPORT_MUTEX_LOCK_SHARED()
+
+  herr_t error = 0;
+  herr_t returnError = 0;
+  if(dataType == -1)
+  {
+    return -1;
+  }
+  hid_t datasetID = H5Dopen(locationID, datasetName.c_str(), H5P_DEFAULT);
+  if(datasetID < 0)
+  {
+    std::cout << "H5LiteGather.h::gatherDataset(" << __LINE__ << ") Error opening Dataset at locationID (" << locationID << ") with object name (" << datasetName << ")" << std::endl;
+    return -1;
+  }
+  hid_t fileSpaceID = -1;
+  hid_t memSpaceID = -1;
+  returnError = select(datasetID, fileSpaceID, memSpaceID);
+  if(returnError >= 0)
+  {
+    void* data = getBuffer(static_cast<hsize_t>(H5Sget_select_npoints(memSpaceID)));
+    error = H5Dread(datasetID, dataType, memSpaceID, fileSpaceID, H5P_DEFAULT, data);
+    H5SUPPORT_INSTRUMENT_BYTES(error, H5Instrumentation::dataspaceBytes(memSpaceID, dataType))
+    if(error < 0)
+    {
+      std::cout << "Error Gathering Data of '" << datasetName << "'" << std::endl;
+      returnError = error;
+    }
+    CloseH5S(memSpaceID, error, returnError);
+    CloseH5S(fileSpaceID, error, returnError);
+  }
+  CloseH5D(datasetID, error, returnError, datasetName);
+  return returnError;
+}
+
+/**
+ * @brief Reads a list of elements of a dataset with a single H5Dread
+ * @param locationID The parent location that contains the dataset to read
+ * @param datasetName The name of the dataset to read
+ * @param numPoints The number of elements
+ * @param coords numPoints * rank coordinates, one row of rank indices per element
+ * @param data Receives numPoints elements in the order they are listed
+ * @return Standard hdf5 error condition.
+ */
+template <typename T> inline herr_t readPointerDatasetPoints(hid_t locationID, const std::string& datasetName, size_t numPoints, const hsize_t* coords, T* data)
+{
+  if(nullptr == data)
+  {
+    return -2;
+  }
+  return gatherDataset(
+      locationID, datasetName, H5TypeTraits<T>::type(), [numPoints, coords](hid_t datasetID, hid_t& fileSpaceID, hid_t& memSpaceID) { return selectDatasetPoints(datasetID, numPoints, coords, fileSpaceID, memSpaceID); },
+      [data](hsize_t) -> void* { return data; });
+}
+
+/**
+ * @brief Reads a list of elements of a dataset into a std::vector with a single H5Dread
+ * @param locationID The parent location that contains the dataset to read
+ * @param datasetName The name of the dataset to read
+ * @param coords One row of rank indices per element
+ * @param data The vector WILL be resized to coords.size() / rank elements, in the order they are listed
+ * @return Standard hdf5 error condition.
+ */
+template <typename T, typename Allocator> inline herr_t readVectorDatasetPoints(hid_t locationID, const std::string& datasetName, const std::vector<hsize_t>& coords, std::vector<T, Allocator>& data)
+{
+  return gatherDataset(
+      locationID, datasetName, H5TypeTraits<T>::type(),
+      [&coords](hid_t datasetID, hid_t& fileSpaceID, hid_t& memSpaceID) {
+        hid_t dataspaceID = H5Dget_space(datasetID);
+        int32_t rank = (dataspaceID < 0) ? 0 : H5Sget_simple_extent_ndims(dataspaceID);
+        if(dataspaceID >= 0)
+        {
+          H5Sclose(dataspaceID);
+        }
+        if(rank <= 0 || coords.size() % static_cast<size_t>(rank) != 0)
+        {
+          std::cout << "H5LiteGather.h::readVectorDatasetPoints(" << __LINE__ << ") The number of coordinates is not a multiple of the rank of the dataset" << std::endl;
+          return static_cast<herr_t>(-3);
+        }
+        return selectDatasetPoints(datasetID, coords.size() / static_cast<size_t>(rank), coords.data(), fileSpaceID, memSpaceID);
+      },
+      [&data](hsize_t numElements) -> void* {
+        data.resize(numElements);
+        return data.data();
+      });
+}
+
+/**
+ * @brief Reads the union of several hyperslabs of a dataset with a single H5Dread. The
+ * elements arrive packed in C order of the dataset; overlapping regions are read once.
+ * @param locationID The parent location that contains the dataset to read
+ * @param datasetName The name of the dataset to read
+ * @param regions The hyperslabs
+ * @param data Receives the selected elements. It must hold at least the sum of
+ * H5Hyperslab::getNumberOfElements() over the regions.
+ * @return Standard hdf5 error condition.
+ */
+template <typename T> inline herr_t readPointerDatasetRegions(hid_t locationID, const std::string& datasetName, const std::vector<H5Hyperslab>& regions, T* data)
+{
+  if(nullptr == data)
+  {
+    return -2;
+  }
+  return gatherDataset(
+      locationID, datasetName, H5TypeTraits<T>::type(), [&regions](hid_t datasetID, hid_t& fileSpaceID, hid_t& memSpaceID) { return selectDatasetRegions(datasetID, regions, fileSpaceID, memSpaceID); },
+      [data](hsize_t) -> void* { return data; });
+}
+
+/**
+ * @brief Reads the union of several hyperslabs of a dataset into a std::vector with a single
+ * H5Dread. The elements arrive packed in C order of the dataset; overlapping regions are read once.
+ * @param locationID The parent location that contains the dataset to read
+ * @param datasetName The name of the dataset to read
+ * @param regions The hyperslabs
+ * @param data The vector WILL be resized to the number of elements in the union
+ * @return Standard hdf5 error condition.
+ */
+template <typename T, typename Allocator> inline herr_t readVectorDatasetRegions(hid_t locationID, const std::string& datasetName, const std::vector<H5Hyperslab>& regions, std::vector<T, Allocator>& data)
+{
+  return gatherDataset(
+      locationID, datasetName, H5TypeTraits<T>::type(), [&regions](hid_t datasetID, hid_t& fileSpaceID, hid_t& memSpaceID) { return selectDatasetRegions(datasetID, regions, fileSpaceID, memSpaceID); },
+      [&data](hsize_t numElements) -> void* {
+        data.resize(numElements);
+        return data.data();
+      });
+}
+} // namespace H5Lite
+
+#if defined(H5Support_NAMESPACE)
+}
+#endif
@@ -0,0 +1,577 @@
+/* ============================================================================
+ * Copyright (c) 2007-2019 BlueQuartz Software, LLC
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+ * contributors may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The code contained herein was partially funded by the followig contracts:
+ *    United States Air Force Prime Contract FA8650-04-C-5229
+ *    United States Air Force Prime Contract FA8650-15-D-5231
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <future>
+#include <iostream>
+#include <memory>
+#include <numeric>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <hdf5.h>
+#include <zlib.h>
+
+#include "H5Support/H5Lite.h"
+#include "H5Support/H5Support.h"
+#include "H5Support/H5TaskExecutor.h"
+
+#if defined(H5Support_NAMESPACE)
+namespace H5Support_NAMESPACE
+{
+#endif
+
+namespace H5Lite
+{
+/**
+ * @brief Helpers that split a C ordered array into HDF5 chunks
+ */
+namespace chunking
+{
+/**
+ * @brief Returns the number of chunks along each dimension
+ * @param rank
+ * @param dims
+ * @param cDims
+ * @return
+ */
+inline std::vector<hsize_t> chunkCounts(int32_t rank, const hsize_t* dims, const hsize_t* cDims)
+{
+  std::vector<hsize_t> counts(static_cast<size_t>(rank), 0);
+  for(int32_t i = 0; i < rank; ++i)
+  {
+    counts[i] = (dims[i] + cDims[i] - 1) / cDims[i];
+  }
+  return counts;
+}
+
+/**
+ * @brief Converts a linear chunk index (C order over the chunk grid) into the element
+ * offset of the first element of that chunk
+ * @param chunkIndex
+ * @param counts The result of chunkCounts()
+ * @param cDims
+ * @return
+ */
+inline std::vector<hsize_t> chunkOffset(hsize_t chunkIndex, const std::vector<hsize_t>& counts, const hsize_t* cDims)
+{
+  std::vector<hsize_t> offset(counts.size(), 0);
+  for(size_t i = counts.size(); i-- > 0;)
+  {
+    offset[i] = (chunkIndex % counts[i]) * cDims[i];
+    chunkIndex /= counts[i];
+  }
+  return offset;
+}
+
+/**
+ * @brief Calls function(arrayIndex, chunkIndex, runLength) for every run of elements
+ * along the fastest dimension that belongs to both the chunk at offset and the array.
+ * Indices are element indices into the whole array and into the chunk buffer.
+ * @param rank
+ * @param dims Dimensions of the whole array
+ * @param cDims Chunk dimensions
+ * @param offset Element offset of the chunk, see chunkOffset()
+ * @param function
+ */
+template <typename Function> inline void forEachChunkRun(int32_t rank, const hsize_t* dims, const hsize_t* cDims, const std::vector<hsize_t>& offset, Function&& function)
+{
+  const size_t last = static_cast<size_t>(rank - 1);
+  const hsize_t runLength = std::min(cDims[last], dims[last] - offset[last]);
+  std::vector<hsize_t> position(static_cast<size_t>(rank), 0);
+  while(true)
+  {
+    hsize_t arrayIndex = 0;
+    hsize_t chunkIndex = 0;
+    for(int32_t i = 0; i < rank; ++i)
+    {
+      arrayIndex = arrayIndex * dims[i] + offset[i] + position[i];
+      chunkIndex = chunkIndex * cDims[i] + position[i];
+    }
+    function(arrayIndex, chunkIndex, runLength);
+
+    int32_t dim = rank - 2;
+    while(dim >= 0)
+    {
+      position[dim]++;
+      if(position[dim] < cDims[dim] && offset[dim] + position[dim] < dims[dim])
+      {
+        break;
+      }
+      position[dim] = 0;
+      dim--;
+    }
+    if(dim < 0)
+    {
+      break;
+    }
+  }
+}
+
+/**
+ * @brief Copies the elements of one chunk out of a C ordered array. The chunk buffer
+ * must hold prod(cDims) elements; the parts of an edge chunk that lie outside the
+ * array are zero filled, matching what the HDF5 chunk cache writes.
+ * @param source The whole array
+ * @param typeSize Size of one element in bytes
+ * @param rank
+ * @param dims Dimensions of the whole array
+ * @param cDims Chunk dimensions
+ * @param offset Element offset of the chunk, see chunkOffset()
+ * @param chunk Destination buffer
+ */
+inline void gatherChunk(const uint8_t* source, size_t typeSize, int32_t rank, const hsize_t* dims, const hsize_t* cDims, const std::vector<hsize_t>& offset, uint8_t* chunk)
+{
+  bool edgeChunk = false;
+  for(int32_t i = 0; i < rank; ++i)
+  {
+    edgeChunk = edgeChunk || (offset[i] + cDims[i] > dims[i]);
+  }
+  if(edgeChunk)
+  {
+    hsize_t chunkElements = std::accumulate(cDims, cDims + rank, static_cast<hsize_t>(1), std::multiplies<hsize_t>());
+    std::memset(chunk, 0, static_cast<size_t>(chunkElements) * typeSize);
+  }
+  forEachChunkRun(rank, dims, cDims, offset, [=](hsize_t arrayIndex, hsize_t chunkIndex, hsize_t runLength) {
+    std::memcpy(chunk + chunkIndex * typeSize, source + arrayIndex * typeSize, static_cast<size_t>(runLength) * typeSize);
+  });
+}
+
+/**
+ * @brief Copies the elements of one chunk into a C ordered array, dropping the parts of
+ * an edge chunk that lie outside the array
+ * @param chunk The chunk buffer holding prod(cDims) elements
+ * @param typeSize Size of one element in bytes
+ * @param rank
+ * @param dims Dimensions of the whole array
+ * @param cDims Chunk dimensions
+ * @param offset Element offset of the chunk, see chunkOffset()
+ * @param destination The whole array
+ */
+inline void scatterChunk(const uint8_t* chunk, size_t typeSize, int32_t rank, const hsize_t* dims, const hsize_t* cDims, const std::vector<hsize_t>& offset, uint8_t* destination)
+{
+  forEachChunkRun(rank, dims, cDims, offset, [=](hsize_t arrayIndex, hsize_t chunkIndex, hsize_t runLength) {
+    std::memcpy(destination + arrayIndex * typeSize, chunk + chunkIndex * typeSize, static_cast<size_t>(runLength) * typeSize);
+  });
+}
+} // namespace chunking
+
+/**
+ * @brief Returns the number of worker threads used when the caller passes 0
+ * @return
+ */
+inline size_t defaultCompressionThreadCount()
+{
+  size_t threadCount = std::thread::hardware_concurrency();
+  return threadCount > 0 ? threadCount : 1;
+}
+
+#if defined(H5_HAVE_FILTER_DEFLATE) && H5_VERSION_GE(1, 10, 3)
+/**
+ * @brief Creates a deflate compressed, chunked dataset like writePointerDatasetCompressed
+ * but compresses the chunks on a pool of worker threads and stores them with
+ * H5Dwrite_chunk. The dataset uses exactly the same filter pipeline as
+ * writePointerDatasetCompressed and every chunk is compressed with the same zlib call the
+ * HDF5 deflate filter makes, so the resulting file is interchangeable with the serial
+ * path and can be read back with any HDF5 reader.
+ *
+ * Only the calling thread enters HDF5. At most 2 * threadCount compressed chunks are held
+ * in memory at any time.
+ *
+ * @param locationID The Parent location to store the data
+ * @param datasetName The name of the dataset
+ * @param rank The number of dimensions
+ * @param dims The dimensions of the dataset
+ * @param data The data to write to the file
+ * @param cRank The number of dimensions for cDims. Must equal rank
+ * @param cDims The chunk dimensions
+ * @param compressionLevel The compression level (0-9)
+ * @param threadCount The number of compression threads. 0 uses defaultCompressionThreadCount()
+ * @return Standard HDF5 error conditions
+ */
+template <typename T>
+inline herr_t writePointerDatasetCompressedParallel(hid_t locationID, const std::string& datasetName, int32_t rank, const hsize_t* dims, const T* data, int32_t cRank, const hsize_t* cDims,
+                                                    int32_t compressionLevel, size_t threadCount = 0)
+{
+  H5SUPPORT_MUTEX_LOCK()
+
+  if(data == nullptr)
+  {
+    return -100;
+  }
+  hid_t dataType = H5TypeTraits<T>::type();
+  if(dataType == -1)
+  {
+    return -101;
+  }
+  if(cRank != rank || rank < 1 || std::any_of(cDims, cDims + cRank, [](hsize_t value) { return value == 0; }))
+  {
+    std::cout << "H5LiteParallel.h::writePointerDatasetCompressedParallel(" << __LINE__ << ") The chunk rank must match the dataset rank and chunk dimensions must not be zero" << std::endl;
+    return -102;
+  }
+  if(std::any_of(dims, dims + rank, [](hsize_t value) { return value == 0; }))
+  {
+    // Nothing to compress, let the serial path create the empty dataset
+    return writePointerDatasetCompressed(locationID, datasetName, rank, dims, data, cRank, cDims, compressionLevel);
+  }
+
+  hid_t dataspaceID = H5Screate_simple(rank, dims, nullptr);
+  if(dataspaceID < 0)
+  {
+    return -102;
+  }
+  hid_t propertyListID = H5Pcreate(H5P_DATASET_CREATE);
+  hid_t datasetID = -1;
+  if(propertyListID >= 0 && H5Pset_chunk(propertyListID, cRank, cDims) >= 0 && H5Pset_deflate(propertyListID, static_cast<unsigned>(compressionLevel)) >= 0)
+  {
+    datasetID = H5Dcreate(locationID, datasetName.c_str(), dataType, dataspaceID, H5P_DEFAULT, propertyListID, H5P_DEFAULT);
+  }
+  if(propertyListID >= 0)
+  {
+    H5Pclose(propertyListID);
+  }
+  H5Sclose(dataspaceID);
+  if(datasetID < 0)
+  {
+    std::cout << "H5LiteParallel.h::writePointerDatasetCompressedParallel(" << __LINE__ << ") Error creating dataset '" << datasetName << "'" << std::endl;
+    return -111;
+  }
+
+  struct CompressedChunk
+  {
+    std::vector<hsize_t> offset;
+    std::vector<Bytef> bytes;
+    int status = Z_OK;
+  };
+
+  const std::vector<hsize_t> counts = chunking::chunkCounts(rank, dims, cDims);
+  const hsize_t numChunks = std::accumulate(counts.cbegin(), counts.cend(), static_cast<hsize_t>(1), std::multiplies<hsize_t>());
+  const size_t chunkBytes = static_cast<size_t>(std::accumulate(cDims, cDims + cRank, static_cast<hsize_t>(1), std::multiplies<hsize_t>())) * sizeof(T);
+  const uint8_t* source = reinterpret_cast<const uint8_t*>(data);
+
+  threadCount = threadCount > 0 ? threadCount : defaultCompressionThreadCount();
+  const size_t maxInFlight = 2 * threadCount;
+  herr_t returnError = 0;
+  {
+    H5TaskExecutor executor(threadCount, maxInFlight);
+    std::deque<std::future<CompressedChunk>> inFlight;
+    hsize_t nextChunk = 0;
+    while(nextChunk < numChunks || !inFlight.empty())
+    {
+      // Keep the workers busy while this thread writes finished chunks in order
+      while(nextChunk < numChunks && inFlight.size() < maxInFlight && returnError >= 0)
+      {
+        hsize_t chunkIndex = nextChunk++;
+        inFlight.push_back(executor.submit([=, &counts]() {
+          CompressedChunk result;
+          result.offset = chunking::chunkOffset(chunkIndex, counts, cDims);
+          std::vector<uint8_t> raw(chunkBytes);
+          chunking::gatherChunk(source, sizeof(T), rank, dims, cDims, result.offset, raw.data());
+          uLongf compressedSize = compressBound(static_cast<uLong>(chunkBytes));
+          result.bytes.resize(compressedSize);
+          result.status = compress2(result.bytes.data(), &compressedSize, raw.data(), static_cast<uLong>(chunkBytes), compressionLevel);
+          result.bytes.resize(compressedSize);
+          return result;
+        }));
+      }
+      if(inFlight.empty())
+      {
+        break;
+      }
+      CompressedChunk chunk = inFlight.front().get();
+      inFlight.pop_front();
+      if(returnError < 0)
+      {
+        continue;
+      }
+      if(chunk.status != Z_OK)
+      {
+        std::cout << "H5LiteParallel.h::writePointerDatasetCompressedParallel(" << __LINE__ << ") zlib error " << chunk.status << " compressing a chunk of '" << datasetName << "'" << std::endl;
+        returnError = -108;
+        continue;
+      }
+      herr_t error = H5Dwrite_chunk(datasetID, H5P_DEFAULT, 0, chunk.offset.data(), chunk.bytes.size(), chunk.bytes.data());
+      if(error < 0)
+      {
+        std::cout << "H5LiteParallel.h::writePointerDatasetCompressedParallel(" << __LINE__ << ") Error writing a chunk of '" << datasetName << "'" << std::endl;
+        returnError = -108;
+      }
+    }
+  }
+  H5SUPPORT_INSTRUMENT_BYTES(returnError, std::accumulate(dims, dims + rank, static_cast<hsize_t>(1), std::multiplies<hsize_t>()) * sizeof(T))
+
+  herr_t error = H5Dclose(datasetID);
+  if(error < 0)
+  {
+    std::cout << "Error Closing Dataset." << std::endl;
+    returnError = -110;
+  }
+  return returnError;
+}
+
+/**
+ * @brief std::vector overload of writePointerDatasetCompressedParallel
+ * @param locationID The Parent location to store the data
+ * @param datasetName The name of the dataset
+ * @param dims The dimensions of the dataset
+ * @param data The data to write to the file
+ * @param cDims The chunk dimensions
+ * @param compressionLevel The compression level (0-9)
+ * @param threadCount The number of compression threads. 0 uses defaultCompressionThreadCount()
+ * @return Standard HDF5 error conditions
+ */
+template <typename T>
+inline herr_t writeVectorDatasetCompressedParallel(hid_t locationID, const std::string& datasetName, const std::vector<hsize_t>& dims, const std::vector<T>& data, const std::vector<hsize_t>& cDims,
+                                                   int32_t compressionLevel, size_t threadCount = 0)
+{
+  return writePointerDatasetCompressedParallel(locationID, datasetName, static_cast<int32_t>(dims.size()), dims.data(), data.data(), static_cast<int32_t>(cDims.size()), cDims.data(), compressionLevel,
+                                               threadCount);
+}
+#endif
+
+#if defined(H5_HAVE_FILTER_DEFLATE) && H5_VERSION_GE(1, 10, 5)
+/**
+ * @brief Reads a whole chunked, deflate compressed dataset (such as one written by
+ * writePointerDatasetCompressed) into a pre-allocated pointer, inflating the chunks on a
+ * pool of worker threads.
+ *
+ * The calling thread looks up every chunk with H5Dget_chunk_info_by_coord and fetches
+ * the raw bytes with H5Dread_chunk; the workers inflate them and scatter the elements
+ * into data. Chunks whose deflate filter was skipped on write are copied as they are.
+ * At most 2 * threadCount raw chunks are held in memory at any time.
+ *
+ * Datasets that are not chunked, whose filter pipeline is anything other than a single
+ * deflate filter, whose stored type differs from T or that have unallocated chunks are
+ * read with readPointerDataset() instead.
+ *
+ * @param locationID The parent location that contains the dataset to read
+ * @param datasetName The name of the dataset to read
+ * @param data The pointer to store the data into. Must hold every element of the dataset
+ * @param threadCount The number of decompression threads. 0 uses defaultCompressionThreadCount()
+ * @return Standard HDF error condition
+ */
+template <typename T> inline herr_t readPointerDatasetCompressedParallel(hid_t locationID, const std::string& datasetName, T* data, size_t threadCount = 0)
+{
+  H5SUPPORT_MUTEX_LOCK_SHARED()
+
+  hid_t dataType = H5TypeTraits<T>::type();
+  if(dataType == -1)
+  {
+    std::cout << "dataType was not supported." << std::endl;
+    return -10;
+  }
+  if(nullptr == data)
+  {
+    std::cout << "The Pointer to hold the data is nullptr. This is NOT allowed." << std::endl;
+    return -3;
+  }
+  hid_t datasetID = H5Dopen(locationID, datasetName.c_str(), H5P_DEFAULT);
+  if(datasetID < 0)
+  {
+    std::cout << "H5LiteParallel.h::readPointerDatasetCompressedParallel(" << __LINE__ << ") Error opening Dataset at locationID (" << locationID << ") with object name (" << datasetName << ")"
+              << std::endl;
+    return -1;
+  }
+
+  // Decide if the direct chunk path can handle this dataset
+  bool directChunks = false;
+  std::vector<hsize_t> dims;
+  std::vector<hsize_t> cDims;
+  hid_t dataspaceID = H5Dget_space(datasetID);
+  hid_t propertyListID = H5Dget_create_plist(datasetID);
+  hid_t fileType = H5Dget_type(datasetID);
+  if(dataspaceID >= 0 && propertyListID >= 0 && fileType >= 0)
+  {
+    int32_t rank = H5Sget_simple_extent_ndims(dataspaceID);
+    unsigned flags = 0;
+    size_t numValues = 0;
+    if(rank > 0 && H5Pget_layout(propertyListID) == H5D_CHUNKED && H5Pget_nfilters(propertyListID) == 1 &&
+       H5Pget_filter2(propertyListID, 0, &flags, &numValues, nullptr, 0, nullptr, nullptr) == H5Z_FILTER_DEFLATE && H5Tequal(fileType, dataType) > 0)
+    {
+      dims.resize(static_cast<size_t>(rank));
+      cDims.resize(static_cast<size_t>(rank));
+      H5Sget_simple_extent_dims(dataspaceID, dims.data(), nullptr);
+      H5Pget_chunk(propertyListID, rank, cDims.data());
+      std::vector<hsize_t> counts = chunking::chunkCounts(rank, dims.data(), cDims.data());
+      hsize_t expectedChunks = std::accumulate(counts.cbegin(), counts.cend(), static_cast<hsize_t>(1), std::multiplies<hsize_t>());
+      hsize_t numChunks = 0;
+      directChunks = H5Dget_num_chunks(datasetID, dataspaceID, &numChunks) >= 0 && numChunks == expectedChunks && numChunks > 0;
+    }
+  }
+  if(fileType >= 0)
+  {
+    H5Tclose(fileType);
+  }
+  if(propertyListID >= 0)
+  {
+    H5Pclose(propertyListID);
+  }
+  if(dataspaceID >= 0)
+  {
+    H5Sclose(dataspaceID);
+  }
+  if(!directChunks)
+  {
+    H5Dclose(datasetID);
+    return readPointerDataset(locationID, datasetName, data);
+  }
+
+  const int32_t rank = static_cast<int32_t>(dims.size());
+  const std::vector<hsize_t> counts = chunking::chunkCounts(rank, dims.data(), cDims.data());
+  const hsize_t numChunks = std::accumulate(counts.cbegin(), counts.cend(), static_cast<hsize_t>(1), std::multiplies<hsize_t>());
+  const size_t chunkBytes = static_cast<size_t>(std::accumulate(cDims.cbegin(), cDims.cend(), static_cast<hsize_t>(1), std::multiplies<hsize_t>())) * sizeof(T);
+  uint8_t* destination = reinterpret_cast<uint8_t*>(data);
+  const hsize_t* dimsPtr = dims.data();
+  const hsize_t* cDimsPtr = cDims.data();
+
+  threadCount = threadCount > 0 ? threadCount : defaultCompressionThreadCount();
+  const size_t maxInFlight = 2 * threadCount;
+  herr_t returnError = 0;
+  {
+    H5TaskExecutor executor(threadCount, maxInFlight);
+    std::deque<std::future<int>> inFlight;
+    hsize_t nextChunk = 0;
+    while(nextChunk < numChunks || !inFlight.empty())
+    {
+      // Keep the workers busy while this thread fetches the next raw chunks in order
+      while(nextChunk < numChunks && inFlight.size() < maxInFlight && returnError >= 0)
+      {
+        std::vector<hsize_t> offset = chunking::chunkOffset(nextChunk++, counts, cDimsPtr);
+        unsigned filterMask = 0;
+        haddr_t address = HADDR_UNDEF;
+        hsize_t storageSize = 0;
+        if(H5Dget_chunk_info_by_coord(datasetID, offset.data(), &filterMask, &address, &storageSize) < 0 || address == HADDR_UNDEF)
+        {
+          std::cout << "H5LiteParallel.h::readPointerDatasetCompressedParallel(" << __LINE__ << ") Error getting chunk info of '" << datasetName << "'" << std::endl;
+          returnError = -1;
+          break;
+        }
+        auto raw = std::make_shared<std::vector<Bytef>>(static_cast<size_t>(storageSize));
+        uint32_t readMask = 0;
+        if(H5Dread_chunk(datasetID, H5P_DEFAULT, offset.data(), &readMask, raw->data()) < 0)
+        {
+          std::cout << "H5LiteParallel.h::readPointerDatasetCompressedParallel(" << __LINE__ << ") Error reading a chunk of '" << datasetName << "'" << std::endl;
+          returnError = -1;
+          break;
+        }
+        inFlight.push_back(executor.submit([=]() {
+          const Bytef* chunk = raw->data();
+          std::vector<Bytef> inflated;
+          if((readMask & 0x01) == 0)
+          {
+            // The deflate filter ran on write
+            inflated.resize(chunkBytes);
+            uLongf inflatedSize = static_cast<uLongf>(chunkBytes);
+            int status = uncompress(inflated.data(), &inflatedSize, raw->data(), static_cast<uLong>(raw->size()));
+            if(status != Z_OK || inflatedSize != chunkBytes)
+            {
+              return status != Z_OK ? status : Z_DATA_ERROR;
+            }
+            chunk = inflated.data();
+          }
+          else if(raw->size() != chunkBytes)
+          {
+            return Z_DATA_ERROR;
+          }
+          chunking::scatterChunk(chunk, sizeof(T), rank, dimsPtr, cDimsPtr, offset, destination);
+          return Z_OK;
+        }));
+      }
+      if(inFlight.empty())
+      {
+        break;
+      }
+      int status = inFlight.front().get();
+      inFlight.pop_front();
+      if(status != Z_OK && returnError >= 0)
+      {
+        std::cout << "H5LiteParallel.h::readPointerDatasetCompressedParallel(" << __LINE__ << ") zlib error " << status << " inflating a chunk of '" << datasetName << "'" << std::endl;
+        returnError = -1;
+      }
+    }
+  }
+  H5SUPPORT_INSTRUMENT_BYTES(returnError, std::accumulate(dims.cbegin(), dims.cend(), static_cast<hsize_t>(1), std::multiplies<hsize_t>()) * sizeof(T))
+
+  herr_t error = H5Dclose(datasetID);
+  if(error < 0)
+  {
+    std::cout << "Error Closing Dataset id" << std::endl;
+    returnError = error;
+  }
+  return returnError;
+}
+
+/**
+ * @brief std::vector overload of readPointerDatasetCompressedParallel. The vector WILL be
+ * resized to hold every element of the dataset; pass an UninitializedVector to skip zero
+ * filling it first.
+ * @param locationID The parent location that contains the dataset to read
+ * @param datasetName The name of the dataset to read
+ * @param data The vector to store the data into
+ * @param threadCount The number of decompression threads. 0 uses defaultCompressionThreadCount()
+ * @return Standard HDF error condition
+ */
+template <typename T, typename Allocator>
+inline herr_t readVectorDatasetCompressedParallel(hid_t locationID, const std::string& datasetName, std::vector<T, Allocator>& data, size_t threadCount = 0)
+{
+  H5SUPPORT_MUTEX_LOCK_SHARED()
+
+  std::vector<hsize_t> dims;
+  H5T_class_t classType;
+  size_t typeSize = 0;
+  herr_t error = getDatasetInfo(locationID, datasetName, dims, classType, typeSize);
+  if(error < 0)
+  {
+    return error;
+  }
+  data.resize(std::accumulate(dims.cbegin(), dims.cend(), static_cast<hsize_t>(1), std::multiplies<hsize_t>()));
+  if(data.empty())
+  {
+    return 0;
+  }
+  return readPointerDatasetCompressedParallel(locationID, datasetName, data.data(), threadCount);
+}
+#endif
+} // namespace H5Lite
+
+#if defined(H5Support_NAMESPACE)
+}
+#endif
@@ -0,0 +1,533 @@
+/* ============================================================================
+ * Copyright (c) 2007-2019 BlueQuartz Software, LLC
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+ * contributors may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The code contained herein was partially funded by the followig contracts:
+ *    United States Air Force Prime Contract FA8650-04-C-5229
+ *    United States Air Force Prime Contract FA8650-15-D-5231
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <numeric>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include <hdf5.h>
+
+#include "H5Support/H5DefaultInitAllocator.h"
+#include "H5Support/H5Instrumentation.h"
+#include "H5Support/H5Lite.h"
+#include "H5Support/H5Macros.h"
+#include "H5Support/H5Support.h"
+
+#if defined(H5Support_NAMESPACE)
+namespace H5Support_NAMESPACE
+{
+#endif
+
+/**
+ * @brief The floating point type a dataset is stored as on disk.
+ * Native stores the type of the buffer. Float32 stores IEEE single precision. Float16 stores
+ * IEEE half precision (5 exponent bits, 10 mantissa bits, about 3 significant digits, largest
+ * value 65504). BFloat16 stores the upper half of a single (8 exponent bits, 7 mantissa bits,
+ * about 2 significant digits, the range of a float).
+ */
+enum class H5StoragePrecision : int32_t
+{
+  Native = 0,
+  Float32 = 1,
+  Float16 = 2,
+  BFloat16 = 3
+};
+
+namespace H5Lite
+{
+/**
+ * @brief Reinterprets the bits of a float
+ * @param value
+ * @return
+ */
+inline uint32_t floatBits(float value)
+{
+  uint32_t bits = 0;
+  std::memcpy(&bits, &value, sizeof(bits));
+  return bits;
+}
+
+/**
+ * @brief Reinterprets bits as a float
+ * @param bits
+ * @return
+ */
+inline float bitsFloat(uint32_t bits)
+{
+  float value = 0.0f;
+  std::memcpy(&value, &bits, sizeof(value));
+  return value;
+}
+
+/**
+ * @brief Rounds a float to the nearest IEEE half, ties to even. Values too large for a half
+ * become infinity, NaN stays NaN. All paths are computed and then selected without branches.
+ * @param value
+ * @return The bits of the half
+ */
+inline uint16_t floatToHalf(float value)
+{
+  const uint32_t k_MagicBits = static_cast<uint32_t>((127 - 15) + (23 - 10) + 1) << 23;
+  uint32_t bits = floatBits(value);
+  uint32_t sign = bits & 0x80000000u;
+  bits ^= sign;
+
+  // Normal halves: rebias the exponent and round the 13 dropped mantissa bits to even
+  uint32_t normal = (bits + (static_cast<uint32_t>(15 - 127) << 23) + 0xfffu + ((bits >> 13) & 1u)) >> 13;
+  // Subnormal halves: adding the magic value lets the FPU do the shift and the rounding
+  uint32_t subnormal = floatBits(bitsFloat(bits) + bitsFloat(k_MagicBits)) - k_MagicBits;
+  uint32_t infNan = (bits > 0x7f800000u) ? 0x7e00u : 0x7c00u;
+
+  uint32_t half = (bits >= (143u << 23)) ? infNan : ((bits < (113u << 23)) ? subnormal : normal);
+  return static_cast<uint16_t>(half | (sign >> 16));
+}
+
+/**
+ * @brief Widens an IEEE half to a float. Every half is exactly representable.
+ * @param half The bits of the half
+ * @return
+ */
+inline float halfToFloat(uint16_t half)
+{
+  const uint32_t k_ShiftedExponent = 0x7c00u << 13;
+  uint32_t bits = static_cast<uint32_t>(half & 0x7fffu) << 13;
+  uint32_t exponent = bits & k_ShiftedExponent;
+  bits += static_cast<uint32_t>(127 - 15) << 23;
+
+  uint32_t infNan = bits + (static_cast<uint32_t>(128 - 16) << 23);
+  uint32_t subnormal = floatBits(bitsFloat(bits + (1u << 23)) - bitsFloat(113u << 23));
+
+  uint32_t widened = (exponent == k_ShiftedExponent) ? infNan : ((exponent == 0) ? subnormal : bits);
+  return bitsFloat(widened | (static_cast<uint32_t>(half & 0x8000u) << 16));
+}
+
+/**
+ * @brief Rounds a float to the nearest bfloat16, ties to even. NaN stays NaN.
+ * @param value
+ * @return The bits of the bfloat16
+ */
+inline uint16_t floatToBFloat16(float value)
+{
+  uint32_t bits = floatBits(value);
+  uint32_t rounded = (bits + 0x7fffu + ((bits >> 16) & 1u)) >> 16;
+  uint32_t nan = (bits >> 16) | 0x40u;
+  return static_cast<uint16_t>(((bits & 0x7fffffffu) > 0x7f800000u) ? nan : rounded);
+}
+
+/**
+ * @brief Widens a bfloat16 to a float. Every bfloat16 is exactly representable.
+ * @param value The bits of the bfloat16
+ * @return
+ */
+inline float bfloat16ToFloat(uint16_t value)
+{
+  return bitsFloat(static_cast<uint32_t>(value) << 16);
+}
+
+/**
+ * @brief Returns the number of bytes one value takes in the given storage precision
+ * @param precision
+ * @return 0 for Native
+ */
+inline size_t getStoragePrecisionSize(H5StoragePrecision precision)
+{
+  switch(precision)
+  {
+  case H5StoragePrecision::Float32:
+    return sizeof(float);
+  case H5StoragePrecision::Float16:
+  case H5StoragePrecision::BFloat16:
+    return sizeof(uint16_t);
+  default:
+    return 0;
+  }
+}
+
+/**
+ * @brief Creates the HDF5 type of a storage precision in native byte order. The 16 bit types
+ * are derived from H5T_NATIVE_FLOAT with narrower fields, so any HDF5 reader can convert them.
+ * @param precision
+ * @return A type the caller must close, or -1 for Native
+ */
+inline hid_t createStoragePrecisionType(H5StoragePrecision precision)
+{
+  H5SUPPORT_MUTEX_LOCK_SHARED()
+
+  if(precision == H5StoragePrecision::Native)
+  {
+    return -1;
+  }
+  hid_t typeID = H5Tcopy(H5T_NATIVE_FLOAT);
+  if(typeID < 0 || precision == H5StoragePrecision::Float32)
+  {
+    return typeID;
+  }
+  // Sign bit 15, exponent above the mantissa, mantissa at bit 0
+  size_t mantissaSize = (precision == H5StoragePrecision::Float16) ? 10 : 7;
+  size_t exponentSize = (precision == H5StoragePrecision::Float16) ? 5 : 8;
+  size_t exponentBias = (precision == H5StoragePrecision::Float16) ? 15 : 127;
+  herr_t error = H5Tset_fields(typeID, 15, mantissaSize, exponentSize, 0, mantissaSize);
+  if(error >= 0)
+  {
+    error = H5Tset_precision(typeID, 16);
+  }
+  if(error >= 0)
+  {
+    error = H5Tset_size(typeID, 2);
+  }
+  if(error >= 0)
+  {
+    error = H5Tset_ebias(typeID, exponentBias);
+  }
+  if(error < 0)
+  {
+    std::cout << "H5LiteReducedPrecision.h::createStoragePrecisionType(" << __LINE__ << ") Error defining the 16 bit float type" << std::endl;
+    H5Tclose(typeID);
+    return -1;
+  }
+  return typeID;
+}
+
+/**
+ * @brief Returns the storage precision an HDF5 float type matches
+ * @param typeID
+ * @return Native when the type is not one of the reduced precision types
+ */
+inline H5StoragePrecision getStoragePrecision(hid_t typeID)
+{
+  H5SUPPORT_MUTEX_LOCK_SHARED()
+
+  if(H5Tget_class(typeID) != H5T_FLOAT)
+  {
+    return H5StoragePrecision::Native;
+  }
+  size_t typeSize = H5Tget_size(typeID);
+  if(typeSize == sizeof(float))
+  {
+    return H5StoragePrecision::Float32;
+  }
+  if(typeSize != sizeof(uint16_t))
+  {
+    return H5StoragePrecision::Native;
+  }
+  size_t signPos = 0;
+  size_t exponentPos = 0;
+  size_t exponentSize = 0;
+  size_t mantissaPos = 0;
+  size_t mantissaSize = 0;
+  H5Tget_fields(typeID, &signPos, &exponentPos, &exponentSize, &mantissaPos, &mantissaSize);
+  size_t exponentBias = H5Tget_ebias(typeID);
+  if(signPos == 15 && exponentPos == 10 && exponentSize == 5 && mantissaPos == 0 && mantissaSize == 10 && exponentBias == 15)
+  {
+    return H5StoragePrecision::Float16;
+  }
+  if(signPos == 15 && exponentPos == 7 && exponentSize == 8 && mantissaPos == 0 && mantissaSize == 7 && exponentBias == 127)
+  {
+    return H5StoragePrecision::BFloat16;
+  }
+  return H5StoragePrecision::Native;
+}
+
+/**
+ * @brief Narrows values into a buffer of the given storage precision. Doubles are rounded to
+ * float first when the storage is 16 bits wide.
+ * @param source
+ * @param count
+ * @param precision Float32, Float16 or BFloat16
+ * @param target count * getStoragePrecisionSize(precision) bytes
+ */
+template <typename T> inline void narrowValues(const T* source, size_t count, H5StoragePrecision precision, void* target)
+{
+  static_assert(std::is_floating_point<T>::value, "Only floating point values can be narrowed");
+  if(precision == H5StoragePrecision::Float32)
+  {
+    float* output = static_cast<float*>(target);
+    for(size_t i = 0; i < count; ++i)
+    {
+      output[i] = static_cast<float>(source[i]);
+    }
+  }
+  else if(precision == H5StoragePrecision::Float16)
+  {
+    uint16_t* output = static_cast<uint16_t*>(target);
+    for(size_t i = 0; i < count; ++i)
+    {
+      output[i] = floatToHalf(static_cast<float>(source[i]));
+    }
+  }
+  else if(precision == H5StoragePrecision::BFloat16)
+  {
+    uint16_t* output = static_cast<uint16_t*>(target);
+    for(size_t i = 0; i < count; ++i)
+    {
+      output[i] = floatToBFloat16(static_cast<float>(source[i]));
+    }
+  }
+}
+
+/**
+ * @brief Widens values of the given storage precision into T
+ * @param source
+ * @param sourceBytes The size of source. It must hold count * getStoragePrecisionSize(precision) bytes
+ * @param count
+ * @param precision Float32, Float16 or BFloat16
+ * @param target
+ * @return False if the precision is Native or source is too small, in which case nothing is read
+ */
+template <typename T> inline bool widenValues(const void* source, size_t sourceBytes, size_t count, H5StoragePrecision precision, T* target)
+{
+  static_assert(std::is_floating_point<T>::value, "Only floating point values can be widened");
+  size_t valueSize = getStoragePrecisionSize(precision);
+  if(valueSize == 0 || sourceBytes / valueSize < count)
+  {
+    return false;
+  }
+  if(precision == H5StoragePrecision::Float32)
+  {
+    const float* input = static_cast<const float*>(source);
+    for(size_t i = 0; i < count; ++i)
+    {
+      target[i] = static_cast<T>(input[i]);
+    }
+  }
+  else if(precision == H5StoragePrecision::Float16)
+  {
+    const uint16_t* input = static_cast<const uint16_t*>(source);
+    for(size_t i = 0; i < count; ++i)
+    {
+      target[i] = static_cast<T>(halfToFloat(input[i]));
+    }
+  }
+  else if(precision == H5StoragePrecision::BFloat16)
+  {
+    const uint16_t* input = static_cast<const uint16_t*>(source);
+    for(size_t i = 0; i < count; ++i)
+    {
+      target[i] = static_cast<T>(bfloat16ToFloat(input[i]));
+    }
+  }
+  return true;
+}
+
+/**
+ * @brief Writes the data of a pointer to an HDF5 file, storing it in a narrower floating
+ * point type. The values are narrowed by narrowValues() into a temporary of the stored size
+ * so HDF5 writes them without a type conversion.
+ * @param locationID The hdf5 object id of the parent
+ * @param datasetName The name of the dataset to write to
+ * @param rank The number of dimensions
+ * @param dims The sizes of each dimension
+ * @param data The data to be written
+ * @param precision The type to store. Native, or Float32 for float data, writes the data as is.
+ * @return Standard hdf5 error condition.
+ */
+template <typename T>
+inline herr_t writePointerDataset(hid_t locationID, const std::string& datasetName, int32_t rank, const hsize_t* dims, const T* data, H5StoragePrecision precision)
+{
+  static_assert(std::is_floating_point<T>::value, "Only floating point data can be stored with reduced precision");
+  if(precision == H5StoragePrecision::Native || (precision == H5StoragePrecision::Float32 && std::is_same<T, float>::value))
+  {
+    return writePointerDataset(locationID, datasetName, rank, dims, data);
+  }
+
+  H5SUPPORT_MUTEX_LOCK()
+
+  herr_t error = 0;
+  herr_t returnError = 0;
+  if(nullptr == data)
+  {
+    return -2;
+  }
+  hsize_t numElements = std::accumulate(dims, dims + rank, static_cast<hsize_t>(1), std::multiplies<hsize_t>());
+  UninitializedVector<uint8_t> narrowed(numElements * getStoragePrecisionSize(precision));
+  narrowValues(data, numElements, precision, narrowed.data());
+
+  hid_t dataType = createStoragePrecisionType(precision);
+  if(dataType < 0)
+  {
+    return -1;
+  }
+  hid_t dataspaceID = H5Screate_simple(rank, dims, nullptr);
+  if(dataspaceID < 0)
+  {
+    CloseH5T(dataType, error, returnError);
+    return static_cast<herr_t>(dataspaceID);
+  }
+  hid_t datasetID = H5Dcreate(locationID, datasetName.c_str(), dataType, dataspaceID, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+  if(datasetID >= 0)
+  {
+    error = H5Dwrite(datasetID, dataType, H5S_ALL, H5S_ALL, H5P_DEFAULT, narrowed.data());
+    H5SUPPORT_INSTRUMENT_BYTES(error, narrowed.size())
+    if(error < 0)
+    {
+      std::cout << "Error Writing Data '" << datasetName << "'" << std::endl;
+      returnError = error;
+    }
+    CloseH5D(datasetID, error, returnError, datasetName);
+  }
+  else
+  {
+    returnError = static_cast<herr_t>(datasetID);
+  }
+  CloseH5S(dataspaceID, error, returnError);
+  CloseH5T(dataType, error, returnError);
+  return returnError;
+}
+
+/**
+ * @brief Writes a std::vector as a dataset, storing it in a narrower floating point type
+ * @param locationID The hdf5 object id of the parent
+ * @param datasetName The name of the dataset to write to
+ * @param dims The sizes of each dimension
+ * @param data The data to be written
+ * @param precision The type to store
+ * @return Standard hdf5 error condition.
+ */
+template <typename T>
+inline herr_t writeVectorDataset(hid_t locationID, const std::string& datasetName, const std::vector<hsize_t>& dims, const std::vector<T>& data, H5StoragePrecision precision)
+{
+  return writePointerDataset(locationID, datasetName, static_cast<int32_t>(dims.size()), dims.data(), data.data(), precision);
+}
+
+/**
+ * @brief Reads a whole dataset into T. Datasets stored as Float16, BFloat16, or as Float32 when
+ * T is double, are read in their stored size and widened by widenValues(); anything else is
+ * read with a plain H5Dread.
+ * @param locationID The parent location that contains the dataset to read
+ * @param datasetName The name of the dataset to read
+ * @param data The buffer, as many elements as the dataset
+ * @return Standard hdf5 error condition.
+ */
+template <typename T> inline herr_t readPointerDatasetWidened(hid_t locationID, const std::string& datasetName, T* data)
+{
+  static_assert(std::is_floating_point<T>::value, "Only floating point data can be widened");
+
+  H5SUPPORT_MUTEX_LOCK_SHARED()
+
+  herr_t error = 0;
+  herr_t returnError = 0;
+  if(nullptr == data)
+  {
+    return -2;
+  }
+  hid_t datasetID = H5Dopen(locationID, datasetName.c_str(), H5P_DEFAULT);
+  if(datasetID < 0)
+  {
+    std::cout << "H5LiteReducedPrecision.h::readPointerDatasetWidened(" << __LINE__ << ") Error opening Dataset at locationID (" << locationID << ") with object name (" << datasetName << ")"
+              << std::endl;
+    return -1;
+  }
+  hid_t fileTypeID = H5Dget_type(datasetID);
+  H5StoragePrecision precision = (fileTypeID < 0) ? H5StoragePrecision::Native : getStoragePrecision(fileTypeID);
+  if(precision == H5StoragePrecision::Float32 && std::is_same<T, float>::value)
+  {
+    precision = H5StoragePrecision::Native;
+  }
+  if(precision == H5StoragePrecision::Native)
+  {
+    error = H5Dread(datasetID, H5TypeTraits<T>::type(), H5S_ALL, H5S_ALL, H5P_DEFAULT, data);
+    H5SUPPORT_INSTRUMENT_BYTES(error, H5Instrumentation::datasetBytes(datasetID, H5TypeTraits<T>::type()))
+  }
+  else
+  {
+    hid_t dataspaceID = H5Dget_space(datasetID);
+    hssize_t numElements = (dataspaceID < 0) ? -1 : H5Sget_simple_extent_npoints(dataspaceID);
+    hid_t memTypeID = createStoragePrecisionType(precision);
+    error = (numElements < 0 || memTypeID < 0) ? -1 : 0;
+    if(error >= 0)
+    {
+      UninitializedVector<uint8_t> narrowed(static_cast<size_t>(numElements) * getStoragePrecisionSize(precision));
+      error = H5Dread(datasetID, memTypeID, H5S_ALL, H5S_ALL, H5P_DEFAULT, narrowed.data());
+      H5SUPPORT_INSTRUMENT_BYTES(error, narrowed.size())
+      if(error >= 0 && !widenValues(narrowed.data(), narrowed.size(), static_cast<size_t>(numElements), precision, data))
+      {
+        error = -1;
+      }
+    }
+    herr_t closeError = 0;
+    if(memTypeID >= 0)
+    {
+      CloseH5T(memTypeID, closeError, returnError);
+    }
+    if(dataspaceID >= 0)
+    {
+      CloseH5S(dataspaceID, closeError, returnError);
+    }
+  }
+  if(error < 0)
+  {
+    std::cout << "Error Reading Data '" << datasetName << "'" << std::endl;
+    returnError = error;
+  }
+  if(fileTypeID >= 0)
+  {
+    CloseH5T(fileTypeID, error, returnError);
+  }
+  CloseH5D(datasetID, error, returnError, datasetName);
+  return returnError;
+}
+
+/**
+ * @brief Reads a whole dataset into a std::vector of T, widening reduced precision storage
+ * @param locationID The parent location that contains the dataset to read
+ * @param datasetName The name of the dataset to read
+ * @param data The vector WILL be resized to the number of elements of the dataset
+ * @return Standard hdf5 error condition.
+ */
+template <typename T, typename Allocator> inline herr_t readVectorDatasetWidened(hid_t locationID, const std::string& datasetName, std::vector<T, Allocator>& data)
+{
+  H5SUPPORT_MUTEX_LOCK_SHARED()
+
+  std::vector<hsize_t> dims;
+  H5T_class_t classType = H5T_NO_CLASS;
+  size_t typeSize = 0;
+  herr_t error = getDatasetInfo(locationID, datasetName, dims, classType, typeSize);
+  if(error < 0)
+  {
+    return error;
+  }
+  data.resize(std::accumulate(dims.cbegin(), dims.cend(), static_cast<size_t>(1), std::multiplies<size_t>()));
+  return readPointerDatasetWidened(locationID, datasetName, data.data());
+}
+} // namespace H5Lite
+
+#if defined(H5Support_NAMESPACE)
+}
+#endif
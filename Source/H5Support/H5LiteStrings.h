@@ -0,0 +1,519 @@
+/* ============================================================================
+ * Copyright (c) 2007-2019 BlueQuartz Software, LLC
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+ * contributors may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The code contained herein was partially funded by the followig contracts:
+ *    United States Air Force Prime Contract FA8650-04-C-5229
+ *    United States Air Force Prime Contract FA8650-15-D-5231
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <new>
+#include <string>
+#include <vector>
+
+#include <hdf5.h>
+
+#include "H5Support/H5DefaultInitAllocator.h"
+#include "H5Support/H5Lite.h"
+#include "H5Support/H5Macros.h"
+#include "H5Support/H5Support.h"
+
+#if defined(H5Support_NAMESPACE)
+namespace H5Support_NAMESPACE
+{
+#endif
+
+/**
+ * @brief The H5StringArena struct holds a list of strings packed into one character
+ * buffer. String i starts at chars[offsets[i]], is null terminated and is
+ * offsets[i + 1] - offsets[i] - 1 characters long, so offsets holds size() + 1 entries.
+ */
+struct H5StringArena
+{
+  UninitializedVector<char> chars;
+  std::vector<size_t> offsets;
+
+  size_t size() const
+  {
+    return offsets.empty() ? 0 : offsets.size() - 1;
+  }
+
+  bool empty() const
+  {
+    return size() == 0;
+  }
+
+  void clear()
+  {
+    chars.clear();
+    offsets.clear();
+  }
+
+  /**
+   * @brief Returns the null terminated string at index
+   * @param index
+   * @return
+   */
+  const char* c_str(size_t index) const
+  {
+    return chars.data() + offsets[index];
+  }
+
+  /**
+   * @brief Returns the number of characters of the string at index, without the null terminator
+   * @param index
+   * @return
+   */
+  size_t length(size_t index) const
+  {
+    return offsets[index + 1] - offsets[index] - 1;
+  }
+
+  /**
+   * @brief Returns a copy of the string at index
+   * @param index
+   * @return
+   */
+  std::string str(size_t index) const
+  {
+    return std::string(c_str(index), length(index));
+  }
+};
+
+/**
+ * @brief The H5FixedStringBuffer struct holds strings of a fixed length string dataset
+ * exactly as stored: size() entries of width characters each, padded with null
+ * characters. A string that fills the whole width has no null terminator.
+ */
+struct H5FixedStringBuffer
+{
+  size_t width = 0;
+  UninitializedVector<char> chars;
+
+  size_t size() const
+  {
+    return width == 0 ? 0 : chars.size() / width;
+  }
+
+  bool empty() const
+  {
+    return size() == 0;
+  }
+
+  /**
+   * @brief Returns the first character of the string at index. Not null terminated when
+   * the string fills the whole width.
+   * @param index
+   * @return
+   */
+  const char* data(size_t index) const
+  {
+    return chars.data() + index * width;
+  }
+
+  /**
+   * @brief Returns the number of characters of the string at index
+   * @param index
+   * @return
+   */
+  size_t length(size_t index) const
+  {
+    return strnlen(data(index), width);
+  }
+
+  /**
+   * @brief Returns a copy of the string at index
+   * @param index
+   * @return
+   */
+  std::string str(size_t index) const
+  {
+    return std::string(data(index), length(index));
+  }
+};
+
+namespace H5Lite
+{
+constexpr size_t k_StringArenaBytesPerString = 32;
+constexpr size_t k_StringArenaMinBlock = 4096;
+
+/**
+ * @brief Variable length memory manager that hands out consecutive pieces of a few large
+ * blocks, each twice the size of the previous one. Nothing is freed piecewise; the blocks
+ * go away with the allocator.
+ */
+struct StringArenaAllocator
+{
+  std::vector<UninitializedVector<char>> blocks;
+  size_t used = 0;
+  size_t nextBlockSize = 0;
+
+  static void* allocate(size_t size, void* info)
+  {
+    auto* arena = static_cast<StringArenaAllocator*>(info);
+    if(arena->blocks.empty() || arena->used + size > arena->blocks.back().size())
+    {
+      size_t blockSize = std::max(size, arena->nextBlockSize);
+      try
+      {
+        arena->blocks.emplace_back(blockSize);
+      } catch(const std::bad_alloc&)
+      {
+        return nullptr;
+      }
+      arena->nextBlockSize = blockSize * 2;
+      arena->used = 0;
+    }
+    void* memory = arena->blocks.back().data() + arena->used;
+    arena->used += size;
+    return memory;
+  }
+
+  static void release(void* /*memory*/, void* /*info*/)
+  {
+  }
+};
+
+/**
+ * @brief Reads a string dataset of any rank into an H5StringArena. Variable length strings
+ * are decoded by HDF5 directly into a block arena through a custom variable length memory
+ * manager, so there is no per string heap allocation and no H5Dvlen_reclaim. When the
+ * first block is large enough it becomes the result without another copy, unless most of
+ * it went unused, in which case the characters are moved to an exactly sized buffer. Fixed
+ * length strings are read in one block and trimmed at the first null character.
+ * @param locationID The parent location that contains the dataset to read
+ * @param datasetName The name of the dataset to read
+ * @param data The arena, which is replaced
+ * @return Standard HDF error condition
+ */
+inline herr_t readStringArenaDataset(hid_t locationID, const std::string& datasetName, H5StringArena& data)
+{
+  H5SUPPORT_MUTEX_LOCK_SHARED()
+
+  herr_t error = 0;
+  herr_t returnError = 0;
+  data.clear();
+
+  hid_t datasetID = H5Dopen(locationID, datasetName.c_str(), H5P_DEFAULT);
+  if(datasetID < 0)
+  {
+    std::cout << "H5LiteStrings.h::readStringArenaDataset(" << __LINE__ << ") Error opening Dataset at locationID (" << locationID << ") with object name (" << datasetName << ")" << std::endl;
+    return -1;
+  }
+  hid_t typeID = H5Dget_type(datasetID);
+  hid_t dataspaceID = H5Dget_space(datasetID);
+  hssize_t numElements = (dataspaceID < 0) ? -1 : H5Sget_simple_extent_npoints(dataspaceID);
+  if(typeID < 0 || numElements < 0 || H5Tget_class(typeID) != H5T_STRING)
+  {
+    std::cout << "H5LiteStrings.h::readStringArenaDataset(" << __LINE__ << ") '" << datasetName << "' is not a string dataset" << std::endl;
+    returnError = -2;
+  }
+  else if(H5Tis_variable_str(typeID) > 0)
+  {
+    hid_t memType = H5Tcopy(H5T_C_S1);
+    H5Tset_size(memType, H5T_VARIABLE);
+
+    std::vector<char*> strings(static_cast<size_t>(numElements), nullptr);
+    StringArenaAllocator arena;
+    arena.nextBlockSize = std::max(static_cast<size_t>(numElements) * k_StringArenaBytesPerString, k_StringArenaMinBlock);
+    hid_t transferID = H5Pcreate(H5P_DATASET_XFER);
+    returnError = (transferID < 0) ? static_cast<herr_t>(transferID) : H5Pset_vlen_mem_manager(transferID, StringArenaAllocator::allocate, &arena, StringArenaAllocator::release, &arena);
+    if(returnError >= 0 && !strings.empty())
+    {
+      returnError = H5Dread(datasetID, memType, H5S_ALL, H5S_ALL, transferID, strings.data());
+    }
+    if(returnError >= 0)
+    {
+      data.offsets.resize(strings.size() + 1);
+      data.offsets[0] = 0;
+      for(size_t i = 0; i < strings.size(); ++i)
+      {
+        data.offsets[i + 1] = data.offsets[i] + (strings[i] == nullptr ? 0 : std::strlen(strings[i])) + 1;
+      }
+      H5SUPPORT_INSTRUMENT_BYTES(returnError, data.offsets.back())
+
+      // HDF5 fills the arena front to back, so when everything fit in the first block the
+      // strings already sit packed in order and the block becomes the result
+      bool packed = arena.blocks.size() == 1;
+      for(size_t i = 0; packed && i < strings.size(); ++i)
+      {
+        packed = strings[i] == arena.blocks.front().data() + data.offsets[i];
+      }
+      if(packed)
+      {
+        data.chars.swap(arena.blocks.front());
+        data.chars.resize(data.offsets.back());
+        // The first block is sized for k_StringArenaBytesPerString per string, which short
+        // strings leave mostly empty
+        if(data.chars.capacity() / 2 > data.chars.size())
+        {
+          data.chars.shrink_to_fit();
+        }
+      }
+      else
+      {
+        data.chars.resize(data.offsets.back());
+        for(size_t i = 0; i < strings.size(); ++i)
+        {
+          size_t length = data.offsets[i + 1] - data.offsets[i] - 1;
+          if(length > 0)
+          {
+            std::memcpy(data.chars.data() + data.offsets[i], strings[i], length);
+          }
+          data.chars[data.offsets[i + 1] - 1] = '\0';
+        }
+      }
+    }
+    else
+    {
+      std::cout << "H5LiteStrings.h::readStringArenaDataset(" << __LINE__ << ") Error reading Dataset at locationID (" << locationID << ") with object name (" << datasetName << ")" << std::endl;
+      data.clear();
+    }
+    if(transferID >= 0)
+    {
+      H5Pclose(transferID);
+    }
+    CloseH5T(memType, error, returnError);
+  }
+  else
+  {
+    size_t typeSize = H5Tget_size(typeID);
+    UninitializedVector<char> buffer(static_cast<size_t>(numElements) * typeSize);
+    if(!buffer.empty())
+    {
+      returnError = H5Dread(datasetID, typeID, H5S_ALL, H5S_ALL, H5P_DEFAULT, buffer.data());
+      H5SUPPORT_INSTRUMENT_BYTES(returnError, buffer.size())
+    }
+    if(returnError >= 0)
+    {
+      data.offsets.resize(static_cast<size_t>(numElements) + 1);
+      data.offsets[0] = 0;
+      for(size_t i = 0; i < static_cast<size_t>(numElements); ++i)
+      {
+        data.offsets[i + 1] = data.offsets[i] + strnlen(buffer.data() + i * typeSize, typeSize) + 1;
+      }
+      data.chars.resize(data.offsets.back());
+      for(size_t i = 0; i < static_cast<size_t>(numElements); ++i)
+      {
+        size_t length = data.offsets[i + 1] - data.offsets[i] - 1;
+        std::memcpy(data.chars.data() + data.offsets[i], buffer.data() + i * typeSize, length);
+        data.chars[data.offsets[i + 1] - 1] = '\0';
+      }
+    }
+    else
+    {
+      std::cout << "H5LiteStrings.h::readStringArenaDataset(" << __LINE__ << ") Error reading Dataset at locationID (" << locationID << ") with object name (" << datasetName << ")" << std::endl;
+    }
+  }
+
+  if(dataspaceID >= 0)
+  {
+    CloseH5S(dataspaceID, error, returnError);
+  }
+  if(typeID >= 0)
+  {
+    CloseH5T(typeID, error, returnError);
+  }
+  CloseH5D(datasetID, error, returnError, datasetName);
+  return returnError;
+}
+
+/**
+ * @brief Writes strings to a one dimensional fixed length string dataset (H5T_C_S1, null
+ * padded). The width is the length of the longest string. Unlike variable length strings
+ * the characters are stored in the dataset itself, so chunked storage compresses them.
+ * @param locationID The parent location for the dataset
+ * @param datasetName The name of the dataset
+ * @param data The strings to write
+ * @param chunkSize The number of strings per chunk. 0 writes a contiguous dataset unless
+ * compression is requested, in which case a chunk size is guessed.
+ * @param compressionLevel The deflate level (0 = no compression, 1-9)
+ * @return Standard HDF5 error conditions
+ */
+inline herr_t writeFixedLengthStringsDataset(hid_t locationID, const std::string& datasetName, const std::vector<std::string>& data, hsize_t chunkSize = 0, int32_t compressionLevel = 0)
+{
+  H5SUPPORT_MUTEX_LOCK()
+
+  herr_t error = 0;
+  herr_t returnError = 0;
+
+  size_t width = 1;
+  for(const auto& element : data)
+  {
+    width = std::max(width, element.size());
+  }
+  std::vector<char> buffer(data.size() * width, '\0');
+  for(size_t i = 0; i < data.size(); ++i)
+  {
+    std::memcpy(buffer.data() + i * width, data[i].data(), data[i].size());
+  }
+
+  hid_t typeID = H5Tcopy(H5T_C_S1);
+  if(typeID < 0)
+  {
+    return static_cast<herr_t>(typeID);
+  }
+  H5Tset_size(typeID, width);
+  H5Tset_strpad(typeID, H5T_STR_NULLPAD);
+
+  hsize_t dims = data.size();
+  hid_t dataspaceID = H5Screate_simple(1, &dims, nullptr);
+  hid_t propertyListID = H5P_DEFAULT;
+  if(compressionLevel > 0 && chunkSize == 0 && !data.empty())
+  {
+    chunkSize = guessChunkSize(1, &dims, width).front();
+  }
+  if(chunkSize > 0 && !data.empty())
+  {
+    hsize_t chunkDims = std::min(chunkSize, dims);
+    propertyListID = H5Pcreate(H5P_DATASET_CREATE);
+    error = H5Pset_chunk(propertyListID, 1, &chunkDims);
+    if(error >= 0 && compressionLevel > 0)
+    {
+#ifdef H5_HAVE_FILTER_DEFLATE
+      error = H5Pset_deflate(propertyListID, static_cast<uint32_t>(compressionLevel));
+#else
+      std::cout << "Deflate compression is not available in this HDF5 library" << std::endl;
+      error = -1;
+#endif
+    }
+    if(error < 0)
+    {
+      std::cout << "Error setting up the chunked storage of '" << datasetName << "'" << std::endl;
+      returnError = error;
+    }
+  }
+
+  if(dataspaceID < 0)
+  {
+    returnError = static_cast<herr_t>(dataspaceID);
+  }
+  else if(returnError >= 0)
+  {
+    hid_t datasetID = H5Dcreate(locationID, datasetName.c_str(), typeID, dataspaceID, H5P_DEFAULT, propertyListID, H5P_DEFAULT);
+    if(datasetID >= 0)
+    {
+      if(!buffer.empty())
+      {
+        error = H5Dwrite(datasetID, typeID, H5S_ALL, H5S_ALL, H5P_DEFAULT, buffer.data());
+        H5SUPPORT_INSTRUMENT_BYTES(error, buffer.size())
+        if(error < 0)
+        {
+          std::cout << "Error Writing String Data: " __FILE__ << "(" << __LINE__ << ")" << std::endl;
+          returnError = error;
+        }
+      }
+      CloseH5D(datasetID, error, returnError, datasetName);
+    }
+    else
+    {
+      std::cout << "Error Creating Dataset '" << datasetName << "'" << std::endl;
+      returnError = static_cast<herr_t>(datasetID);
+    }
+  }
+  if(propertyListID != H5P_DEFAULT)
+  {
+    H5Pclose(propertyListID);
+  }
+  if(dataspaceID >= 0)
+  {
+    CloseH5S(dataspaceID, error, returnError);
+  }
+  CloseH5T(typeID, error, returnError);
+  return returnError;
+}
+
+/**
+ * @brief Reads a fixed length string dataset of any rank into one flat buffer with a
+ * single H5Dread
+ * @param locationID The parent location that contains the dataset to read
+ * @param datasetName The name of the dataset to read
+ * @param data The buffer, which is replaced
+ * @return Standard HDF error condition. -2 if the dataset does not hold fixed length strings.
+ */
+inline herr_t readFixedLengthStringsDataset(hid_t locationID, const std::string& datasetName, H5FixedStringBuffer& data)
+{
+  H5SUPPORT_MUTEX_LOCK_SHARED()
+
+  herr_t error = 0;
+  herr_t returnError = 0;
+  data.width = 0;
+  data.chars.clear();
+
+  hid_t datasetID = H5Dopen(locationID, datasetName.c_str(), H5P_DEFAULT);
+  if(datasetID < 0)
+  {
+    std::cout << "H5LiteStrings.h::readFixedLengthStringsDataset(" << __LINE__ << ") Error opening Dataset at locationID (" << locationID << ") with object name (" << datasetName << ")" << std::endl;
+    return -1;
+  }
+  hid_t typeID = H5Dget_type(datasetID);
+  hid_t dataspaceID = H5Dget_space(datasetID);
+  hssize_t numElements = (dataspaceID < 0) ? -1 : H5Sget_simple_extent_npoints(dataspaceID);
+  if(typeID < 0 || numElements < 0 || H5Tget_class(typeID) != H5T_STRING || H5Tis_variable_str(typeID) != 0)
+  {
+    std::cout << "H5LiteStrings.h::readFixedLengthStringsDataset(" << __LINE__ << ") '" << datasetName << "' is not a fixed length string dataset" << std::endl;
+    returnError = -2;
+  }
+  else
+  {
+    data.width = H5Tget_size(typeID);
+    data.chars.resize(static_cast<size_t>(numElements) * data.width);
+    if(!data.chars.empty())
+    {
+      returnError = H5Dread(datasetID, typeID, H5S_ALL, H5S_ALL, H5P_DEFAULT, data.chars.data());
+      H5SUPPORT_INSTRUMENT_BYTES(returnError, data.chars.size())
+      if(returnError < 0)
+      {
+        std::cout << "H5LiteStrings.h::readFixedLengthStringsDataset(" << __LINE__ << ") Error reading Dataset at locationID (" << locationID << ") with object name (" << datasetName << ")"
+                  << std::endl;
+        data.chars.clear();
+      }
+    }
+  }
+
+  if(dataspaceID >= 0)
+  {
+    CloseH5S(dataspaceID, error, returnError);
+  }
+  if(typeID >= 0)
+  {
+    CloseH5T(typeID, error, returnError);
+  }
+  CloseH5D(datasetID, error, returnError, datasetName);
+  return returnError;
+}
+} // namespace H5Lite
+
+#if defined(H5Support_NAMESPACE)
+}
+#endif
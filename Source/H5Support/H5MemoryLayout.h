@@ -0,0 +1,513 @@
+/* ============================================================================
+ * Copyright (c) 2007-2019 BlueQuartz Software, LLC
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+ * contributors may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The code contained herein was partially funded by the followig contracts:
+ *    United States Air Force Prime Contract FA8650-04-C-5229
+ *    United States Air Force Prime Contract FA8650-15-D-5231
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#pragma once
+
+#include <algorithm>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <hdf5.h>
+
+#include "H5Support/H5Instrumentation.h"
+#include "H5Support/H5Macros.h"
+#include "H5Support/H5Support.h"
+#include "H5Support/H5SupportMutex.h"
+#include "H5Support/H5TypeTraits.h"
+
+#if defined(H5Support_NAMESPACE)
+namespace H5Support_NAMESPACE
+{
+#endif
+
+/**
+ * @brief The H5MemoryLayout struct describes where each element of a dataset lives inside a
+ * caller owned buffer. Element (i0, i1, ..., iN) of the dataset is found at
+ * buffer[offset + i0 * strides[0] + ... + iN * strides[N]], counted in elements of the
+ * buffer type. An empty strides vector means a packed C ordered buffer.
+ *
+ * H5Lite::writePointerDatasetWithLayout() and H5Lite::readPointerDatasetWithLayout() turn the
+ * layout into a memory dataspace selection so HDF5 gathers from / scatters into the buffer
+ * directly instead of going through a packed temporary.
+ * @code
+ * // Write the Y component of an interleaved XYZ array of numPoints points
+ * H5MemoryLayout layout = H5MemoryLayout::Interleaved(1, &numPoints, 3, 1);
+ * H5Lite::writePointerDatasetWithLayout(fileID, "Y", 1, &numPoints, xyz.data(), layout);
+ * @endcode
+ */
+struct H5MemoryLayout
+{
+  std::vector<hsize_t> strides;
+  hsize_t offset = 0;
+
+  /**
+   * @brief Returns the layout of a packed C ordered (row major) buffer
+   * @param rank
+   * @param dims
+   * @return
+   */
+  static H5MemoryLayout RowMajor(int32_t rank, const hsize_t* dims)
+  {
+    return Interleaved(rank, dims, 1, 0);
+  }
+
+  /**
+   * @brief Returns the layout of a packed Fortran ordered (column major) buffer, where the
+   * first dimension of the dataset varies fastest in memory
+   * @param rank
+   * @param dims
+   * @return
+   */
+  static H5MemoryLayout ColumnMajor(int32_t rank, const hsize_t* dims)
+  {
+    H5MemoryLayout layout;
+    layout.strides.resize(static_cast<size_t>(rank));
+    hsize_t stride = 1;
+    for(int32_t i = 0; i < rank; ++i)
+    {
+      layout.strides[i] = stride;
+      stride *= dims[i];
+    }
+    return layout;
+  }
+
+  /**
+   * @brief Returns the layout of a single component inside a C ordered buffer that holds
+   * componentCount interleaved values per element, such as the X of an XYZ array
+   * @param rank
+   * @param dims The dimensions of the dataset, without the component dimension
+   * @param componentCount The number of values stored per element
+   * @param componentIndex The component to transfer
+   * @return
+   */
+  static H5MemoryLayout Interleaved(int32_t rank, const hsize_t* dims, hsize_t componentCount, hsize_t componentIndex)
+  {
+    H5MemoryLayout layout;
+    layout.strides.resize(static_cast<size_t>(rank));
+    hsize_t stride = componentCount;
+    for(int32_t i = rank - 1; i >= 0; --i)
+    {
+      layout.strides[i] = stride;
+      stride *= dims[i];
+    }
+    layout.offset = componentIndex;
+    return layout;
+  }
+
+  /**
+   * @brief Returns the strides to use for a dataset of the given rank, filling in the
+   * packed C ordered strides when none were given
+   * @param rank
+   * @param dims
+   * @return
+   */
+  std::vector<hsize_t> getStrides(int32_t rank, const hsize_t* dims) const
+  {
+    if(strides.empty())
+    {
+      return RowMajor(rank, dims).strides;
+    }
+    return strides;
+  }
+
+  /**
+   * @brief Returns the number of buffer elements the layout touches, i.e. one past the
+   * largest index it addresses
+   * @param rank
+   * @param dims
+   * @return
+   */
+  hsize_t getRequiredElements(int32_t rank, const hsize_t* dims) const
+  {
+    std::vector<hsize_t> layoutStrides = getStrides(rank, dims);
+    hsize_t last = offset;
+    for(int32_t i = 0; i < rank; ++i)
+    {
+      if(dims[i] == 0)
+      {
+        return 0;
+      }
+      last += (dims[i] - 1) * layoutStrides[i];
+    }
+    return last + 1;
+  }
+};
+
+namespace H5Lite
+{
+/**
+ * @brief The number of elements a layout that can not be described by a single hyperslab
+ * moves per H5Dread / H5Dwrite. Each element costs one hsize_t of point coordinates.
+ */
+static const hsize_t k_LayoutPointBatch = 65536;
+
+/**
+ * @brief Creates a memory dataspace whose hyperslab selection visits the buffer elements of
+ * the layout in C order of the dataset. That is possible when every stride is a multiple of
+ * the next one and the dimensions nest without overlapping: the buffer is then viewed as an
+ * array of rank + 1 dimensions of sizes {dims[0], strides[0] / strides[1], ..., strides[rank - 1]}.
+ * @param rank The rank of the dataset
+ * @param dims The dimensions of the dataset
+ * @param layout
+ * @param memSpaceID Receives the memory dataspace, or -1 if the layout needs a point selection
+ * @return Standard hdf5 error condition. 1 means the layout is valid but is not a hyperslab.
+ */
+inline herr_t createLayoutMemorySpace(int32_t rank, const hsize_t* dims, const H5MemoryLayout& layout, hid_t& memSpaceID)
+{
+  H5SUPPORT_MUTEX_LOCK_SHARED()
+
+  memSpaceID = -1;
+  std::vector<hsize_t> strides = layout.getStrides(rank, dims);
+  if(rank <= 0 || strides.size() != static_cast<size_t>(rank))
+  {
+    std::cout << "H5MemoryLayout.h::createLayoutMemorySpace(" << __LINE__ << ") The layout has " << strides.size() << " strides for a dataset of rank " << rank << std::endl;
+    return -2;
+  }
+  for(int32_t i = 0; i < rank; ++i)
+  {
+    if(strides[i] == 0)
+    {
+      std::cout << "H5MemoryLayout.h::createLayoutMemorySpace(" << __LINE__ << ") Stride " << i << " of the layout is zero" << std::endl;
+      return -2;
+    }
+  }
+
+  std::vector<hsize_t> memDims(static_cast<size_t>(rank + 1));
+  memDims[rank] = strides[rank - 1];
+  for(int32_t i = 1; i < rank; ++i)
+  {
+    if(strides[i - 1] % strides[i] != 0 || strides[i - 1] / strides[i] < dims[i])
+    {
+      return 1;
+    }
+    memDims[i] = strides[i - 1] / strides[i];
+  }
+
+  // Split the offset into coordinates of the rank + 1 view; the slab must not wrap around
+  std::vector<hsize_t> start(static_cast<size_t>(rank + 1));
+  std::vector<hsize_t> count(dims, dims + rank);
+  count.push_back(1);
+  hsize_t remainder = layout.offset;
+  for(int32_t i = rank; i > 0; --i)
+  {
+    start[i] = remainder % memDims[i];
+    remainder /= memDims[i];
+    if(i < rank && start[i] + dims[i] > memDims[i])
+    {
+      return 1;
+    }
+  }
+  start[0] = remainder;
+  memDims[0] = start[0] + dims[0];
+
+  memSpaceID = H5Screate_simple(rank + 1, memDims.data(), nullptr);
+  if(memSpaceID < 0)
+  {
+    std::cout << "H5MemoryLayout.h::createLayoutMemorySpace(" << __LINE__ << ") Error creating the memory dataspace" << std::endl;
+    return static_cast<herr_t>(memSpaceID);
+  }
+  herr_t error = H5Sselect_hyperslab(memSpaceID, H5S_SELECT_SET, start.data(), nullptr, count.data(), nullptr);
+  if(error < 0)
+  {
+    std::cout << "H5MemoryLayout.h::createLayoutMemorySpace(" << __LINE__ << ") Error selecting the layout hyperslab" << std::endl;
+    H5Sclose(memSpaceID);
+    memSpaceID = -1;
+  }
+  return error;
+}
+
+/**
+ * @brief Does the work of transferDatasetWithLayout(). The caller holds the lock.
+ * Layouts that form a hyperslab go through a single H5Dwrite / H5Dread. Any other layout (column
+ * major, for example) is moved in slabs of at most k_LayoutPointBatch elements whose buffer
+ * addresses are listed as a point selection, which HDF5 visits in the listed order.
+ */
+inline herr_t transferDatasetWithLayoutLocked(hid_t datasetID, hid_t memTypeID, int32_t rank, const hsize_t* dims, const H5MemoryLayout& layout, void* data, bool write)
+{
+  // An empty dataset has nothing to move, and the batching below needs non zero extents
+  if(std::find(dims, dims + rank, 0) != dims + rank)
+  {
+    return 0;
+  }
+  herr_t error = 0;
+  herr_t returnError = 0;
+  hid_t memSpaceID = -1;
+  herr_t layoutError = createLayoutMemorySpace(rank, dims, layout, memSpaceID);
+  if(layoutError < 0)
+  {
+    return layoutError;
+  }
+  if(layoutError == 0)
+  {
+    error = write ? H5Dwrite(datasetID, memTypeID, memSpaceID, H5S_ALL, H5P_DEFAULT, data) : H5Dread(datasetID, memTypeID, memSpaceID, H5S_ALL, H5P_DEFAULT, data);
+    if(error < 0)
+    {
+      std::cout << "H5MemoryLayout.h::transferDatasetWithLayout(" << __LINE__ << ") Error " << (write ? "writing" : "reading") << " the dataset" << std::endl;
+      returnError = error;
+    }
+    CloseH5S(memSpaceID, error, returnError);
+    return returnError;
+  }
+
+  // Slab over the outer dimensions so each batch covers whole rows of the inner ones
+  std::vector<hsize_t> strides = layout.getStrides(rank, dims);
+  int32_t split = rank - 1;
+  hsize_t innerCount = 1;
+  while(split > 0 && innerCount * dims[split] <= k_LayoutPointBatch)
+  {
+    innerCount *= dims[split];
+    --split;
+  }
+  hsize_t rowsPerBatch = std::max<hsize_t>(1, k_LayoutPointBatch / innerCount);
+
+  // Buffer offsets of the inner dimensions, in C order
+  std::vector<hsize_t> innerOffsets(innerCount, 0);
+  for(hsize_t n = 0; n < innerCount; ++n)
+  {
+    hsize_t index = n;
+    for(int32_t i = rank - 1; i > split; --i)
+    {
+      innerOffsets[n] += (index % dims[i]) * strides[i];
+      index /= dims[i];
+    }
+  }
+
+  hsize_t memExtent = layout.getRequiredElements(rank, dims);
+  hid_t fileSpaceID = H5Dget_space(datasetID);
+  memSpaceID = H5Screate_simple(1, &memExtent, nullptr);
+  if(fileSpaceID < 0 || memSpaceID < 0)
+  {
+    std::cout << "H5MemoryLayout.h::transferDatasetWithLayout(" << __LINE__ << ") Error creating the dataspaces" << std::endl;
+    returnError = -1;
+  }
+
+  std::vector<hsize_t> start(static_cast<size_t>(rank), 0);
+  std::vector<hsize_t> count(dims, dims + rank);
+  std::fill(count.begin(), count.begin() + split, 1);
+  std::vector<hsize_t> points;
+  points.reserve(std::min<hsize_t>(rowsPerBatch, dims[split]) * innerCount);
+  bool done = (returnError < 0);
+  while(!done)
+  {
+    hsize_t outerOffset = layout.offset;
+    for(int32_t i = 0; i < split; ++i)
+    {
+      outerOffset += start[i] * strides[i];
+    }
+    for(hsize_t row = 0; row < dims[split] && returnError >= 0; row += rowsPerBatch)
+    {
+      start[split] = row;
+      count[split] = std::min(rowsPerBatch, dims[split] - row);
+      points.clear();
+      for(hsize_t r = 0; r < count[split]; ++r)
+      {
+        hsize_t rowOffset = outerOffset + (row + r) * strides[split];
+        for(hsize_t innerOffset : innerOffsets)
+        {
+          points.push_back(rowOffset + innerOffset);
+        }
+      }
+      error = H5Sselect_hyperslab(fileSpaceID, H5S_SELECT_SET, start.data(), nullptr, count.data(), nullptr);
+      if(error >= 0)
+      {
+        error = H5Sselect_elements(memSpaceID, H5S_SELECT_SET, points.size(), points.data());
+      }
+      if(error >= 0)
+      {
+        error = write ? H5Dwrite(datasetID, memTypeID, memSpaceID, fileSpaceID, H5P_DEFAULT, data) : H5Dread(datasetID, memTypeID, memSpaceID, fileSpaceID, H5P_DEFAULT, data);
+      }
+      if(error < 0)
+      {
+        std::cout << "H5MemoryLayout.h::transferDatasetWithLayout(" << __LINE__ << ") Error " << (write ? "writing" : "reading") << " the dataset" << std::endl;
+        returnError = error;
+      }
+    }
+    // Advance the outer dimensions like an odometer
+    done = true;
+    for(int32_t i = split - 1; i >= 0 && returnError >= 0; --i)
+    {
+      if(++start[i] < dims[i])
+      {
+        done = false;
+        break;
+      }
+      start[i] = 0;
+    }
+  }
+
+  if(memSpaceID >= 0)
+  {
+    CloseH5S(memSpaceID, error, returnError);
+  }
+  if(fileSpaceID >= 0)
+  {
+    CloseH5S(fileSpaceID, error, returnError);
+  }
+  return returnError;
+}
+
+/**
+ * @brief Moves the whole of an open dataset to or from a buffer described by a memory layout.
+ * Writes take the exclusive lock and reads the shared one.
+ * @param datasetID
+ * @param memTypeID The HDF5 type of the buffer elements
+ * @param rank The rank of the dataset
+ * @param dims The dimensions of the dataset
+ * @param layout
+ * @param data The buffer
+ * @param write True to write the buffer into the dataset, false to read the dataset into the buffer
+ * @return Standard hdf5 error condition.
+ */
+inline herr_t transferDatasetWithLayout(hid_t datasetID, hid_t memTypeID, int32_t rank, const hsize_t* dims, const H5MemoryLayout& layout, void* data, bool write)
+{
+  if(write)
+  {
+    H5SUPPORT_MUTEX_LOCK()
+    herr_t error = transferDatasetWithLayoutLocked(datasetID, memTypeID, rank, dims, layout, data, write);
+    H5SUPPORT_INSTRUMENT_BYTES(error, H5Instrumentation::datasetBytes(datasetID, memTypeID))
+    return error;
+  }
+  H5SUPPORT_MUTEX_LOCK_SHARED()
+  herr_t error = transferDatasetWithLayoutLocked(datasetID, memTypeID, rank, dims, layout, data, write);
+  H5SUPPORT_INSTRUMENT_BYTES(error, H5Instrumentation::datasetBytes(datasetID, memTypeID))
+  return error;
+}
+
+/**
+ * @brief Creates a dataset and writes it from a buffer described by a memory layout, such
+ * as one component of an interleaved array or a column major array
+ * @param locationID The hdf5 object id of the parent
+ * @param datasetName The name of the dataset to create
+ * @param rank The number of dimensions
+ * @param dims The sizes of each dimension
+ * @param data The buffer, at least layout.getRequiredElements(rank, dims) elements
+ * @param layout Where each element of the dataset lives in the buffer
+ * @return Standard hdf5 error condition.
+ */
+template <typename T>
+inline herr_t writePointerDatasetWithLayout(hid_t locationID, const std::string& datasetName, int32_t rank, const hsize_t* dims, const T* data, const H5MemoryLayout& layout)
+{
+  H5SUPPORT_MUTEX_LOCK()
+
+  herr_t error = 0;
+  herr_t returnError = 0;
+  if(nullptr == data)
+  {
+    return -2;
+  }
+  hid_t dataType = H5TypeTraits<T>::type();
+  if(dataType == -1)
+  {
+    return -1;
+  }
+  hid_t dataspaceID = H5Screate_simple(rank, dims, nullptr);
+  if(dataspaceID < 0)
+  {
+    return static_cast<herr_t>(dataspaceID);
+  }
+  hid_t datasetID = H5Dcreate(locationID, datasetName.c_str(), dataType, dataspaceID, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+  if(datasetID >= 0)
+  {
+    returnError = transferDatasetWithLayout(datasetID, dataType, rank, dims, layout, const_cast<T*>(data), true);
+    if(returnError < 0)
+    {
+      std::cout << "Error Writing Data '" << datasetName << "'" << std::endl;
+    }
+    CloseH5D(datasetID, error, returnError, datasetName);
+  }
+  else
+  {
+    returnError = static_cast<herr_t>(datasetID);
+  }
+  CloseH5S(dataspaceID, error, returnError);
+  return returnError;
+}
+
+/**
+ * @brief Reads a whole dataset into a buffer described by a memory layout. Buffer elements the
+ * layout does not address are left untouched, so several datasets can be read into the
+ * components of one interleaved buffer.
+ * @param locationID The hdf5 object id of the parent
+ * @param datasetName The name of the dataset to read
+ * @param data The buffer, at least layout.getRequiredElements(rank, dims) elements
+ * @param layout Where each element of the dataset lives in the buffer
+ * @return Standard hdf5 error condition.
+ */
+template <typename T> inline herr_t readPointerDatasetWithLayout(hid_t locationID, const std::string& datasetName, T* data, const H5MemoryLayout& layout)
+{
+  H5SUPPORT_MUTEX_LOCK_SHARED()
+
+  herr_t error = 0;
+  herr_t returnError = 0;
+  if(nullptr == data)
+  {
+    return -2;
+  }
+  hid_t dataType = H5TypeTraits<T>::type();
+  if(dataType == -1)
+  {
+    return -1;
+  }
+  hid_t datasetID = H5Dopen(locationID, datasetName.c_str(), H5P_DEFAULT);
+  if(datasetID < 0)
+  {
+    std::cout << "H5MemoryLayout.h::readPointerDatasetWithLayout(" << __LINE__ << ") Error opening Dataset at locationID (" << locationID << ") with object name (" << datasetName << ")" << std::endl;
+    return -1;
+  }
+  hid_t dataspaceID = H5Dget_space(datasetID);
+  int32_t rank = (dataspaceID < 0) ? -1 : H5Sget_simple_extent_ndims(dataspaceID);
+  if(rank > 0)
+  {
+    std::vector<hsize_t> dims(static_cast<size_t>(rank));
+    H5Sget_simple_extent_dims(dataspaceID, dims.data(), nullptr);
+    returnError = transferDatasetWithLayout(datasetID, dataType, rank, dims.data(), layout, data, false);
+  }
+  else
+  {
+    std::cout << "H5MemoryLayout.h::readPointerDatasetWithLayout(" << __LINE__ << ") '" << datasetName << "' is not a simple dataset" << std::endl;
+    returnError = -1;
+  }
+  if(dataspaceID >= 0)
+  {
+    CloseH5S(dataspaceID, error, returnError);
+  }
+  CloseH5D(datasetID, error, returnError, datasetName);
+  return returnError;
+}
+} // namespace H5Lite
+
+#if defined(H5Support_NAMESPACE)
+}
+#endif
@@ -1,10 +1,38 @@
 #pragma once
 
+#ifdef H5Support_ENABLE_INSTRUMENTATION
+#include "H5Support/H5Instrumentation.h"
+#if defined(H5Support_NAMESPACE)
+#define H5SUPPORT_INSTRUMENT_SCOPE()                                                                                                                                                                   \
+  static ::H5Support_NAMESPACE::H5FunctionCounters& h5SupportCounters = ::H5Support_NAMESPACE::H5Instrumentation::instance().counters(__func__);                                                       \
+  ::H5Support_NAMESPACE::H5ScopedInstrumentation h5SupportInstrumentation(h5SupportCounters);
+#else
+#define H5SUPPORT_INSTRUMENT_SCOPE()                                                                                                                                                                   \
+  static ::H5FunctionCounters& h5SupportCounters = ::H5Instrumentation::instance().counters(__func__);                                                                                                 \
+  ::H5ScopedInstrumentation h5SupportInstrumentation(h5SupportCounters);
+#endif
+#define H5SUPPORT_INSTRUMENT_LOCK_ACQUIRED() h5SupportInstrumentation.lockAcquired();
+#define H5SUPPORT_INSTRUMENT_BYTES(status, numBytes)                                                                                                                                                   \
+  if((status) >= 0)                                                                                                                                                                                    \
+  {                                                                                                                                                                                                    \
+    h5SupportInstrumentation.addBytes(static_cast<uint64_t>(numBytes));                                                                                                                                \
+  }
+#else
+#define H5SUPPORT_INSTRUMENT_SCOPE()
+#define H5SUPPORT_INSTRUMENT_LOCK_ACQUIRED()
+#define H5SUPPORT_INSTRUMENT_BYTES(status, numBytes)
+#endif
+
 #ifdef H5Support_USE_MUTEX
-#include <mutex>
-#define H5SUPPORT_MUTEX_LOCK()                                                                                                                                                                         \
-  std::mutex mutex;                                                                                                                                                                                    \
-  std::lock_guard<std::mutex> lock(mutex);
+#include "H5Support/H5SupportMutex.h"
+#if defined(H5Support_NAMESPACE)
+#define H5SUPPORT_MUTEX_LOCK() H5SUPPORT_INSTRUMENT_SCOPE() ::H5Support_NAMESPACE::H5ScopedMutexLock h5SupportMutexLock; H5SUPPORT_INSTRUMENT_LOCK_ACQUIRED()
+#define H5SUPPORT_MUTEX_LOCK_SHARED() H5SUPPORT_INSTRUMENT_SCOPE() ::H5Support_NAMESPACE::H5ScopedSharedMutexLock h5SupportMutexLock; H5SUPPORT_INSTRUMENT_LOCK_ACQUIRED()
+#else
+#define H5SUPPORT_MUTEX_LOCK() H5SUPPORT_INSTRUMENT_SCOPE() ::H5ScopedMutexLock h5SupportMutexLock; H5SUPPORT_INSTRUMENT_LOCK_ACQUIRED()
+#define H5SUPPORT_MUTEX_LOCK_SHARED() H5SUPPORT_INSTRUMENT_SCOPE() ::H5ScopedSharedMutexLock h5SupportMutexLock; H5SUPPORT_INSTRUMENT_LOCK_ACQUIRED()
+#endif
 #else
-#define H5SUPPORT_MUTEX_LOCK()
+#define H5SUPPORT_MUTEX_LOCK() H5SUPPORT_INSTRUMENT_SCOPE()
+#define H5SUPPORT_MUTEX_LOCK_SHARED() H5SUPPORT_INSTRUMENT_SCOPE()
 #endif
@@ -0,0 +1,259 @@
+/* ============================================================================
+ * Copyright (c) 2007-2019 BlueQuartz Software, LLC
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+ * contributors may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The code contained herein was partially funded by the followig contracts:
+ *    United States Air Force Prime Contract FA8650-04-C-5229
+ *    United States Air Force Prime Contract FA8650-15-D-5231
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#pragma once
+
+#include <cassert>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+
+#include <hdf5.h>
+
+#if defined(H5Support_NAMESPACE)
+namespace H5Support_NAMESPACE
+{
+#endif
+
+/**
+ * @brief The H5SupportMutex class is the single, process wide lock that guards every
+ * H5Lite/H5Utilities entry point when H5Support_USE_MUTEX is enabled.
+ *
+ * The lock is re-entrant for the thread that holds it so that nested calls such as
+ * readVectorAttribute() -> getAttributeInfo() -> openId() do not deadlock. The outermost
+ * acquisition decides the mode: nested acquisitions only bump a per thread depth counter.
+ *
+ * Shared (reader) acquisitions are only allowed to run concurrently when the HDF5 library
+ * was built thread safe (H5_HAVE_THREADSAFE). A plain HDF5 build can not tolerate two
+ * threads inside the library at the same time so shared acquisitions are promoted to
+ * exclusive ones in that case.
+ */
+class H5SupportMutex
+{
+public:
+#if defined(H5_HAVE_THREADSAFE)
+  static constexpr bool k_ConcurrentReaders = true;
+#else
+  static constexpr bool k_ConcurrentReaders = false;
+#endif
+
+  ~H5SupportMutex() = default;
+
+  H5SupportMutex(const H5SupportMutex&) = delete;            // Copy Constructor Not Implemented
+  H5SupportMutex(H5SupportMutex&&) = delete;                 // Move Constructor Not Implemented
+  H5SupportMutex& operator=(const H5SupportMutex&) = delete; // Copy Assignment Not Implemented
+  H5SupportMutex& operator=(H5SupportMutex&&) = delete;      // Move Assignment Not Implemented
+
+  /**
+   * @brief Returns the process wide instance
+   * @return
+   */
+  static H5SupportMutex& instance()
+  {
+    static H5SupportMutex s_Instance;
+    return s_Instance;
+  }
+
+  /**
+   * @brief Acquires the lock for a function that modifies the file or the library state
+   */
+  void lock()
+  {
+    ThreadState& state = threadState();
+    if(state.depth > 0)
+    {
+      // A shared holder can not be upgraded without risking a deadlock against another
+      // reader doing the same thing. Read only entry points must never call mutating ones.
+      assert(state.exclusive);
+      ++state.depth;
+      return;
+    }
+    lockExclusive(state);
+  }
+
+  /**
+   * @brief Releases a lock acquired with lock()
+   */
+  void unlock()
+  {
+    release();
+  }
+
+  /**
+   * @brief Acquires the lock for a function that only queries or reads from a file
+   */
+  void lockShared()
+  {
+    ThreadState& state = threadState();
+    if(state.depth > 0)
+    {
+      ++state.depth;
+      return;
+    }
+    if(!k_ConcurrentReaders)
+    {
+      lockExclusive(state);
+      return;
+    }
+    std::unique_lock<std::mutex> guard(m_Mutex);
+    // Waiting writers get priority so a steady stream of readers can not starve them
+    m_Condition.wait(guard, [this] { return !m_WriterActive && m_WaitingWriters == 0; });
+    ++m_ActiveReaders;
+    state.exclusive = false;
+    state.depth = 1;
+  }
+
+  /**
+   * @brief Releases a lock acquired with lockShared()
+   */
+  void unlockShared()
+  {
+    release();
+  }
+
+  /**
+   * @brief Returns true if the calling thread currently holds the lock in any mode
+   * @return
+   */
+  bool isHeldByCurrentThread() const
+  {
+    return threadState().depth > 0;
+  }
+
+protected:
+  H5SupportMutex() = default;
+
+private:
+  struct ThreadState
+  {
+    size_t depth = 0;
+    bool exclusive = false;
+  };
+
+  static ThreadState& threadState()
+  {
+    static thread_local ThreadState s_State;
+    return s_State;
+  }
+
+  void lockExclusive(ThreadState& state)
+  {
+    std::unique_lock<std::mutex> guard(m_Mutex);
+    ++m_WaitingWriters;
+    m_Condition.wait(guard, [this] { return !m_WriterActive && m_ActiveReaders == 0; });
+    --m_WaitingWriters;
+    m_WriterActive = true;
+    state.exclusive = true;
+    state.depth = 1;
+  }
+
+  void release()
+  {
+    ThreadState& state = threadState();
+    assert(state.depth > 0);
+    if(--state.depth > 0)
+    {
+      return;
+    }
+    {
+      std::lock_guard<std::mutex> guard(m_Mutex);
+      if(state.exclusive)
+      {
+        m_WriterActive = false;
+      }
+      else
+      {
+        --m_ActiveReaders;
+      }
+    }
+    state.exclusive = false;
+    m_Condition.notify_all();
+  }
+
+  std::mutex m_Mutex;
+  std::condition_variable m_Condition;
+  size_t m_ActiveReaders = 0;
+  size_t m_WaitingWriters = 0;
+  bool m_WriterActive = false;
+};
+
+/**
+ * @brief The H5ScopedMutexLock class holds the H5SupportMutex in exclusive mode until
+ * the instance goes out of scope
+ */
+class H5ScopedMutexLock
+{
+public:
+  H5ScopedMutexLock()
+  {
+    H5SupportMutex::instance().lock();
+  }
+
+  ~H5ScopedMutexLock()
+  {
+    H5SupportMutex::instance().unlock();
+  }
+
+  H5ScopedMutexLock(const H5ScopedMutexLock&) = delete;            // Copy Constructor Not Implemented
+  H5ScopedMutexLock(H5ScopedMutexLock&&) = delete;                 // Move Constructor Not Implemented
+  H5ScopedMutexLock& operator=(const H5ScopedMutexLock&) = delete; // Copy Assignment Not Implemented
+  H5ScopedMutexLock& operator=(H5ScopedMutexLock&&) = delete;      // Move Assignment Not Implemented
+};
+
+/**
+ * @brief The H5ScopedSharedMutexLock class holds the H5SupportMutex in shared mode until
+ * the instance goes out of scope
+ */
+class H5ScopedSharedMutexLock
+{
+public:
+  H5ScopedSharedMutexLock()
+  {
+    H5SupportMutex::instance().lockShared();
+  }
+
+  ~H5ScopedSharedMutexLock()
+  {
+    H5SupportMutex::instance().unlockShared();
+  }
+
+  H5ScopedSharedMutexLock(const H5ScopedSharedMutexLock&) = delete;            // Copy Constructor Not Implemented
+  H5ScopedSharedMutexLock(H5ScopedSharedMutexLock&&) = delete;                 // Move Constructor Not Implemented
+  H5ScopedSharedMutexLock& operator=(const H5ScopedSharedMutexLock&) = delete; // Copy Assignment Not Implemented
+  H5ScopedSharedMutexLock& operator=(H5ScopedSharedMutexLock&&) = delete;      // Move Assignment Not Implemented
+};
+
+#if defined(H5Support_NAMESPACE)
+}
+#endif
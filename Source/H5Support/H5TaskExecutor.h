@@ -0,0 +1,186 @@
+/* ============================================================================
+ * Copyright (c) 2007-2019 BlueQuartz Software, LLC
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+ * contributors may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The code contained herein was partially funded by the followig contracts:
+ *    United States Air Force Prime Contract FA8650-04-C-5229
+ *    United States Air Force Prime Contract FA8650-15-D-5231
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if defined(H5Support_NAMESPACE)
+namespace H5Support_NAMESPACE
+{
+#endif
+
+/**
+ * @brief The H5TaskExecutor class owns a fixed set of worker threads that pull tasks
+ * from a bounded FIFO queue. submit() blocks once the queue holds queueCapacity
+ * pending tasks so a fast producer can not queue up an unbounded amount of work (and
+ * memory) in front of a slow consumer.
+ *
+ * With a single worker thread every task runs in submission order on the same thread,
+ * which is what is used to funnel all HDF5 calls onto one dedicated I/O thread.
+ *
+ * The destructor stops accepting new work, finishes every task that was already
+ * queued and then joins the workers.
+ */
+class H5TaskExecutor
+{
+public:
+  H5TaskExecutor(size_t threadCount, size_t queueCapacity)
+  : m_QueueCapacity(queueCapacity > 0 ? queueCapacity : 1)
+  {
+    threadCount = threadCount > 0 ? threadCount : 1;
+    m_Workers.reserve(threadCount);
+    for(size_t i = 0; i < threadCount; ++i)
+    {
+      m_Workers.emplace_back([this]() { workerLoop(); });
+    }
+  }
+
+  ~H5TaskExecutor()
+  {
+    {
+      std::lock_guard<std::mutex> guard(m_Mutex);
+      m_Stopping = true;
+    }
+    m_NotEmpty.notify_all();
+    m_NotFull.notify_all();
+    for(auto& worker : m_Workers)
+    {
+      worker.join();
+    }
+  }
+
+  H5TaskExecutor(const H5TaskExecutor&) = delete;            // Copy Constructor Not Implemented
+  H5TaskExecutor(H5TaskExecutor&&) = delete;                 // Move Constructor Not Implemented
+  H5TaskExecutor& operator=(const H5TaskExecutor&) = delete; // Copy Assignment Not Implemented
+  H5TaskExecutor& operator=(H5TaskExecutor&&) = delete;      // Move Assignment Not Implemented
+
+  /**
+   * @brief Queues a callable and returns a future for its result. Blocks while the
+   * queue is full. Never call this from one of this executor's own tasks and then wait
+   * on the returned future: with a single worker that is a guaranteed deadlock.
+   * @param function The callable to run on one of the worker threads
+   * @return The future holding the result (or the exception) of the callable
+   */
+  template <typename Function> std::future<typename std::result_of<Function()>::type> submit(Function&& function)
+  {
+    using ResultType = typename std::result_of<Function()>::type;
+    // std::function needs a copyable target and std::packaged_task is move only
+    auto task = std::make_shared<std::packaged_task<ResultType()>>(std::forward<Function>(function));
+    std::future<ResultType> future = task->get_future();
+    {
+      std::unique_lock<std::mutex> guard(m_Mutex);
+      m_NotFull.wait(guard, [this] { return m_Stopping || m_Tasks.size() < m_QueueCapacity; });
+      if(m_Stopping)
+      {
+        // The task is dropped which leaves the future with a broken_promise error
+        return future;
+      }
+      m_Tasks.emplace_back([task]() { (*task)(); });
+    }
+    m_NotEmpty.notify_one();
+    return future;
+  }
+
+  /**
+   * @brief Returns the number of worker threads
+   * @return
+   */
+  size_t getThreadCount() const
+  {
+    return m_Workers.size();
+  }
+
+  /**
+   * @brief Returns the maximum number of tasks that may wait in the queue
+   * @return
+   */
+  size_t getQueueCapacity() const
+  {
+    return m_QueueCapacity;
+  }
+
+  /**
+   * @brief Returns the number of tasks currently waiting to be picked up by a worker
+   * @return
+   */
+  size_t getPendingTaskCount()
+  {
+    std::lock_guard<std::mutex> guard(m_Mutex);
+    return m_Tasks.size();
+  }
+
+private:
+  void workerLoop()
+  {
+    while(true)
+    {
+      std::function<void()> task;
+      {
+        std::unique_lock<std::mutex> guard(m_Mutex);
+        m_NotEmpty.wait(guard, [this] { return m_Stopping || !m_Tasks.empty(); });
+        if(m_Tasks.empty())
+        {
+          return; // Stopping and nothing left to drain
+        }
+        task = std::move(m_Tasks.front());
+        m_Tasks.pop_front();
+      }
+      m_NotFull.notify_one();
+      task();
+    }
+  }
+
+  size_t m_QueueCapacity = 1;
+  bool m_Stopping = false;
+  std::mutex m_Mutex;
+  std::condition_variable m_NotEmpty;
+  std::condition_variable m_NotFull;
+  std::deque<std::function<void()>> m_Tasks;
+  std::vector<std::thread> m_Workers;
+};
+
+#if defined(H5Support_NAMESPACE)
+}
+#endif
@@ -0,0 +1,232 @@
+/* ============================================================================
+ * Copyright (c) 2007-2019 BlueQuartz Software, LLC
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+ * contributors may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The code contained herein was partially funded by the followig contracts:
+ *    United States Air Force Prime Contract FA8650-04-C-5229
+ *    United States Air Force Prime Contract FA8650-15-D-5231
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#include <hdf5.h>
+
+#include "H5Support/H5Support.h"
+
+#if defined(H5Support_NAMESPACE)
+namespace H5Support_NAMESPACE
+{
+#endif
+
+/**
+ * @brief Maps integer types onto the HDF5 native types by size and signedness, so long,
+ * long long and the fixed width typedefs all resolve without platform checks.
+ */
+template <size_t Size, bool Signed> struct H5IntegerTypeTraits
+{
+  static constexpr bool k_Supported = false;
+};
+
+template <> struct H5IntegerTypeTraits<1, true>
+{
+  static constexpr bool k_Supported = true;
+  static hid_t type()
+  {
+    return H5T_NATIVE_INT8;
+  }
+  static constexpr const char* name()
+  {
+    return "H5T_NATIVE_INT8";
+  }
+};
+
+template <> struct H5IntegerTypeTraits<1, false>
+{
+  static constexpr bool k_Supported = true;
+  static hid_t type()
+  {
+    return H5T_NATIVE_UINT8;
+  }
+  static constexpr const char* name()
+  {
+    return "H5T_NATIVE_UINT8";
+  }
+};
+
+template <> struct H5IntegerTypeTraits<2, true>
+{
+  static constexpr bool k_Supported = true;
+  static hid_t type()
+  {
+    return H5T_NATIVE_INT16;
+  }
+  static constexpr const char* name()
+  {
+    return "H5T_NATIVE_INT16";
+  }
+};
+
+template <> struct H5IntegerTypeTraits<2, false>
+{
+  static constexpr bool k_Supported = true;
+  static hid_t type()
+  {
+    return H5T_NATIVE_UINT16;
+  }
+  static constexpr const char* name()
+  {
+    return "H5T_NATIVE_UINT16";
+  }
+};
+
+template <> struct H5IntegerTypeTraits<4, true>
+{
+  static constexpr bool k_Supported = true;
+  static hid_t type()
+  {
+    return H5T_NATIVE_INT32;
+  }
+  static constexpr const char* name()
+  {
+    return "H5T_NATIVE_INT32";
+  }
+};
+
+template <> struct H5IntegerTypeTraits<4, false>
+{
+  static constexpr bool k_Supported = true;
+  static hid_t type()
+  {
+    return H5T_NATIVE_UINT32;
+  }
+  static constexpr const char* name()
+  {
+    return "H5T_NATIVE_UINT32";
+  }
+};
+
+template <> struct H5IntegerTypeTraits<8, true>
+{
+  static constexpr bool k_Supported = true;
+  static hid_t type()
+  {
+    return H5T_NATIVE_INT64;
+  }
+  static constexpr const char* name()
+  {
+    return "H5T_NATIVE_INT64";
+  }
+};
+
+template <> struct H5IntegerTypeTraits<8, false>
+{
+  static constexpr bool k_Supported = true;
+  static hid_t type()
+  {
+    return H5T_NATIVE_UINT64;
+  }
+  static constexpr const char* name()
+  {
+    return "H5T_NATIVE_UINT64";
+  }
+};
+
+/**
+ * @brief The H5TypeTraits struct is the compile time mapping from a C++ type to its HDF5
+ * memory type. Every supported type provides
+ *   - k_Supported: true
+ *   - type(): the HDF5 type id (the H5T_NATIVE_* ids are only known once the library is
+ *     open, so this is an inline accessor rather than a constant)
+ *   - name(): the name of that type, e.g. "H5T_NATIVE_INT32"
+ *
+ * Unsupported types have k_Supported == false and no type(), so the H5Lite templates
+ * reject them when they are compiled instead of returning -1 at runtime. Other types can
+ * be made available to H5Lite by specializing this template.
+ */
+template <typename T, typename Enable = void> struct H5TypeTraits
+{
+  static constexpr bool k_Supported = false;
+};
+
+template <typename T>
+struct H5TypeTraits<T, typename std::enable_if<std::is_integral<T>::value && !std::is_same<T, bool>::value && !std::is_same<T, char>::value>::type>
+: public H5IntegerTypeTraits<sizeof(T), std::is_signed<T>::value>
+{
+};
+
+/**
+ * @brief Plain char keeps the mapping HDFTypeForPrimitive always had: unsigned unless
+ * CMP_TYPE_CHAR_IS_SIGNED is set, independent of the signedness of char on the platform.
+ */
+#if CMP_TYPE_CHAR_IS_SIGNED
+constexpr bool k_H5CharIsSigned = true;
+#else
+constexpr bool k_H5CharIsSigned = false;
+#endif
+
+template <> struct H5TypeTraits<char> : public H5IntegerTypeTraits<1, k_H5CharIsSigned>
+{
+};
+
+template <> struct H5TypeTraits<bool> : public H5IntegerTypeTraits<1, false>
+{
+};
+
+template <> struct H5TypeTraits<float>
+{
+  static constexpr bool k_Supported = true;
+  static hid_t type()
+  {
+    return H5T_NATIVE_FLOAT;
+  }
+  static constexpr const char* name()
+  {
+    return "H5T_NATIVE_FLOAT";
+  }
+};
+
+template <> struct H5TypeTraits<double>
+{
+  static constexpr bool k_Supported = true;
+  static hid_t type()
+  {
+    return H5T_NATIVE_DOUBLE;
+  }
+  static constexpr const char* name()
+  {
+    return "H5T_NATIVE_DOUBLE";
+  }
+};
+
+#if defined(H5Support_NAMESPACE)
+}
+#endif
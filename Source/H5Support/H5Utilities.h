@@ -268,7 +268,7 @@ inline herr_t closeFile(hid_t& fileID)
  */
 inline std::string getObjectPath(hid_t locationID, bool trim = false)
 {
-  H5SUPPORT_MUTEX_LOCK()
+  H5SUPPORT_MUTEX_LOCK_SHARED()
 
   size_t nameSize = 1 + H5Iget_name(locationID, nullptr, 0);
   std::vector<char> objectName(nameSize, 0);
@@ -292,7 +292,7 @@ inline std::string getObjectPath(hid_t locationID, bool trim = false)
  */
 inline herr_t getObjectType(hid_t objectID, const std::string& objectName, int32_t& objectType)
 {
-  H5SUPPORT_MUTEX_LOCK()
+  H5SUPPORT_MUTEX_LOCK_SHARED()
 
   herr_t error = 1;
   H5O_info_t objectInfo{};
@@ -317,7 +317,7 @@ inline herr_t getObjectType(hid_t objectID, const std::string& objectName, int32
  */
 inline herr_t objectNameAtIndex(hid_t fileID, int32_t index, std::string& name)
 {
-  H5SUPPORT_MUTEX_LOCK()
+  H5SUPPORT_MUTEX_LOCK_SHARED()
 
   ssize_t error = -1;
   // call H5Gget_objname_by_idx with name as nullptr to get its length
@@ -389,7 +389,7 @@ inline std::string getObjectNameFromPath(const std::string& objectPath)
  */
 inline bool isGroup(hid_t nodeID, const std::string& objectName)
 {
-  H5SUPPORT_MUTEX_LOCK()
+  H5SUPPORT_MUTEX_LOCK_SHARED()
 
   bool isGroup = true;
   herr_t error = -1;
@@ -425,7 +425,7 @@ inline bool isGroup(hid_t nodeID, const std::string& objectName)
  */
 inline hid_t openHDF5Object(hid_t locationID, const std::string& objectName)
 {
-  H5SUPPORT_MUTEX_LOCK()
+  H5SUPPORT_MUTEX_LOCK_SHARED()
 
   int32_t objectType = 0;
   hid_t objectID;
@@ -558,7 +558,7 @@ inline void printHDFClassType(H5T_class_t classType)
  */
 inline herr_t getGroupObjects(hid_t locationID, CustomHDFDataTypes typeFilter, std::list<std::string>& names)
 {
-  H5SUPPORT_MUTEX_LOCK()
+  H5SUPPORT_MUTEX_LOCK_SHARED()
 
   herr_t error = 0;
   hsize_t numObjects = 0;
@@ -793,7 +793,7 @@ inline std::string extractObjectName(const std::string& path)
  */
 inline bool probeForAttribute(hid_t locationID, const std::string& objectName, const std::string& attributeName)
 {
-  H5SUPPORT_MUTEX_LOCK()
+  H5SUPPORT_MUTEX_LOCK_SHARED()
 
   herr_t error = 0;
   hid_t rank;
@@ -811,7 +811,7 @@ inline bool probeForAttribute(hid_t locationID, const std::string& objectName, c
  */
 inline herr_t getAllAttributeNames(hid_t objectID, std::list<std::string>& results)
 {
-  H5SUPPORT_MUTEX_LOCK()
+  H5SUPPORT_MUTEX_LOCK_SHARED()
 
   if(objectID < 0)
   {
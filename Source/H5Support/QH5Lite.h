@@ -39,6 +39,7 @@
 #include <cstring>
 #include <string>
 #include <typeinfo>
+#include <vector>
 
 #include <H5Tpublic.h>
 #include <hdf5.h>
@@ -214,6 +215,46 @@ inline QVector<hsize_t> guessChunkSize(const QVector<hsize_t>& dims, size_t type
   return retQVec;
 }
 
+/**
+ * @brief Creates a chunked Dataset with the given name at the location defined by locationID,
+ * writing it through the filters of a pipeline
+ *
+ * @param locationID The Parent location to store the data
+ * @param datasetName The name of the dataset
+ * @param rank The number of dimensions
+ * @param dims The dimensions of the dataset
+ * @param data The data to write to the file
+ * @param cRank The number of dimensions for cDims
+ * @param cDims The chunk dimensions
+ * @param pipeline The filters to apply
+ * @return Standard HDF5 error conditions
+ */
+template <typename T>
+inline herr_t writePointerDatasetCompressed(hid_t locationID, const QString& datasetName, int32_t rank, const hsize_t* dims, const T* data, int32_t cRank, const hsize_t* cDims,
+                                            const H5FilterPipeline& pipeline)
+{
+  return H5Lite::writePointerDatasetCompressed(locationID, datasetName.toStdString(), rank, dims, data, cRank, cDims, pipeline);
+}
+
+/**
+ * @brief Creates a chunked Dataset with the given name at the location defined by locationID,
+ * writing it through the filters of a pipeline
+ *
+ * @param locationID The Parent location to store the data
+ * @param datasetName The name of the dataset
+ * @param dims The dimensions of the dataset
+ * @param data The data to write to the file
+ * @param cDims The chunk dimensions
+ * @param pipeline The filters to apply
+ * @return Standard HDF5 error conditions
+ */
+template <typename T>
+inline herr_t writeVectorDatasetCompressed(hid_t locationID, const QString& datasetName, const QVector<hsize_t>& dims, const QVector<T>& data, const QVector<hsize_t>& cDims,
+                                           const H5FilterPipeline& pipeline)
+{
+  return H5Lite::writePointerDatasetCompressed(locationID, datasetName.toStdString(), dims.size(), dims.data(), data.data(), cDims.size(), cDims.data(), pipeline);
+}
+
 #ifdef H5_HAVE_FILTER_DEFLATE
 /**
  * @brief Creates a Dataset with the given name at the location defined by locationID with the given compression
@@ -322,67 +363,24 @@ inline herr_t writeStringDataset(hid_t locationID, const QString& datasetName, s
 }
 
 /**
- * @brief
- * @param locationID
- * @param datasetName
- * @param size
- * @param data
- * @return
+ * @brief Writes a vector of strings to a one dimensional variable length string dataset,
+ * see H5Lite::writeVectorOfStringsDataset()
+ * @param locationID The parent location for the dataset
+ * @param datasetName The name of the dataset
+ * @param data The strings to write
+ * @param chunkSize The number of strings per chunk (0 = contiguous unless compressed)
+ * @param compressionLevel The deflate level (0 = no compression, 1-9)
+ * @return Standard HDF5 error conditions
  */
-inline herr_t writeVectorOfStringsDataset(hid_t locationID, const QString& datasetName, const QVector<QString>& data)
+inline herr_t writeVectorOfStringsDataset(hid_t locationID, const QString& datasetName, const QVector<QString>& data, hsize_t chunkSize = 0, int32_t compressionLevel = 0)
 {
-  H5SUPPORT_MUTEX_LOCK()
-
-  hid_t dataspaceID = -1;
-  hid_t memSpace = -1;
-  hid_t datatype = -1;
-  hid_t datasetID = -1;
-  herr_t error = -1;
-  herr_t returnError = 0;
-
-  std::array<hsize_t, 1> dims = {static_cast<hsize_t>(data.size())};
-  if((dataspaceID = H5Screate_simple(static_cast<int>(dims.size()), dims.data(), nullptr)) >= 0)
+  std::vector<std::string> strings;
+  strings.reserve(static_cast<size_t>(data.size()));
+  for(const auto& element : data)
   {
-    dims[0] = 1;
-
-    if((memSpace = H5Screate_simple(static_cast<int>(dims.size()), dims.data(), nullptr)) >= 0)
-    {
-
-      datatype = H5Tcopy(H5T_C_S1);
-      H5Tset_size(datatype, H5T_VARIABLE);
-
-      if((datasetID = H5Dcreate(locationID, datasetName.toLocal8Bit().constData(), datatype, dataspaceID, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT)) >= 0)
-      {
-        // Select the "memory" to be written out - just 1 record.
-        hsize_t offset[] = {0};
-        hsize_t count[] = {1};
-        H5Sselect_hyperslab(memSpace, H5S_SELECT_SET, offset, nullptr, count, nullptr);
-        hsize_t pos = 0;
-        for(const auto& element : data)
-        {
-          // Select the file position, 1 record at position 'pos'
-          hsize_t count[] = {1};
-          hsize_t offset[] = {pos};
-          pos++;
-          H5Sselect_hyperslab(dataspaceID, H5S_SELECT_SET, offset, nullptr, count, nullptr);
-          std::string elementStr = element.toStdString();
-          const char* strPtr = elementStr.c_str();
-          error = H5Dwrite(datasetID, datatype, memSpace, dataspaceID, H5P_DEFAULT, &strPtr);
-          if(error < 0)
-          {
-            qDebug() << "Error Writing String Data: " __FILE__ << "(" << __LINE__ << ")";
-            returnError = error;
-          }
-        }
-        QCloseH5D(datasetID, error, returnError, datasetName);
-      }
-      H5Tclose(datatype);
-      QCloseH5S(memSpace, error, returnError);
-    }
-
-    QCloseH5S(dataspaceID, error, returnError);
+    strings.push_back(element.toStdString());
   }
-  return returnError;
+  return H5Lite::writeVectorOfStringsDataset(locationID, datasetName.toLocal8Bit().constData(), strings, chunkSize, compressionLevel);
 }
 
 /**
@@ -587,7 +585,7 @@ inline herr_t readStringDataset(hid_t locationID, const QString& datasetName, QS
  */
 inline herr_t readVectorOfStringDataset(hid_t locationID, const QString& datasetName, QVector<QString>& data)
 {
-  H5SUPPORT_MUTEX_LOCK()
+  H5SUPPORT_MUTEX_LOCK_SHARED()
 
   hid_t datasetID; // dataset id
   hid_t typeID;    // type id
@@ -336,7 +336,7 @@ inline herr_t getAllAttributeNames(hid_t locationID, const QString& objectName,
 
 inline QString fileNameFromFileId(hid_t fileId)
 {
-  H5SUPPORT_MUTEX_LOCK()
+  H5SUPPORT_MUTEX_LOCK_SHARED()
 
   // Get the name of the .dream3d file that we are writing to:
   ssize_t nameSize = H5Fget_name(fileId, nullptr, 0) + 1;
@@ -351,7 +351,7 @@ inline QString fileNameFromFileId(hid_t fileId)
 
 inline QString absoluteFilePathFromFileId(hid_t fileId)
 {
-  H5SUPPORT_MUTEX_LOCK()
+  H5SUPPORT_MUTEX_LOCK_SHARED()
 
   // Get the name of the .dream3d file that we are writing to:
   ssize_t nameSize = H5Fget_name(fileId, nullptr, 0) + 1;
@@ -0,0 +1,152 @@
+/* ============================================================================
+ * Copyright (c) 2007-2019 BlueQuartz Software, LLC
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+ * contributors may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The code contained herein was partially funded by the followig contracts:
+ *    United States Air Force Prime Contract FA8650-04-C-5229
+ *    United States Air Force Prime Contract FA8650-15-D-5231
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+
+#include <cstdio>
+#include <list>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "H5Support/H5AttributeWriter.h"
+#include "H5Support/H5Lite.h"
+#include "H5Support/H5Utilities.h"
+
+#include "UnitTestSupport.h"
+
+#include "H5SupportTestFileLocations.h"
+
+#if defined(H5Support_NAMESPACE)
+using namespace H5Support_NAMESPACE;
+#endif
+
+class H5AttributeWriterTest
+{
+public:
+  H5AttributeWriterTest() = default;
+  ~H5AttributeWriterTest() = default;
+
+  H5AttributeWriterTest(const H5AttributeWriterTest&) = delete;            // Copy Constructor Not Implemented
+  H5AttributeWriterTest(H5AttributeWriterTest&&) = delete;                 // Move Constructor Not Implemented
+  H5AttributeWriterTest& operator=(const H5AttributeWriterTest&) = delete; // Copy Assignment Not Implemented
+  H5AttributeWriterTest& operator=(H5AttributeWriterTest&&) = delete;      // Move Assignment Not Implemented
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  void RemoveTestFiles()
+  {
+#if REMOVE_TEST_FILES
+    std::remove(UnitTest::H5AttributeWriterTest::FileName.c_str());
+#endif
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  void TestWriteAttributes()
+  {
+    hid_t fileID = H5Utilities::createFile(UnitTest::H5AttributeWriterTest::FileName);
+    H5SUPPORT_REQUIRE(fileID > 0);
+
+    herr_t error = H5Lite::writeVectorDataset(fileID, "Data", {4}, std::vector<int32_t>{1, 2, 3, 4});
+    H5SUPPORT_REQUIRE(error >= 0);
+
+    {
+      H5AttributeWriter writer(fileID, "Data");
+      H5SUPPORT_REQUIRE(writer.isValid());
+      H5SUPPORT_REQUIRE(writer.writeString("Units", "mm") >= 0);
+      H5SUPPORT_REQUIRE(writer.writeScalar("Version", int32_t(2)) >= 0);
+      H5SUPPORT_REQUIRE(writer.writeVector("Origin", std::vector<float>{0.5f, 1.5f, 2.5f}) >= 0);
+      H5SUPPORT_REQUIRE(writer.writeVector("Matrix", {2, 2}, std::vector<double>{1.0, 0.0, 0.0, 1.0}) >= 0);
+      // Writing an existing name replaces the attribute, including its type
+      H5SUPPORT_REQUIRE(writer.writeString("Version", "two") >= 0);
+      H5SUPPORT_REQUIRE_EQUAL(writer.getError(), 0)
+      H5SUPPORT_REQUIRE(writer.close() >= 0);
+      H5SUPPORT_REQUIRE(!writer.isValid());
+    }
+
+    std::string units;
+    H5SUPPORT_REQUIRE(H5Lite::readStringAttribute(fileID, "Data", "Units", units) >= 0);
+    H5SUPPORT_REQUIRE_EQUAL(units, "mm")
+    std::string version;
+    H5SUPPORT_REQUIRE(H5Lite::readStringAttribute(fileID, "Data", "Version", version) >= 0);
+    H5SUPPORT_REQUIRE_EQUAL(version, "two")
+    std::vector<float> origin;
+    H5SUPPORT_REQUIRE(H5Lite::readVectorAttribute(fileID, "Data", "Origin", origin) >= 0);
+    H5SUPPORT_REQUIRE((origin == std::vector<float>{0.5f, 1.5f, 2.5f}));
+    hid_t rank = 0;
+    H5SUPPORT_REQUIRE(H5Lite::getAttributeNDims(fileID, "Data", "Matrix", rank) >= 0);
+    H5SUPPORT_REQUIRE_EQUAL(rank, 2)
+
+    // Groups go through the same path, as does the batched string writer in H5Lite
+    hid_t groupID = H5Utilities::createGroup(fileID, "Group");
+    H5SUPPORT_REQUIRE(groupID > 0);
+    H5Gclose(groupID);
+    std::map<std::string, std::string> attributes = {{"A", "alpha"}, {"B", "beta"}, {"C", ""}};
+    H5SUPPORT_REQUIRE(H5Lite::writeStringAttributes(fileID, "Group", attributes) >= 0);
+    H5SUPPORT_REQUIRE(H5Lite::writeStringAttributes(fileID, "Group", attributes) >= 0);
+    for(const auto& attribute : attributes)
+    {
+      std::string value;
+      H5SUPPORT_REQUIRE(H5Lite::readStringAttribute(fileID, "Group", attribute.first, value) >= 0);
+      H5SUPPORT_REQUIRE_EQUAL(value, attribute.second)
+    }
+    std::list<std::string> names;
+    H5SUPPORT_REQUIRE(H5Utilities::getAllAttributeNames(fileID, "Group", names) >= 0);
+    H5SUPPORT_REQUIRE_EQUAL(names.size(), 3)
+
+    HDF_ERROR_HANDLER_OFF
+    {
+      H5AttributeWriter writer(fileID, "DoesNotExist");
+      H5SUPPORT_REQUIRE(!writer.isValid());
+      H5SUPPORT_REQUIRE(writer.writeScalar("Value", 1.0) < 0);
+      H5SUPPORT_REQUIRE(writer.close() < 0);
+    }
+    H5SUPPORT_REQUIRE(H5Lite::writeStringAttributes(fileID, "DoesNotExist", attributes) < 0);
+    HDF_ERROR_HANDLER_ON
+
+    error = H5Utilities::closeFile(fileID);
+    H5SUPPORT_REQUIRE(error >= 0);
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  void operator()()
+  {
+    H5SUPPORT_REGISTER_TEST(TestWriteAttributes())
+    H5SUPPORT_REGISTER_TEST(RemoveTestFiles())
+  }
+};
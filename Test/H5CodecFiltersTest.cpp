@@ -0,0 +1,604 @@
+/* ============================================================================
+ * Copyright (c) 2007-2019 BlueQuartz Software, LLC
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+ * contributors may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The code contained herein was partially funded by the followig contracts:
+ *    United States Air Force Prime Contract FA8650-04-C-5229
+ *    United States Air Force Prime Contract FA8650-15-D-5231
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "H5Support/H5CodecFilters.h"
+#include "H5Support/H5DatasetHandle.h"
+#include "H5Support/H5Lite.h"
+#include "H5Support/H5Utilities.h"
+
+#include "UnitTestSupport.h"
+
+#include "H5SupportTestFileLocations.h"
+
+#if defined(H5Support_NAMESPACE)
+using namespace H5Support_NAMESPACE;
+#endif
+
+class H5CodecFiltersTest
+{
+public:
+  H5CodecFiltersTest() = default;
+  ~H5CodecFiltersTest() = default;
+
+  H5CodecFiltersTest(const H5CodecFiltersTest&) = delete;            // Copy Constructor Not Implemented
+  H5CodecFiltersTest(H5CodecFiltersTest&&) = delete;                 // Move Constructor Not Implemented
+  H5CodecFiltersTest& operator=(const H5CodecFiltersTest&) = delete; // Copy Assignment Not Implemented
+  H5CodecFiltersTest& operator=(H5CodecFiltersTest&&) = delete;      // Move Assignment Not Implemented
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  void RemoveTestFiles()
+  {
+#if REMOVE_TEST_FILES
+    std::remove(UnitTest::H5CodecFiltersTest::FileName.c_str());
+#endif
+  }
+
+  // -----------------------------------------------------------------------------
+  // A 64^3 volume of grain ids: blocky regions of a few hundred labels
+  // -----------------------------------------------------------------------------
+  std::vector<int32_t> createLabels()
+  {
+    std::vector<int32_t> labels(64 * 64 * 64);
+    for(size_t z = 0; z < 64; ++z)
+    {
+      for(size_t y = 0; y < 64; ++y)
+      {
+        for(size_t x = 0; x < 64; ++x)
+        {
+          labels[(z * 64 + y) * 64 + x] = static_cast<int32_t>(((z + x / 3) / 9) * 64 + ((y + z / 2) / 7) * 8 + (x + y / 4) / 11);
+        }
+      }
+    }
+    return labels;
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  std::vector<uint8_t> roundTrip(const std::vector<uint8_t>& input, H5Codec::Method method, int32_t level, bool& same)
+  {
+    std::vector<uint8_t> compressed = H5Codec::compress(input.data(), input.size(), method, level);
+    size_t size = 0;
+    same = H5Codec::getDecompressedSize(compressed.data(), compressed.size(), size) && size == input.size();
+    std::vector<uint8_t> output(size + 1);
+    same = same && H5Codec::decompress(compressed.data(), compressed.size(), output.data());
+    same = same && std::equal(input.begin(), input.end(), output.begin());
+    return compressed;
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  void TestCodecs()
+  {
+    std::mt19937 generator(1234);
+    std::vector<std::vector<uint8_t>> inputs;
+    for(size_t size = 0; size < 24; ++size)
+    {
+      inputs.emplace_back(size, static_cast<uint8_t>('a' + size % 3));
+    }
+    std::vector<uint8_t> random(100000);
+    for(auto& value : random)
+    {
+      value = static_cast<uint8_t>(generator());
+    }
+    inputs.push_back(random);
+    inputs.emplace_back(100000, 0);
+    std::string phrases[] = {"the grain ", "boundary ", "of phase ", "12 ", "misorientation ", "EBSD "};
+    std::vector<uint8_t> text;
+    while(text.size() < 200000)
+    {
+      const std::string& phrase = phrases[generator() % 6];
+      text.insert(text.end(), phrase.begin(), phrase.end());
+    }
+    inputs.push_back(text);
+    std::vector<int32_t> labels = createLabels();
+    const uint8_t* labelBytes = reinterpret_cast<const uint8_t*>(labels.data());
+    inputs.emplace_back(labelBytes, labelBytes + labels.size() * sizeof(int32_t));
+
+    for(const auto& input : inputs)
+    {
+      for(H5Codec::Method method : {H5Codec::Method::Stored, H5Codec::Method::LZ, H5Codec::Method::LZH})
+      {
+        for(int32_t level : {1, 9})
+        {
+          bool same = false;
+          roundTrip(input, method, level, same);
+          H5SUPPORT_REQUIRE(same);
+        }
+      }
+    }
+
+    // Incompressible data is stored, repetitive data shrinks, and LZH beats LZ on text
+    bool same = false;
+    H5SUPPORT_REQUIRE_EQUAL(roundTrip(random, H5Codec::Method::LZ, 5, same).size(), random.size() + H5Codec::k_HeaderSize)
+    H5SUPPORT_REQUIRE_EQUAL(roundTrip(random, H5Codec::Method::LZH, 5, same).size(), random.size() + H5Codec::k_HeaderSize)
+    H5SUPPORT_REQUIRE(roundTrip(inputs[inputs.size() - 3], H5Codec::Method::LZ, 5, same).size() < 1000);
+    size_t lzSize = roundTrip(text, H5Codec::Method::LZ, 5, same).size();
+    size_t lzhSize = roundTrip(text, H5Codec::Method::LZH, 5, same).size();
+    H5SUPPORT_REQUIRE(lzSize < text.size() / 2);
+    H5SUPPORT_REQUIRE(lzhSize < lzSize);
+
+    // Truncated blocks are rejected without reading past their end
+    for(H5Codec::Method method : {H5Codec::Method::LZ, H5Codec::Method::LZH})
+    {
+      std::vector<uint8_t> compressed = H5Codec::compress(text.data(), text.size(), method);
+      std::vector<uint8_t> output(text.size());
+      bool rejected = true;
+      for(size_t size = 0; size < compressed.size() && rejected; size += 1 + size / 16)
+      {
+        std::vector<uint8_t> truncated(compressed.begin(), compressed.begin() + size);
+        rejected = !H5Codec::decompress(truncated.data(), truncated.size(), output.data());
+      }
+      H5SUPPORT_REQUIRE(rejected);
+    }
+
+    // An LZH stream claiming to be larger than its block is rejected before it is allocated
+    {
+      std::vector<uint8_t> corrupt = {16, 0, 0, 0, static_cast<uint8_t>(H5Codec::Method::LZH), 0xFF, 0xFF, 0xFF, 0xFF, 1, 0};
+      std::vector<uint8_t> output(16);
+      H5SUPPORT_REQUIRE(!H5Codec::decompress(corrupt.data(), corrupt.size(), output.data()));
+    }
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  void TestDatasetFilters()
+  {
+    H5SUPPORT_REQUIRE(H5Lite::registerCodecFilters() >= 0);
+    // Ids outside the private range would be read by someone else's registered filter
+    for(H5Z_filter_t filter : {H5Lite::k_LZFilterID, H5Lite::k_LZHFilterID, H5Lite::k_DeltaFilterID, H5Lite::k_RunLengthFilterID, H5Lite::k_BitRoundFilterID})
+    {
+      H5SUPPORT_REQUIRE(filter >= 32768 && filter <= 65535);
+    }
+    H5SUPPORT_REQUIRE(H5Zfilter_avail(H5Lite::k_LZFilterID) > 0);
+    H5SUPPORT_REQUIRE(H5Zfilter_avail(H5Lite::k_LZHFilterID) > 0);
+
+    hid_t fileID = H5Utilities::createFile(UnitTest::H5CodecFiltersTest::FileName);
+    H5SUPPORT_REQUIRE(fileID > 0);
+
+    std::vector<int32_t> labels = createLabels();
+    const std::vector<hsize_t> dims = {64, 64, 64};
+    const std::vector<hsize_t> cDims = {16, 64, 64};
+    herr_t error = H5Lite::writeVectorDatasetCompressed(fileID, "LZ", dims, labels, cDims, H5FilterPipeline::Codec(H5Lite::k_LZFilterID));
+    H5SUPPORT_REQUIRE(error >= 0);
+    error = H5Lite::writeVectorDatasetCompressed(fileID, "LZH", dims, labels, cDims, H5FilterPipeline::Codec(H5Lite::k_LZHFilterID, {9}));
+    H5SUPPORT_REQUIRE(error >= 0);
+
+    for(const std::string& name : {std::string("LZ"), std::string("LZH")})
+    {
+      std::vector<int32_t> readBack;
+      error = H5Lite::readVectorDataset(fileID, name, readBack);
+      H5SUPPORT_REQUIRE(error >= 0);
+      H5SUPPORT_REQUIRE(readBack == labels);
+
+      H5DatasetHandle handle = H5DatasetHandle::open(fileID, name);
+      H5Z_filter_t filter = (name == "LZ") ? H5Lite::k_LZFilterID : H5Lite::k_LZHFilterID;
+      H5SUPPORT_REQUIRE((handle.getFilters() == std::vector<H5Z_filter_t>{H5Z_FILTER_SHUFFLE, filter}));
+      hsize_t storageSize = H5Dget_storage_size(handle.getId());
+      H5SUPPORT_REQUIRE(storageSize < labels.size() * sizeof(int32_t) / 10);
+    }
+
+    error = H5Utilities::closeFile(fileID);
+    H5SUPPORT_REQUIRE(error >= 0);
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  template <typename T> std::vector<uint8_t> elementRoundTrip(const std::vector<T>& values, H5Codec::Method method, bool& same)
+  {
+    const uint8_t* bytes = reinterpret_cast<const uint8_t*>(values.data());
+    // One trailing byte that is not a whole element
+    std::vector<uint8_t> input(bytes, bytes + values.size() * sizeof(T));
+    input.push_back(0x5a);
+    std::vector<uint8_t> encoded = H5Codec::encodeElements(input.data(), input.size(), method, sizeof(T), H5Codec::isBigEndianHost());
+    size_t size = 0;
+    same = H5Codec::getDecompressedSize(encoded.data(), encoded.size(), size) && size == input.size();
+    same = same && H5Codec::checkDecompressedSize(encoded.data(), encoded.size(), sizeof(T));
+    std::vector<uint8_t> output(size);
+    same = same && H5Codec::decompress(encoded.data(), encoded.size(), output.data()) && output == input;
+    return encoded;
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  template <typename T> void TestElementCodec()
+  {
+    std::mt19937_64 generator(99);
+    std::vector<T> indices(5000);
+    std::vector<T> random(5000);
+    std::vector<T> runs(5000);
+    std::vector<T> empty;
+    for(size_t i = 0; i < indices.size(); ++i)
+    {
+      indices[i] = static_cast<T>(i * 3 + generator() % 3);
+      random[i] = static_cast<T>(generator());
+      runs[i] = static_cast<T>(i / 250 + ((i / 250) % 2 == 0 ? 0 : -1000));
+    }
+    for(H5Codec::Method method : {H5Codec::Method::Delta, H5Codec::Method::RunLength})
+    {
+      for(const std::vector<T>* values : {&indices, &random, &runs, &empty})
+      {
+        bool same = false;
+        elementRoundTrip(*values, method, same);
+        H5SUPPORT_REQUIRE(same);
+      }
+    }
+
+    // Small steps take a byte per element, runs a few bytes each, and noise is stored
+    bool same = false;
+    H5SUPPORT_REQUIRE(elementRoundTrip(indices, H5Codec::Method::Delta, same).size() <= indices.size() + 16);
+    H5SUPPORT_REQUIRE(elementRoundTrip(runs, H5Codec::Method::RunLength, same).size() < 20 * (2 + sizeof(T)) + 16);
+    if(sizeof(T) > 1)
+    {
+      H5SUPPORT_REQUIRE_EQUAL(elementRoundTrip(random, H5Codec::Method::RunLength, same)[4], static_cast<uint8_t>(H5Codec::Method::Stored))
+    }
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  void TestElementCodecs()
+  {
+    TestElementCodec<uint8_t>();
+    TestElementCodec<int16_t>();
+    TestElementCodec<int32_t>();
+    TestElementCodec<uint64_t>();
+
+    // Elements stored in the other byte order decode to the same bytes
+    std::vector<uint8_t> bigEndian = {0, 0, 0, 10, 0, 0, 0, 11, 0, 0, 1, 12, 0, 0, 1, 13};
+    std::vector<uint8_t> encoded = H5Codec::encodeElements(bigEndian.data(), bigEndian.size(), H5Codec::Method::Delta, 4, true);
+    std::vector<uint8_t> output(bigEndian.size());
+    H5SUPPORT_REQUIRE(H5Codec::decompress(encoded.data(), encoded.size(), output.data()));
+    H5SUPPORT_REQUIRE(output == bigEndian);
+
+    // Truncated blocks are rejected without reading past their end
+    std::vector<int32_t> labels = createLabels();
+    for(H5Codec::Method method : {H5Codec::Method::Delta, H5Codec::Method::RunLength})
+    {
+      encoded = H5Codec::encodeElements(labels.data(), labels.size() * sizeof(int32_t), method, sizeof(int32_t), H5Codec::isBigEndianHost());
+      H5SUPPORT_REQUIRE_EQUAL(encoded[4], static_cast<uint8_t>(method))
+      output.resize(labels.size() * sizeof(int32_t));
+      bool rejected = true;
+      for(size_t size = 0; size < encoded.size() && rejected; size += 1 + size / 16)
+      {
+        std::vector<uint8_t> truncated(encoded.begin(), encoded.begin() + size);
+        rejected = !H5Codec::decompress(truncated.data(), truncated.size(), output.data());
+      }
+      H5SUPPORT_REQUIRE(rejected);
+
+      // A header claiming more bytes than the block can hold, or another element size, is
+      // rejected before anything is allocated
+      H5SUPPORT_REQUIRE(H5Codec::checkDecompressedSize(encoded.data(), encoded.size(), sizeof(int32_t)));
+      H5SUPPORT_REQUIRE(!H5Codec::checkDecompressedSize(encoded.data(), encoded.size(), sizeof(int16_t)));
+      std::vector<uint8_t> inflated = encoded;
+      inflated[3] = 0xFF;
+      H5SUPPORT_REQUIRE(!H5Codec::checkDecompressedSize(inflated.data(), inflated.size(), sizeof(int32_t)));
+    }
+    std::vector<uint8_t> stored = {0, 0, 0, 0xFF, static_cast<uint8_t>(H5Codec::Method::Stored), 1, 2, 3};
+    H5SUPPORT_REQUIRE(!H5Codec::checkDecompressedSize(stored.data(), stored.size(), 0));
+    stored[3] = 0;
+    stored[0] = 3;
+    H5SUPPORT_REQUIRE(H5Codec::checkDecompressedSize(stored.data(), stored.size(), 0));
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  void TestElementFilters()
+  {
+    H5SUPPORT_REQUIRE(H5Zfilter_avail(H5Lite::k_DeltaFilterID) > 0);
+    H5SUPPORT_REQUIRE(H5Zfilter_avail(H5Lite::k_RunLengthFilterID) > 0);
+
+    hid_t fileID = H5Utilities::openFile(UnitTest::H5CodecFiltersTest::FileName, false);
+    H5SUPPORT_REQUIRE(fileID > 0);
+
+    std::vector<int32_t> labels = createLabels();
+    const std::vector<hsize_t> dims = {64, 64, 64};
+    const std::vector<hsize_t> cDims = {16, 64, 64};
+    std::vector<uint64_t> indices(100000);
+    for(size_t i = 0; i < indices.size(); ++i)
+    {
+      indices[i] = 1000000000000 + i * 7 + i % 5;
+    }
+    const std::vector<hsize_t> indexDims = {indices.size()};
+    const std::vector<hsize_t> indexChunkDims = {25000};
+
+    herr_t error = H5Lite::writeVectorDatasetCompressed(fileID, "RunLength", dims, labels, cDims, H5FilterPipeline::Transform(H5Lite::k_RunLengthFilterID));
+    H5SUPPORT_REQUIRE(error >= 0);
+    error = H5Lite::writeVectorDatasetCompressed(fileID, "RunLengthLZ", dims, labels, cDims, H5FilterPipeline::Transform(H5Lite::k_RunLengthFilterID, H5Lite::k_LZFilterID));
+    H5SUPPORT_REQUIRE(error >= 0);
+    error = H5Lite::writeVectorDatasetCompressed(fileID, "Delta", indexDims, indices, indexChunkDims, H5FilterPipeline::Transform(H5Lite::k_DeltaFilterID));
+    H5SUPPORT_REQUIRE(error >= 0);
+
+    // Runs along x are a handful of voxels long; LZ then picks up the repeats between rows
+    for(const std::string& name : {std::string("RunLength"), std::string("RunLengthLZ")})
+    {
+      std::vector<int32_t> readBack;
+      error = H5Lite::readVectorDataset(fileID, name, readBack);
+      H5SUPPORT_REQUIRE(error >= 0);
+      H5SUPPORT_REQUIRE(readBack == labels);
+      H5DatasetHandle handle = H5DatasetHandle::open(fileID, name);
+      hsize_t ratio = (name == "RunLength") ? 4 : 20;
+      H5SUPPORT_REQUIRE(H5Dget_storage_size(handle.getId()) < labels.size() * sizeof(int32_t) / ratio);
+    }
+    std::vector<uint64_t> indicesBack;
+    error = H5Lite::readVectorDataset(fileID, "Delta", indicesBack);
+    H5SUPPORT_REQUIRE(error >= 0);
+    H5SUPPORT_REQUIRE(indicesBack == indices);
+    {
+      H5DatasetHandle handle = H5DatasetHandle::open(fileID, "Delta");
+      H5SUPPORT_REQUIRE((handle.getFilters() == std::vector<H5Z_filter_t>{H5Lite::k_DeltaFilterID}));
+      H5SUPPORT_REQUIRE(H5Dget_storage_size(handle.getId()) <= indices.size() + 1024);
+    }
+
+    // Floats are refused by the filter, and a transform does not combine with scale-offset
+    std::vector<float> floats(1000, 1.5f);
+    const std::vector<hsize_t> floatDims = {floats.size()};
+    HDF_ERROR_HANDLER_OFF
+    error = H5Lite::writeVectorDatasetCompressed(fileID, "DeltaFloat", floatDims, floats, floatDims, H5FilterPipeline::Transform(H5Lite::k_DeltaFilterID));
+    H5SUPPORT_REQUIRE(error < 0);
+    H5FilterPipeline pipeline = H5FilterPipeline::Transform(H5Lite::k_DeltaFilterID);
+    pipeline.scaleOffset = true;
+    error = H5Lite::writeVectorDatasetCompressed(fileID, "DeltaScaleOffset", indexDims, indices, indexChunkDims, pipeline);
+    H5SUPPORT_REQUIRE(error < 0);
+    HDF_ERROR_HANDLER_ON
+
+    H5SUPPORT_REQUIRE(H5Utilities::closeFile(fileID) >= 0);
+  }
+
+  // -----------------------------------------------------------------------------
+  // The largest relative error of the normal values, or infinity when a special value changed
+  // -----------------------------------------------------------------------------
+  template <typename T> double getMaxRelativeError(const std::vector<T>& values, const std::vector<T>& rounded)
+  {
+    double maxError = 0.0;
+    for(size_t i = 0; i < values.size(); ++i)
+    {
+      if(std::isnan(values[i]) || std::isinf(values[i]) || values[i] == 0)
+      {
+        bool same = (std::isnan(values[i]) && std::isnan(rounded[i])) || values[i] == rounded[i];
+        maxError = same ? maxError : std::numeric_limits<double>::infinity();
+      }
+      else if(std::isnormal(values[i]))
+      {
+        maxError = std::max(maxError, std::fabs((static_cast<double>(rounded[i]) - values[i]) / values[i]));
+      }
+    }
+    return maxError;
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  template <typename T> void TestBitRoundPrecision(uint32_t mantissaBits)
+  {
+    std::mt19937 generator(7);
+    std::uniform_real_distribution<double> exponents(-30.0, 30.0);
+    std::vector<T> values(20000);
+    for(auto& value : values)
+    {
+      value = static_cast<T>((generator() % 2 == 0 ? 1.0 : -1.0) * std::pow(2.0, exponents(generator)));
+    }
+    values[0] = 0;
+    values[1] = std::numeric_limits<T>::infinity();
+    values[2] = -std::numeric_limits<T>::infinity();
+    values[3] = std::numeric_limits<T>::quiet_NaN();
+    values[4] = std::numeric_limits<T>::max();
+    values[5] = std::numeric_limits<T>::denorm_min();
+    values[6] = static_cast<T>(1.5);
+
+    for(uint32_t keepBits : {0u, 1u, 3u, 7u, 10u, 16u, mantissaBits - 1, mantissaBits})
+    {
+      std::vector<T> rounded = values;
+      H5SUPPORT_REQUIRE(H5Codec::roundMantissas(rounded.data(), rounded.size() * sizeof(T), sizeof(T), H5Codec::isBigEndianHost(), keepBits));
+      // Round to nearest halves the bound of truncation, 2^-keepBits
+      double bound = std::ldexp(1.0, -static_cast<int32_t>(keepBits) - 1);
+      std::vector<T> normal(values.begin() + 6, values.end());
+      std::vector<T> normalRounded(rounded.begin() + 6, rounded.end());
+      H5SUPPORT_REQUIRE(getMaxRelativeError(normal, normalRounded) <= bound);
+      H5SUPPORT_REQUIRE(getMaxRelativeError(values, rounded) <= 2 * bound);
+      H5SUPPORT_REQUIRE(std::isfinite(rounded[4]));
+      H5SUPPORT_REQUIRE(rounded[5] >= 0);
+      // 1.5 is exact from one kept bit on, and ties round to even below that
+      H5SUPPORT_REQUIRE_EQUAL(rounded[6], static_cast<T>(keepBits == 0 ? 2.0 : 1.5))
+      if(keepBits == mantissaBits)
+      {
+        H5SUPPORT_REQUIRE(std::memcmp(rounded.data() + 4, values.data() + 4, (values.size() - 4) * sizeof(T)) == 0);
+      }
+    }
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  void TestBitRound()
+  {
+    TestBitRoundPrecision<float>(23);
+    TestBitRoundPrecision<double>(52);
+
+    // Elements in the other byte order are rounded the same way
+    float value = 1.0f + 1.0f / 3.0f;
+    std::vector<uint8_t> bytes(sizeof(float));
+    std::memcpy(bytes.data(), &value, sizeof(float));
+    std::vector<uint8_t> swapped(bytes.rbegin(), bytes.rend());
+    H5SUPPORT_REQUIRE(H5Codec::roundMantissas(bytes.data(), bytes.size(), 4, H5Codec::isBigEndianHost(), 4));
+    H5SUPPORT_REQUIRE(H5Codec::roundMantissas(swapped.data(), swapped.size(), 4, !H5Codec::isBigEndianHost(), 4));
+    H5SUPPORT_REQUIRE((bytes == std::vector<uint8_t>(swapped.rbegin(), swapped.rend())));
+    std::memcpy(&value, bytes.data(), sizeof(float));
+    H5SUPPORT_REQUIRE_EQUAL(value, 1.3125f)
+    H5SUPPORT_REQUIRE(!H5Codec::roundMantissas(bytes.data(), bytes.size(), 2, false, 4));
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  void TestBitRoundFilter()
+  {
+    H5SUPPORT_REQUIRE(H5Zfilter_avail(H5Lite::k_BitRoundFilterID) > 0);
+
+    hid_t fileID = H5Utilities::openFile(UnitTest::H5CodecFiltersTest::FileName, false);
+    H5SUPPORT_REQUIRE(fileID > 0);
+
+    // A smooth temperature like field
+    std::vector<float> field(64 * 64 * 64);
+    for(size_t i = 0; i < field.size(); ++i)
+    {
+      float x = static_cast<float>(i % 64) / 64.0f;
+      float y = static_cast<float>((i / 64) % 64) / 64.0f;
+      float z = static_cast<float>(i / 4096) / 64.0f;
+      field[i] = 300.0f + 25.0f * std::sin(6.0f * x) * std::cos(4.0f * y) + 10.0f * z * z;
+    }
+    const std::vector<hsize_t> dims = {64, 64, 64};
+    const std::vector<hsize_t> cDims = {16, 64, 64};
+    herr_t error = H5Lite::writeVectorDatasetCompressed(fileID, "Lossless", dims, field, cDims, H5FilterPipeline::Codec(H5Lite::k_LZFilterID));
+    H5SUPPORT_REQUIRE(error >= 0);
+    hsize_t losslessSize = 0;
+    {
+      H5DatasetHandle handle = H5DatasetHandle::open(fileID, "Lossless");
+      losslessSize = H5Dget_storage_size(handle.getId());
+    }
+
+    hsize_t previousSize = field.size() * sizeof(float) + 1;
+    for(uint32_t keepBits : {16u, 10u, 4u})
+    {
+      std::string name = "BitRound" + std::to_string(keepBits);
+      H5FilterPipeline pipeline = H5FilterPipeline::Codec(H5Lite::k_LZFilterID);
+      pipeline.transform = H5Lite::k_BitRoundFilterID;
+      pipeline.transformValues = {keepBits};
+      error = H5Lite::writeVectorDatasetCompressed(fileID, name, dims, field, cDims, pipeline);
+      H5SUPPORT_REQUIRE(error >= 0);
+
+      std::vector<float> readBack;
+      error = H5Lite::readVectorDataset(fileID, name, readBack);
+      H5SUPPORT_REQUIRE(error >= 0);
+      H5SUPPORT_REQUIRE_EQUAL(readBack.size(), field.size())
+      H5SUPPORT_REQUIRE(getMaxRelativeError(field, readBack) <= std::ldexp(1.0, -static_cast<int32_t>(keepBits) - 1));
+
+      H5DatasetHandle handle = H5DatasetHandle::open(fileID, name);
+      H5SUPPORT_REQUIRE((handle.getFilters() == std::vector<H5Z_filter_t>{H5Lite::k_BitRoundFilterID, H5Z_FILTER_SHUFFLE, H5Lite::k_LZFilterID}));
+      hsize_t storageSize = H5Dget_storage_size(handle.getId());
+      H5SUPPORT_REQUIRE(storageSize < previousSize);
+      previousSize = storageSize;
+    }
+    // With 4 bits left the zeroed byte planes shrink the chunks well below the lossless write
+    H5SUPPORT_REQUIRE(previousSize < losslessSize * 3 / 4);
+
+    // Integers are refused, and the client data needs the bit count
+    std::vector<int32_t> labels = createLabels();
+    H5FilterPipeline pipeline = H5FilterPipeline::Transform(H5Lite::k_BitRoundFilterID);
+    HDF_ERROR_HANDLER_OFF
+    pipeline.transformValues = {10};
+    error = H5Lite::writeVectorDatasetCompressed(fileID, "BitRoundInteger", dims, labels, cDims, pipeline);
+    H5SUPPORT_REQUIRE(error < 0);
+    pipeline.transformValues.clear();
+    error = H5Lite::writeVectorDatasetCompressed(fileID, "BitRoundNoBits", dims, field, cDims, pipeline);
+    H5SUPPORT_REQUIRE(error < 0);
+    HDF_ERROR_HANDLER_ON
+
+    H5SUPPORT_REQUIRE(H5Utilities::closeFile(fileID) >= 0);
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  void TestThroughput()
+  {
+    hid_t fileID = H5Utilities::openFile(UnitTest::H5CodecFiltersTest::FileName, false);
+    H5SUPPORT_REQUIRE(fileID > 0);
+
+    std::vector<int32_t> labels = createLabels();
+    const std::vector<hsize_t> dims = {64, 64, 64};
+    const std::vector<hsize_t> cDims = {16, 64, 64};
+    double megabytes = static_cast<double>(labels.size() * sizeof(int32_t)) / (1024.0 * 1024.0);
+    std::vector<std::pair<std::string, H5FilterPipeline>> pipelines;
+#ifdef H5_HAVE_FILTER_DEFLATE
+    H5FilterPipeline deflate = H5FilterPipeline::Deflate(6);
+    deflate.shuffle = true;
+    pipelines.emplace_back("Deflate", deflate);
+#endif
+    pipelines.emplace_back("LZ", H5FilterPipeline::Codec(H5Lite::k_LZFilterID));
+    pipelines.emplace_back("LZH", H5FilterPipeline::Codec(H5Lite::k_LZHFilterID));
+    for(const auto& pipeline : pipelines)
+    {
+      std::string name = "Throughput" + pipeline.first;
+      auto start = std::chrono::steady_clock::now();
+      herr_t error = H5Lite::writeVectorDatasetCompressed(fileID, name, dims, labels, cDims, pipeline.second);
+      auto written = std::chrono::steady_clock::now();
+      H5SUPPORT_REQUIRE(error >= 0);
+      std::vector<int32_t> readBack;
+      error = H5Lite::readVectorDataset(fileID, name, readBack);
+      auto read = std::chrono::steady_clock::now();
+      H5SUPPORT_REQUIRE(error >= 0);
+      H5SUPPORT_REQUIRE(readBack == labels);
+
+      H5DatasetHandle handle = H5DatasetHandle::open(fileID, name);
+      double ratio = static_cast<double>(labels.size() * sizeof(int32_t)) / static_cast<double>(H5Dget_storage_size(handle.getId()));
+      std::cout << "    " << pipeline.first << ": write " << megabytes / std::chrono::duration<double>(written - start).count() << " MB/s, read "
+                << megabytes / std::chrono::duration<double>(read - written).count() << " MB/s, ratio " << ratio << std::endl;
+    }
+
+    herr_t error = H5Utilities::closeFile(fileID);
+    H5SUPPORT_REQUIRE(error >= 0);
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  void operator()()
+  {
+    H5SUPPORT_REGISTER_TEST(TestCodecs())
+    H5SUPPORT_REGISTER_TEST(TestDatasetFilters())
+    H5SUPPORT_REGISTER_TEST(TestElementCodecs())
+    H5SUPPORT_REGISTER_TEST(TestElementFilters())
+    H5SUPPORT_REGISTER_TEST(TestBitRound())
+    H5SUPPORT_REGISTER_TEST(TestBitRoundFilter())
+    H5SUPPORT_REGISTER_TEST(TestThroughput())
+    H5SUPPORT_REGISTER_TEST(RemoveTestFiles())
+  }
+};
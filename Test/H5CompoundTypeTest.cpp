@@ -0,0 +1,303 @@
+/* ============================================================================
+ * Copyright (c) 2007-2019 BlueQuartz Software, LLC
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+ * contributors may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The code contained herein was partially funded by the followig contracts:
+ *    United States Air Force Prime Contract FA8650-04-C-5229
+ *    United States Air Force Prime Contract FA8650-15-D-5231
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "H5Support/H5CompoundColumns.h"
+#include "H5Support/H5CompoundType.h"
+#include "H5Support/H5DatasetHandle.h"
+#include "H5Support/H5Lite.h"
+#include "H5Support/H5Utilities.h"
+
+#include "UnitTestSupport.h"
+
+#include "H5SupportTestFileLocations.h"
+
+#if defined(H5Support_NAMESPACE)
+using namespace H5Support_NAMESPACE;
+#endif
+
+namespace
+{
+struct Orientation
+{
+  float euler[3];
+};
+
+struct Grain
+{
+  int32_t id;
+  float position[3];
+  Orientation orientation;
+  double phase;
+  uint8_t flags;
+};
+
+struct GrainSummary
+{
+  double phase;
+  int32_t id;
+};
+} // namespace
+
+H5SUPPORT_BEGIN_COMPOUND(Orientation)
+H5SUPPORT_COMPOUND_MEMBER_NAMED(euler, "Euler")
+H5SUPPORT_END_COMPOUND()
+
+H5SUPPORT_BEGIN_COMPOUND(Grain)
+H5SUPPORT_COMPOUND_MEMBER(id)
+H5SUPPORT_COMPOUND_MEMBER_NAMED(position, "Position")
+H5SUPPORT_COMPOUND_MEMBER_NAMED(orientation, "Orientation")
+H5SUPPORT_COMPOUND_MEMBER(phase)
+H5SUPPORT_COMPOUND_MEMBER(flags)
+H5SUPPORT_END_COMPOUND()
+
+H5SUPPORT_BEGIN_COMPOUND(GrainSummary)
+H5SUPPORT_COMPOUND_MEMBER(phase)
+H5SUPPORT_COMPOUND_MEMBER(id)
+H5SUPPORT_END_COMPOUND()
+
+class H5CompoundTypeTest
+{
+public:
+  H5CompoundTypeTest() = default;
+  ~H5CompoundTypeTest() = default;
+
+  H5CompoundTypeTest(const H5CompoundTypeTest&) = delete;            // Copy Constructor Not Implemented
+  H5CompoundTypeTest(H5CompoundTypeTest&&) = delete;                 // Move Constructor Not Implemented
+  H5CompoundTypeTest& operator=(const H5CompoundTypeTest&) = delete; // Copy Assignment Not Implemented
+  H5CompoundTypeTest& operator=(H5CompoundTypeTest&&) = delete;      // Move Assignment Not Implemented
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  void RemoveTestFiles()
+  {
+#if REMOVE_TEST_FILES
+    std::remove(UnitTest::H5CompoundTypeTest::FileName.c_str());
+#endif
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  void TestCompoundType()
+  {
+    static_assert(H5TypeTraits<Grain>::k_Supported, "Registered structs must be supported");
+    static_assert(!H5TypeTraits<std::vector<int>>::k_Supported, "Unregistered structs must not be supported");
+
+    hid_t typeID = H5TypeTraits<Grain>::type();
+    H5SUPPORT_REQUIRE(typeID >= 0);
+    // The type is built once and cached
+    H5SUPPORT_REQUIRE_EQUAL(H5TypeTraits<Grain>::type(), typeID)
+    H5SUPPORT_REQUIRE_EQUAL(H5Tget_class(typeID), H5T_COMPOUND)
+    H5SUPPORT_REQUIRE_EQUAL(H5Tget_size(typeID), sizeof(Grain))
+    H5SUPPORT_REQUIRE_EQUAL(H5Tget_nmembers(typeID), 5)
+    H5SUPPORT_REQUIRE_EQUAL(H5Tget_member_index(typeID, "Position"), 1)
+    H5SUPPORT_REQUIRE_EQUAL(H5Tget_member_offset(typeID, 3), offsetof(Grain, phase))
+    H5SUPPORT_REQUIRE_EQUAL(H5Tget_member_class(typeID, 1), H5T_ARRAY)
+    H5SUPPORT_REQUIRE_EQUAL(H5Tget_member_class(typeID, 2), H5T_COMPOUND)
+    H5SUPPORT_REQUIRE_EQUAL(std::string(H5TypeTraits<Grain>::name()), "Grain")
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  void TestWriteReadStructs()
+  {
+    hid_t fileID = H5Utilities::createFile(UnitTest::H5CompoundTypeTest::FileName);
+    H5SUPPORT_REQUIRE(fileID > 0);
+
+    std::vector<Grain> grains(1000);
+    for(size_t i = 0; i < grains.size(); ++i)
+    {
+      Grain& grain = grains[i];
+      grain.id = static_cast<int32_t>(i);
+      grain.position[0] = static_cast<float>(i);
+      grain.position[1] = static_cast<float>(i) * 0.5f;
+      grain.position[2] = -static_cast<float>(i);
+      grain.orientation.euler[0] = 0.1f;
+      grain.orientation.euler[1] = 0.2f;
+      grain.orientation.euler[2] = static_cast<float>(i % 360);
+      grain.phase = static_cast<double>(i % 3);
+      grain.flags = static_cast<uint8_t>(i % 256);
+    }
+
+    herr_t error = H5Lite::writeVectorDataset(fileID, "Grains", {grains.size()}, grains);
+    H5SUPPORT_REQUIRE(error >= 0);
+    error = H5Lite::writePointerDataset(fileID, "GrainTable", 2, std::vector<hsize_t>{250, 4}.data(), grains.data());
+    H5SUPPORT_REQUIRE(error >= 0);
+
+    std::vector<Grain> readGrains;
+    error = H5Lite::readVectorDataset(fileID, "Grains", readGrains);
+    H5SUPPORT_REQUIRE(error >= 0);
+    H5SUPPORT_REQUIRE_EQUAL(readGrains.size(), grains.size())
+    for(size_t i = 0; i < grains.size(); ++i)
+    {
+      H5SUPPORT_REQUIRE_EQUAL(readGrains[i].id, grains[i].id)
+      H5SUPPORT_REQUIRE_EQUAL(readGrains[i].position[2], grains[i].position[2])
+      H5SUPPORT_REQUIRE_EQUAL(readGrains[i].orientation.euler[2], grains[i].orientation.euler[2])
+      H5SUPPORT_REQUIRE_EQUAL(readGrains[i].phase, grains[i].phase)
+      H5SUPPORT_REQUIRE_EQUAL(readGrains[i].flags, grains[i].flags)
+    }
+
+    // Members are matched by name, so a smaller struct reads a subset of the fields
+    std::vector<GrainSummary> summaries;
+    error = H5Lite::readVectorDataset(fileID, "GrainTable", summaries);
+    H5SUPPORT_REQUIRE(error >= 0);
+    H5SUPPORT_REQUIRE_EQUAL(summaries.size(), grains.size())
+    H5SUPPORT_REQUIRE_EQUAL(summaries[998].id, 998)
+    H5SUPPORT_REQUIRE_EQUAL(summaries[998].phase, 2.0)
+
+    // Slabs and scalars go through the same templates
+    std::vector<Grain> slab;
+    error = H5Lite::readVectorDatasetSlab(fileID, "Grains", {500}, {2}, slab);
+    H5SUPPORT_REQUIRE(error >= 0);
+    H5SUPPORT_REQUIRE_EQUAL(slab[1].id, 501)
+    error = H5Lite::writeScalarDataset(fileID, "FirstGrain", grains[0]);
+    H5SUPPORT_REQUIRE(error >= 0);
+
+    H5DatasetHandle handle = H5DatasetHandle::open(fileID, "Grains");
+    H5SUPPORT_REQUIRE_EQUAL(handle.getClassType(), H5T_COMPOUND)
+    H5SUPPORT_REQUIRE_EQUAL(handle.getTypeSize(), sizeof(Grain))
+    handle.close();
+
+    error = H5Utilities::closeFile(fileID);
+    H5SUPPORT_REQUIRE(error >= 0);
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  void TestCompoundColumns()
+  {
+    hid_t fileID = H5Utilities::openFile(UnitTest::H5CompoundTypeTest::FileName, false);
+    H5SUPPORT_REQUIRE(fileID > 0);
+
+    const size_t numElements = 5000;
+    std::vector<int32_t> ids(numElements);
+    std::vector<float> positions(numElements * 3);
+    std::vector<Orientation> orientations(numElements);
+    std::vector<double> phases(numElements);
+    std::vector<uint8_t> flags(numElements);
+    for(size_t i = 0; i < numElements; ++i)
+    {
+      ids[i] = static_cast<int32_t>(i);
+      positions[i * 3] = static_cast<float>(i);
+      positions[i * 3 + 1] = 1.0f;
+      positions[i * 3 + 2] = -static_cast<float>(i);
+      orientations[i].euler[0] = static_cast<float>(i % 7);
+      orientations[i].euler[1] = 0.0f;
+      orientations[i].euler[2] = 0.5f;
+      phases[i] = static_cast<double>(i) * 0.25;
+      flags[i] = static_cast<uint8_t>(i % 200);
+    }
+
+    // Written column by column with the member names of the registered Grain struct
+    {
+      H5CompoundColumns columns;
+      H5SUPPORT_REQUIRE(columns.add("id", static_cast<const int32_t*>(ids.data())) >= 0);
+      H5SUPPORT_REQUIRE(columns.add("Position", static_cast<const float*>(positions.data()), 3) >= 0);
+      H5SUPPORT_REQUIRE(columns.add("Orientation", static_cast<const Orientation*>(orientations.data())) >= 0);
+      H5SUPPORT_REQUIRE(columns.add("phase", static_cast<const double*>(phases.data())) >= 0);
+      H5SUPPORT_REQUIRE(columns.add("flags", static_cast<const uint8_t*>(flags.data())) >= 0);
+      H5SUPPORT_REQUIRE(columns.add("flags", static_cast<const uint8_t*>(flags.data())) < 0);
+      herr_t error = H5Lite::writeCompoundColumnsDataset(fileID, "GrainColumns", {numElements}, columns);
+      H5SUPPORT_REQUIRE(error >= 0);
+
+      HDF_ERROR_HANDLER_OFF
+      // Read only columns can not receive data
+      error = H5Lite::readCompoundColumnsDataset(fileID, "GrainColumns", columns);
+      H5SUPPORT_REQUIRE_EQUAL(error, -3)
+      HDF_ERROR_HANDLER_ON
+    }
+
+    // The records are the same as if they had been written as structs
+    std::vector<Grain> grains;
+    herr_t error = H5Lite::readVectorDataset(fileID, "GrainColumns", grains);
+    H5SUPPORT_REQUIRE(error >= 0);
+    H5SUPPORT_REQUIRE_EQUAL(grains.size(), numElements)
+    H5SUPPORT_REQUIRE_EQUAL(grains[4321].id, 4321)
+    H5SUPPORT_REQUIRE_EQUAL(grains[4321].position[2], -4321.0f)
+    H5SUPPORT_REQUIRE_EQUAL(grains[4321].orientation.euler[0], orientations[4321].euler[0])
+    H5SUPPORT_REQUIRE_EQUAL(grains[4321].phase, phases[4321])
+    H5SUPPORT_REQUIRE_EQUAL(grains[4321].flags, flags[4321])
+
+    // And a subset of the members reads back into separate arrays, also from struct written data
+    for(const std::string& name : {std::string("GrainColumns"), std::string("Grains")})
+    {
+      size_t count = (name == "Grains") ? 1000 : numElements;
+      std::vector<double> readPhases(count, -1.0);
+      std::vector<float> readPositions(count * 3, -1.0f);
+      H5CompoundColumns columns;
+      columns.add("phase", readPhases.data());
+      columns.add("Position", readPositions.data(), 3);
+      error = H5Lite::readCompoundColumnsDataset(fileID, name, columns);
+      H5SUPPORT_REQUIRE(error >= 0);
+      for(size_t i = 0; i < count; ++i)
+      {
+        H5SUPPORT_REQUIRE_EQUAL(readPositions[i * 3], static_cast<float>(i))
+        H5SUPPORT_REQUIRE_EQUAL(readPositions[i * 3 + 2], -static_cast<float>(i))
+      }
+      H5SUPPORT_REQUIRE_EQUAL(readPhases[count - 1], (name == "Grains") ? static_cast<double>((count - 1) % 3) : phases[count - 1])
+    }
+
+    HDF_ERROR_HANDLER_OFF
+    {
+      std::vector<double> values(numElements);
+      H5CompoundColumns columns;
+      columns.add("DoesNotExist", values.data());
+      error = H5Lite::readCompoundColumnsDataset(fileID, "GrainColumns", columns);
+      H5SUPPORT_REQUIRE_EQUAL(error, -2)
+    }
+    HDF_ERROR_HANDLER_ON
+
+    error = H5Utilities::closeFile(fileID);
+    H5SUPPORT_REQUIRE(error >= 0);
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  void operator()()
+  {
+    H5SUPPORT_REGISTER_TEST(TestCompoundType())
+    H5SUPPORT_REGISTER_TEST(TestWriteReadStructs())
+    H5SUPPORT_REGISTER_TEST(TestCompoundColumns())
+    H5SUPPORT_REGISTER_TEST(RemoveTestFiles())
+  }
+};
@@ -0,0 +1,200 @@
+/* ============================================================================
+ * Copyright (c) 2007-2019 BlueQuartz Software, LLC
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+ * contributors may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The code contained herein was partially funded by the followig contracts:
+ *    United States Air Force Prime Contract FA8650-04-C-5229
+ *    United States Air Force Prime Contract FA8650-15-D-5231
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "H5Support/H5DatasetAppender.h"
+#include "H5Support/H5Lite.h"
+#include "H5Support/H5Utilities.h"
+
+#include "UnitTestSupport.h"
+
+#include "H5SupportTestFileLocations.h"
+
+#if defined(H5Support_NAMESPACE)
+using namespace H5Support_NAMESPACE;
+#endif
+
+class H5DatasetAppenderTest
+{
+public:
+  H5DatasetAppenderTest() = default;
+  ~H5DatasetAppenderTest() = default;
+
+  H5DatasetAppenderTest(const H5DatasetAppenderTest&) = delete;            // Copy Constructor Not Implemented
+  H5DatasetAppenderTest(H5DatasetAppenderTest&&) = delete;                 // Move Constructor Not Implemented
+  H5DatasetAppenderTest& operator=(const H5DatasetAppenderTest&) = delete; // Copy Assignment Not Implemented
+  H5DatasetAppenderTest& operator=(H5DatasetAppenderTest&&) = delete;      // Move Assignment Not Implemented
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  void RemoveTestFiles()
+  {
+#if REMOVE_TEST_FILES
+    std::remove(UnitTest::H5DatasetAppenderTest::FileName.c_str());
+#endif
+  }
+
+  // -----------------------------------------------------------------------------
+  //  Append 3 x 4 slices in uneven batches and check the buffer never exceeds a chunk
+  // -----------------------------------------------------------------------------
+  void TestAppendSlices()
+  {
+    hid_t fileID = H5Utilities::createFile(UnitTest::H5DatasetAppenderTest::FileName);
+    H5SUPPORT_REQUIRE(fileID > 0);
+
+    const std::vector<hsize_t> sliceDims = {3, 4};
+    const hsize_t k_RowsPerChunk = 5;
+    std::vector<float> expected;
+    {
+      H5DatasetAppender<float> appender(fileID, "Slices", sliceDims, k_RowsPerChunk);
+      H5SUPPORT_REQUIRE(appender.isValid());
+      H5SUPPORT_REQUIRE_EQUAL(appender.getRowElementCount(), 12)
+      H5SUPPORT_REQUIRE_EQUAL(appender.getRowsPerChunk(), k_RowsPerChunk)
+
+      // Batches of 1, 2, 3, ... slices: mixes buffered and direct whole chunk writes
+      for(hsize_t batch = 1; batch <= 12; ++batch)
+      {
+        std::vector<float> slices(batch * 12);
+        for(auto& value : slices)
+        {
+          value = static_cast<float>(expected.size());
+          expected.push_back(value);
+        }
+        herr_t error = appender.append(slices);
+        H5SUPPORT_REQUIRE(error >= 0);
+        H5SUPPORT_REQUIRE(appender.getNumberOfRows() - appender.getNumberOfWrittenRows() < k_RowsPerChunk);
+      }
+      H5SUPPORT_REQUIRE_EQUAL(appender.getNumberOfRows(), 78)
+      H5SUPPORT_REQUIRE_EQUAL(appender.append(std::vector<float>(5)), -3)
+
+      herr_t error = appender.flush();
+      H5SUPPORT_REQUIRE(error >= 0);
+      H5SUPPORT_REQUIRE_EQUAL(appender.getNumberOfWrittenRows(), 78)
+
+      // Keep appending after a partial flush
+      std::vector<float> last(12);
+      for(auto& value : last)
+      {
+        value = static_cast<float>(expected.size());
+        expected.push_back(value);
+      }
+      error = appender.append(last.data(), 1);
+      H5SUPPORT_REQUIRE(error >= 0);
+    } // Destructor flushes the last row
+
+    std::vector<hsize_t> dims;
+    H5T_class_t classType;
+    size_t typeSize = 0;
+    herr_t error = H5Lite::getDatasetInfo(fileID, "Slices", dims, classType, typeSize);
+    H5SUPPORT_REQUIRE(error >= 0);
+    H5SUPPORT_REQUIRE((dims == std::vector<hsize_t>{79, 3, 4}));
+
+    std::vector<float> readBack;
+    error = H5Lite::readVectorDataset(fileID, "Slices", readBack);
+    H5SUPPORT_REQUIRE(error >= 0);
+    H5SUPPORT_REQUIRE(readBack == expected);
+
+    hid_t datasetID = H5Dopen(fileID, "Slices", H5P_DEFAULT);
+    hid_t dataspaceID = H5Dget_space(datasetID);
+    std::vector<hsize_t> maxDims(3, 0);
+    H5Sget_simple_extent_dims(dataspaceID, nullptr, maxDims.data());
+    H5SUPPORT_REQUIRE_EQUAL(maxDims[0], H5S_UNLIMITED)
+    H5Sclose(dataspaceID);
+    H5Dclose(datasetID);
+
+    error = H5Utilities::closeFile(fileID);
+    H5SUPPORT_REQUIRE(error >= 0);
+  }
+
+  // -----------------------------------------------------------------------------
+  //  A time series of scalars with the default chunk size
+  // -----------------------------------------------------------------------------
+  void TestAppendScalars()
+  {
+    hid_t fileID = H5Utilities::openFile(UnitTest::H5DatasetAppenderTest::FileName, false);
+    H5SUPPORT_REQUIRE(fileID > 0);
+    {
+      H5DatasetAppender<int64_t> appender(fileID, "TimeSeries", {});
+      H5SUPPORT_REQUIRE(appender.isValid());
+      H5SUPPORT_REQUIRE_EQUAL(appender.getRowsPerChunk(), H5Lite::k_ChunkMax / sizeof(int64_t))
+      for(int64_t i = 0; i < 1000; ++i)
+      {
+        H5SUPPORT_REQUIRE(appender.append(&i, 1) >= 0);
+      }
+      H5SUPPORT_REQUIRE(appender.close() >= 0);
+      H5SUPPORT_REQUIRE(!appender.isValid());
+      H5SUPPORT_REQUIRE(appender.append(std::vector<int64_t>(1)) < 0);
+    }
+    std::vector<int64_t> readBack;
+    herr_t error = H5Lite::readVectorDataset(fileID, "TimeSeries", readBack);
+    H5SUPPORT_REQUIRE(error >= 0);
+    H5SUPPORT_REQUIRE_EQUAL(readBack.size(), 1000)
+    for(size_t i = 0; i < readBack.size(); ++i)
+    {
+      H5SUPPORT_REQUIRE_EQUAL(readBack[i], static_cast<int64_t>(i))
+    }
+
+    // The dataset already exists
+    HDF_ERROR_HANDLER_OFF
+    {
+      H5DatasetAppender<int64_t> appender(fileID, "TimeSeries", {});
+      H5SUPPORT_REQUIRE(!appender.isValid());
+    }
+    // An empty slice can not hold rows
+    {
+      H5DatasetAppender<int64_t> appender(fileID, "EmptySlice", {0});
+      H5SUPPORT_REQUIRE(!appender.isValid());
+      H5SUPPORT_REQUIRE(appender.append(std::vector<int64_t>(4)) < 0);
+      H5SUPPORT_REQUIRE_EQUAL(appender.getNumberOfRows(), 0)
+    }
+    HDF_ERROR_HANDLER_ON
+
+    error = H5Utilities::closeFile(fileID);
+    H5SUPPORT_REQUIRE(error >= 0);
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  void operator()()
+  {
+    H5SUPPORT_REGISTER_TEST(TestAppendSlices())
+    H5SUPPORT_REGISTER_TEST(TestAppendScalars())
+    H5SUPPORT_REGISTER_TEST(RemoveTestFiles())
+  }
+};
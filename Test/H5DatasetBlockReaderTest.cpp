@@ -0,0 +1,224 @@
+/* ============================================================================
+ * Copyright (c) 2007-2019 BlueQuartz Software, LLC
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+ * contributors may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The code contained herein was partially funded by the followig contracts:
+ *    United States Air Force Prime Contract FA8650-04-C-5229
+ *    United States Air Force Prime Contract FA8650-15-D-5231
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "H5Support/H5DatasetAppender.h"
+#include "H5Support/H5DatasetBlockReader.h"
+#include "H5Support/H5Lite.h"
+#include "H5Support/H5Utilities.h"
+
+#include "UnitTestSupport.h"
+
+#include "H5SupportTestFileLocations.h"
+
+#if defined(H5Support_NAMESPACE)
+using namespace H5Support_NAMESPACE;
+#endif
+
+class H5DatasetBlockReaderTest
+{
+public:
+  H5DatasetBlockReaderTest() = default;
+  ~H5DatasetBlockReaderTest() = default;
+
+  H5DatasetBlockReaderTest(const H5DatasetBlockReaderTest&) = delete;            // Copy Constructor Not Implemented
+  H5DatasetBlockReaderTest(H5DatasetBlockReaderTest&&) = delete;                 // Move Constructor Not Implemented
+  H5DatasetBlockReaderTest& operator=(const H5DatasetBlockReaderTest&) = delete; // Copy Assignment Not Implemented
+  H5DatasetBlockReaderTest& operator=(H5DatasetBlockReaderTest&&) = delete;      // Move Assignment Not Implemented
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  void RemoveTestFiles()
+  {
+#if REMOVE_TEST_FILES
+    std::remove(UnitTest::H5DatasetBlockReaderTest::FileName.c_str());
+#endif
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  void TestWriteDatasets()
+  {
+    hid_t fileID = H5Utilities::createFile(UnitTest::H5DatasetBlockReaderTest::FileName);
+    H5SUPPORT_REQUIRE(fileID > 0);
+
+    // 95 rows of 2 x 3 with 7 rows per chunk
+    std::vector<int32_t> values(95 * 6);
+    for(size_t i = 0; i < values.size(); ++i)
+    {
+      values[i] = static_cast<int32_t>(i);
+    }
+    {
+      H5DatasetAppender<int32_t> appender(fileID, "Chunked", {2, 3}, 7);
+      H5SUPPORT_REQUIRE(appender.append(values) >= 0);
+    }
+    herr_t error = H5Lite::writeVectorDataset(fileID, "Contiguous", {95, 2, 3}, values);
+    H5SUPPORT_REQUIRE(error >= 0);
+    error = H5Lite::writeScalarDataset(fileID, "Scalar", 42.0);
+    H5SUPPORT_REQUIRE(error >= 0);
+
+    // Never written: 2048 rows of 8192 int32 with 1024 rows per chunk, so one chunk row is
+    // larger than the default block budget
+    {
+      std::vector<hsize_t> dims = {2048, 8192};
+      std::vector<hsize_t> cDims = {1024, 8192};
+      hid_t dataspaceID = H5Screate_simple(2, dims.data(), nullptr);
+      hid_t propertyListID = H5Pcreate(H5P_DATASET_CREATE);
+      H5Pset_chunk(propertyListID, 2, cDims.data());
+      hid_t datasetID = H5Dcreate(fileID, "LargeChunks", H5T_NATIVE_INT32, dataspaceID, H5P_DEFAULT, propertyListID, H5P_DEFAULT);
+      H5SUPPORT_REQUIRE(datasetID >= 0);
+      H5Dclose(datasetID);
+      H5Pclose(propertyListID);
+      H5Sclose(dataspaceID);
+    }
+
+    error = H5Utilities::closeFile(fileID);
+    H5SUPPORT_REQUIRE(error >= 0);
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  void TestReadBlocks()
+  {
+    hid_t fileID = H5Utilities::openFile(UnitTest::H5DatasetBlockReaderTest::FileName, true);
+    H5SUPPORT_REQUIRE(fileID > 0);
+
+    // Default block size on a chunked dataset is a whole number of chunk rows
+    {
+      H5DatasetBlockReader<int32_t> reader(fileID, "Chunked");
+      H5SUPPORT_REQUIRE(reader.isValid());
+      H5SUPPORT_REQUIRE((reader.getDimensions() == std::vector<hsize_t>{95, 2, 3}));
+      H5SUPPORT_REQUIRE_EQUAL(reader.getRowElementCount(), 6)
+      H5SUPPORT_REQUIRE_EQUAL(reader.getRowsPerBlock(), 95)
+    }
+
+    // A chunk row larger than the budget does not grow the default block past it
+    {
+      H5DatasetBlockReader<int32_t> reader(fileID, "LargeChunks");
+      H5SUPPORT_REQUIRE(reader.isValid());
+      H5SUPPORT_REQUIRE_EQUAL(reader.getRowsPerBlock() * reader.getRowElementCount() * sizeof(int32_t), H5DatasetBlockReader<int32_t>::k_DefaultBlockBytes)
+    }
+
+    // User sized blocks: the last block is short and the buffer is reused
+    for(const std::string& name : {std::string("Chunked"), std::string("Contiguous")})
+    {
+      H5DatasetBlockReader<int32_t> reader(fileID, name, 10);
+      H5SUPPORT_REQUIRE(reader.isValid());
+      hsize_t expectedOffset = 0;
+      int32_t expectedValue = 0;
+      const int32_t* firstBuffer = nullptr;
+      while(reader.next())
+      {
+        H5SUPPORT_REQUIRE_EQUAL(reader.getBlockRowOffset(), expectedOffset)
+        H5SUPPORT_REQUIRE_EQUAL(reader.getBlockRowCount(), (expectedOffset == 90 ? 5 : 10))
+        if(firstBuffer == nullptr)
+        {
+          firstBuffer = reader.data();
+        }
+        H5SUPPORT_REQUIRE(reader.data() == firstBuffer);
+        for(hsize_t i = 0; i < reader.getBlockElementCount(); ++i)
+        {
+          H5SUPPORT_REQUIRE_EQUAL(reader.data()[i], expectedValue)
+          expectedValue++;
+        }
+        expectedOffset += reader.getBlockRowCount();
+      }
+      H5SUPPORT_REQUIRE_EQUAL(reader.getError(), 0)
+      H5SUPPORT_REQUIRE_EQUAL(expectedOffset, 95)
+      H5SUPPORT_REQUIRE(!reader.next());
+
+      // A reduction through the visitor after rewinding
+      reader.rewind();
+      int64_t sum = 0;
+      herr_t error = reader.visit([&sum, &reader](const int32_t* data, hsize_t /*rowOffset*/, hsize_t rowCount) {
+        for(hsize_t i = 0; i < rowCount * reader.getRowElementCount(); ++i)
+        {
+          sum += data[i];
+        }
+        return 0;
+      });
+      H5SUPPORT_REQUIRE(error >= 0);
+      H5SUPPORT_REQUIRE_EQUAL(sum, static_cast<int64_t>(95 * 6) * (95 * 6 - 1) / 2)
+    }
+
+    // A visitor can stop the walk early
+    {
+      H5DatasetBlockReader<int32_t> reader(fileID, "Chunked", 7);
+      hsize_t visited = 0;
+      herr_t error = reader.visit([&visited](const int32_t* /*data*/, hsize_t rowOffset, hsize_t /*rowCount*/) {
+        visited++;
+        return rowOffset >= 14 ? -5 : 0;
+      });
+      H5SUPPORT_REQUIRE_EQUAL(error, -5)
+      H5SUPPORT_REQUIRE_EQUAL(visited, 3)
+    }
+
+    // Scalars are a single block of one element; conversions happen in HDF5
+    {
+      H5DatasetBlockReader<float> reader(fileID, "Scalar");
+      H5SUPPORT_REQUIRE(reader.next());
+      H5SUPPORT_REQUIRE_EQUAL(reader.getBlockElementCount(), 1)
+      H5SUPPORT_REQUIRE_EQUAL(reader.data()[0], 42.0f)
+      H5SUPPORT_REQUIRE(!reader.next());
+    }
+
+    HDF_ERROR_HANDLER_OFF
+    {
+      H5DatasetBlockReader<int32_t> reader(fileID, "DoesNotExist");
+      H5SUPPORT_REQUIRE(!reader.isValid());
+      H5SUPPORT_REQUIRE(!reader.next());
+      H5SUPPORT_REQUIRE(reader.getError() < 0);
+    }
+    HDF_ERROR_HANDLER_ON
+
+    herr_t error = H5Utilities::closeFile(fileID);
+    H5SUPPORT_REQUIRE(error >= 0);
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  void operator()()
+  {
+    H5SUPPORT_REGISTER_TEST(TestWriteDatasets())
+    H5SUPPORT_REGISTER_TEST(TestReadBlocks())
+    H5SUPPORT_REGISTER_TEST(RemoveTestFiles())
+  }
+};
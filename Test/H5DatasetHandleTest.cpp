@@ -0,0 +1,237 @@
+/* ============================================================================
+ * Copyright (c) 2007-2019 BlueQuartz Software, LLC
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+ * contributors may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The code contained herein was partially funded by the followig contracts:
+ *    United States Air Force Prime Contract FA8650-04-C-5229
+ *    United States Air Force Prime Contract FA8650-15-D-5231
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+
+#include <cstdio>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "H5Support/H5DatasetAppender.h"
+#include "H5Support/H5DatasetHandle.h"
+#include "H5Support/H5Lite.h"
+#include "H5Support/H5SupportMutex.h"
+#include "H5Support/H5Utilities.h"
+
+#include "UnitTestSupport.h"
+
+#include "H5SupportTestFileLocations.h"
+
+#if defined(H5Support_NAMESPACE)
+using namespace H5Support_NAMESPACE;
+#endif
+
+class H5DatasetHandleTest
+{
+public:
+  H5DatasetHandleTest() = default;
+  ~H5DatasetHandleTest() = default;
+
+  H5DatasetHandleTest(const H5DatasetHandleTest&) = delete;            // Copy Constructor Not Implemented
+  H5DatasetHandleTest(H5DatasetHandleTest&&) = delete;                 // Move Constructor Not Implemented
+  H5DatasetHandleTest& operator=(const H5DatasetHandleTest&) = delete; // Copy Assignment Not Implemented
+  H5DatasetHandleTest& operator=(H5DatasetHandleTest&&) = delete;      // Move Assignment Not Implemented
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  void RemoveTestFiles()
+  {
+#if REMOVE_TEST_FILES
+    std::remove(UnitTest::H5DatasetHandleTest::FileName.c_str());
+#endif
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  void TestWriteDatasets()
+  {
+    hid_t fileID = H5Utilities::createFile(UnitTest::H5DatasetHandleTest::FileName);
+    H5SUPPORT_REQUIRE(fileID > 0);
+
+    std::vector<int32_t> values(4 * 5);
+    for(size_t i = 0; i < values.size(); ++i)
+    {
+      values[i] = static_cast<int32_t>(i);
+    }
+    herr_t error = H5Lite::writeVectorDataset(fileID, "Contiguous", {4, 5}, values);
+    H5SUPPORT_REQUIRE(error >= 0);
+    {
+      H5DatasetAppender<int32_t> appender(fileID, "Chunked", {5}, 2);
+      H5SUPPORT_REQUIRE(appender.append(values) >= 0);
+    }
+    error = H5Lite::writeScalarDataset(fileID, "Scalar", 42.0);
+    H5SUPPORT_REQUIRE(error >= 0);
+
+    error = H5Utilities::closeFile(fileID);
+    H5SUPPORT_REQUIRE(error >= 0);
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  void TestMetadata()
+  {
+    hid_t fileID = H5Utilities::openFile(UnitTest::H5DatasetHandleTest::FileName, true);
+    H5SUPPORT_REQUIRE(fileID > 0);
+
+    {
+      H5DatasetHandle handle = H5DatasetHandle::open(fileID, "Contiguous");
+      H5SUPPORT_REQUIRE(handle.isValid());
+      H5SUPPORT_REQUIRE((handle.getDimensions() == std::vector<hsize_t>{4, 5}));
+      H5SUPPORT_REQUIRE_EQUAL(handle.getNumberOfElements(), 20)
+      H5SUPPORT_REQUIRE_EQUAL(handle.getClassType(), H5T_INTEGER)
+      H5SUPPORT_REQUIRE_EQUAL(handle.getTypeSize(), sizeof(int32_t))
+      H5SUPPORT_REQUIRE_EQUAL(handle.getLayout(), H5D_CONTIGUOUS)
+      H5SUPPORT_REQUIRE(handle.getChunkDimensions().empty());
+      H5SUPPORT_REQUIRE(handle.getFilters().empty());
+    }
+    {
+      H5DatasetHandle handle = H5DatasetHandle::open(fileID, "Chunked");
+      H5SUPPORT_REQUIRE(handle.isValid());
+      H5SUPPORT_REQUIRE((handle.getDimensions() == std::vector<hsize_t>{4, 5}));
+      H5SUPPORT_REQUIRE_EQUAL(handle.getLayout(), H5D_CHUNKED)
+      H5SUPPORT_REQUIRE((handle.getChunkDimensions() == std::vector<hsize_t>{2, 5}));
+    }
+    {
+      H5DatasetHandle handle = H5DatasetHandle::open(fileID, "Scalar");
+      H5SUPPORT_REQUIRE_EQUAL(handle.getNumberOfElements(), 1)
+      H5SUPPORT_REQUIRE_EQUAL(handle.getClassType(), H5T_FLOAT)
+      H5SUPPORT_REQUIRE_EQUAL(handle.getTypeSize(), sizeof(double))
+      float value = 0.0f;
+      H5SUPPORT_REQUIRE(handle.read(&value) >= 0);
+      H5SUPPORT_REQUIRE_EQUAL(value, 42.0f)
+    }
+
+    // Ownership moves with the handle
+    {
+      H5DatasetHandle first = H5DatasetHandle::open(fileID, "Contiguous");
+      hid_t datasetID = first.getId();
+      H5DatasetHandle second(std::move(first));
+      H5SUPPORT_REQUIRE(!first.isValid());
+      H5SUPPORT_REQUIRE_EQUAL(second.getId(), datasetID)
+      first = std::move(second);
+      H5SUPPORT_REQUIRE(first.isValid());
+      H5SUPPORT_REQUIRE(!second.isValid());
+      H5SUPPORT_REQUIRE(first.close() >= 0);
+      H5SUPPORT_REQUIRE(!first.isValid());
+      H5SUPPORT_REQUIRE(first.close() >= 0);
+    }
+
+    HDF_ERROR_HANDLER_OFF
+    {
+      H5DatasetHandle handle = H5DatasetHandle::open(fileID, "DoesNotExist");
+      H5SUPPORT_REQUIRE(!handle.isValid());
+      std::vector<int32_t> data;
+      H5SUPPORT_REQUIRE(handle.read(data) < 0);
+    }
+    HDF_ERROR_HANDLER_ON
+
+    herr_t error = H5Utilities::closeFile(fileID);
+    H5SUPPORT_REQUIRE(error >= 0);
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  void TestReadWrite()
+  {
+    hid_t fileID = H5Utilities::openFile(UnitTest::H5DatasetHandleTest::FileName, false);
+    H5SUPPORT_REQUIRE(fileID > 0);
+
+    for(const std::string& name : {std::string("Contiguous"), std::string("Chunked")})
+    {
+      H5DatasetHandle handle = H5DatasetHandle::open(fileID, name);
+      H5SUPPORT_REQUIRE(handle.isValid());
+
+      std::vector<int32_t> data;
+      H5SUPPORT_REQUIRE(handle.read(data) >= 0);
+      H5SUPPORT_REQUIRE_EQUAL(data.size(), 20)
+      H5SUPPORT_REQUIRE_EQUAL(data[19], 19)
+
+      // Column 1 of every other row
+      std::vector<int32_t> slab;
+      herr_t error = handle.readSlab({0, 1}, {2, 1}, slab, {2, 1});
+      H5SUPPORT_REQUIRE(error >= 0);
+      H5SUPPORT_REQUIRE((slab == std::vector<int32_t>{1, 11}));
+
+      error = handle.writeSlab({1, 0}, {1, 5}, std::vector<int32_t>{-1, -2, -3, -4, -5});
+      H5SUPPORT_REQUIRE(error >= 0);
+      error = handle.writeSlab({1, 0}, {1, 5}, std::vector<int32_t>{-1, -2});
+      H5SUPPORT_REQUIRE(error < 0);
+
+      H5SUPPORT_REQUIRE(handle.read(data) >= 0);
+      H5SUPPORT_REQUIRE_EQUAL(data[4], 4)
+      H5SUPPORT_REQUIRE_EQUAL(data[5], -1)
+      H5SUPPORT_REQUIRE_EQUAL(data[9], -5)
+      H5SUPPORT_REQUIRE_EQUAL(data[10], 10)
+
+      // Whole dataset writes must match the cached extent
+      for(size_t i = 0; i < data.size(); ++i)
+      {
+        data[i] = static_cast<int32_t>(i * 2);
+      }
+      H5SUPPORT_REQUIRE(handle.write(data) >= 0);
+      H5SUPPORT_REQUIRE(handle.write(std::vector<int32_t>(3)) < 0);
+
+      std::vector<int32_t> readBack;
+      H5SUPPORT_REQUIRE(H5Lite::readVectorDataset(fileID, name, readBack) >= 0);
+      H5SUPPORT_REQUIRE(readBack == data);
+    }
+
+    // Opening, reading and closing only take the shared lock, so they nest in a read only scope
+    {
+      H5ScopedSharedMutexLock lock;
+      H5DatasetHandle handle = H5DatasetHandle::open(fileID, "Chunked");
+      std::vector<int32_t> slab;
+      H5SUPPORT_REQUIRE(handle.readSlab({0, 0}, {1, 2}, slab) >= 0);
+      H5SUPPORT_REQUIRE((slab == std::vector<int32_t>{0, 2}));
+    }
+
+    herr_t error = H5Utilities::closeFile(fileID);
+    H5SUPPORT_REQUIRE(error >= 0);
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  void operator()()
+  {
+    H5SUPPORT_REGISTER_TEST(TestWriteDatasets())
+    H5SUPPORT_REGISTER_TEST(TestMetadata())
+    H5SUPPORT_REGISTER_TEST(TestReadWrite())
+    H5SUPPORT_REGISTER_TEST(RemoveTestFiles())
+  }
+};
@@ -0,0 +1,189 @@
+/* ============================================================================
+ * Copyright (c) 2007-2019 BlueQuartz Software, LLC
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+ * contributors may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The code contained herein was partially funded by the followig contracts:
+ *    United States Air Force Prime Contract FA8650-04-C-5229
+ *    United States Air Force Prime Contract FA8650-15-D-5231
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#include <array>
+#include <cstdio>
+#include <list>
+#include <string>
+#include <vector>
+
+#include "H5Support/H5Instrumentation.h"
+#include "H5Support/H5Lite.h"
+#include "H5Support/H5Utilities.h"
+
+#include "UnitTestSupport.h"
+
+#include "H5SupportTestFileLocations.h"
+
+#if defined(H5Support_NAMESPACE)
+using namespace H5Support_NAMESPACE;
+#endif
+
+class H5InstrumentationTest
+{
+public:
+  H5InstrumentationTest() = default;
+  ~H5InstrumentationTest() = default;
+
+  H5InstrumentationTest(const H5InstrumentationTest&) = delete;            // Copy Constructor Not Implemented
+  H5InstrumentationTest(H5InstrumentationTest&&) = delete;                 // Move Constructor Not Implemented
+  H5InstrumentationTest& operator=(const H5InstrumentationTest&) = delete; // Copy Assignment Not Implemented
+  H5InstrumentationTest& operator=(H5InstrumentationTest&&) = delete;      // Move Assignment Not Implemented
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  void RemoveTestFiles()
+  {
+#if REMOVE_TEST_FILES
+    std::remove(UnitTest::H5InstrumentationTest::FileName.c_str());
+#endif
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  const H5FunctionStats* findStats(const std::vector<H5FunctionStats>& stats, const std::string& name)
+  {
+    for(const auto& current : stats)
+    {
+      if(current.name == name)
+      {
+        return &current;
+      }
+    }
+    return nullptr;
+  }
+
+  // -----------------------------------------------------------------------------
+  //  Exercise the registry directly so it is covered with instrumentation disabled
+  // -----------------------------------------------------------------------------
+  void TestRegistry()
+  {
+    H5Instrumentation& instrumentation = H5Instrumentation::instance();
+    H5FunctionCounters& counters = instrumentation.counters("H5InstrumentationTest::\"Registry\"");
+    H5SUPPORT_REQUIRE(&counters == &instrumentation.counters("H5InstrumentationTest::\"Registry\""));
+    {
+      H5ScopedInstrumentation scope(counters);
+      scope.lockAcquired();
+      scope.addBytes(128);
+    }
+    {
+      H5ScopedInstrumentation scope(counters);
+      scope.addBytes(64);
+    }
+
+    std::vector<H5FunctionStats> stats = instrumentation.snapshot();
+    const H5FunctionStats* registry = findStats(stats, "H5InstrumentationTest::\"Registry\"");
+    H5SUPPORT_REQUIRE(registry != nullptr);
+    H5SUPPORT_REQUIRE_EQUAL(registry->calls, 2)
+    H5SUPPORT_REQUIRE_EQUAL(registry->bytes, 192)
+    H5SUPPORT_REQUIRE(registry->wallTimeNs >= registry->lockWaitNs);
+
+    std::string json = instrumentation.toJson();
+    H5SUPPORT_REQUIRE(json.find("\"name\": \"H5InstrumentationTest::\\\"Registry\\\"\", \"calls\": 2, \"bytes\": 192") != std::string::npos);
+
+    instrumentation.reset();
+    stats = instrumentation.snapshot();
+    H5SUPPORT_REQUIRE(findStats(stats, "H5InstrumentationTest::\"Registry\"") == nullptr);
+    H5SUPPORT_REQUIRE_EQUAL(instrumentation.toJson(), std::string("{\n  \"functions\": []\n}\n"))
+  }
+
+  // -----------------------------------------------------------------------------
+  //  With H5Support_ENABLE_INSTRUMENTATION the entry points feed the registry
+  // -----------------------------------------------------------------------------
+  void TestEntryPoints()
+  {
+    H5Instrumentation& instrumentation = H5Instrumentation::instance();
+    instrumentation.reset();
+
+    hid_t fileID = H5Utilities::createFile(UnitTest::H5InstrumentationTest::FileName);
+    H5SUPPORT_REQUIRE(fileID > 0);
+
+    std::array<int32_t, 100> data = {};
+    std::array<hsize_t, 1> dims = {data.size()};
+    herr_t err = H5Lite::writePointerDataset(fileID, "Data", static_cast<int32_t>(dims.size()), dims.data(), data.data());
+    H5SUPPORT_REQUIRE(err >= 0);
+    err = H5Lite::writePointerAttribute(fileID, "Data", "Attribute", static_cast<int32_t>(dims.size()), dims.data(), data.data());
+    H5SUPPORT_REQUIRE(err >= 0);
+    std::vector<int32_t> readBack;
+    err = H5Lite::readVectorDataset(fileID, "Data", readBack);
+    H5SUPPORT_REQUIRE(err >= 0);
+    err = H5Lite::readVectorDataset(fileID, "Data", readBack);
+    H5SUPPORT_REQUIRE(err >= 0);
+    std::list<std::string> names;
+    err = H5Utilities::getGroupObjects(fileID, H5Utilities::CustomHDFDataTypes::Any, names);
+    H5SUPPORT_REQUIRE(err >= 0);
+
+    std::vector<H5FunctionStats> stats = instrumentation.snapshot();
+#ifdef H5Support_ENABLE_INSTRUMENTATION
+    const H5FunctionStats* write = findStats(stats, "writePointerDataset");
+    H5SUPPORT_REQUIRE(write != nullptr);
+    H5SUPPORT_REQUIRE_EQUAL(write->calls, 1)
+    H5SUPPORT_REQUIRE_EQUAL(write->bytes, sizeof(data))
+
+    const H5FunctionStats* attribute = findStats(stats, "writePointerAttribute");
+    H5SUPPORT_REQUIRE(attribute != nullptr);
+    H5SUPPORT_REQUIRE_EQUAL(attribute->bytes, sizeof(data))
+
+    const H5FunctionStats* read = findStats(stats, "readVectorDataset");
+    H5SUPPORT_REQUIRE(read != nullptr);
+    H5SUPPORT_REQUIRE_EQUAL(read->calls, 2)
+    H5SUPPORT_REQUIRE_EQUAL(read->bytes, 2 * sizeof(data))
+
+    const H5FunctionStats* groupObjects = findStats(stats, "getGroupObjects");
+    H5SUPPORT_REQUIRE(groupObjects != nullptr);
+    H5SUPPORT_REQUIRE_EQUAL(groupObjects->calls, 1)
+
+    std::string jsonPath = UnitTest::H5InstrumentationTest::FileName + ".json";
+    H5SUPPORT_REQUIRE(instrumentation.writeJson(jsonPath) >= 0);
+    std::remove(jsonPath.c_str());
+#else
+    H5SUPPORT_REQUIRE(stats.empty());
+#endif
+
+    err = H5Utilities::closeFile(fileID);
+    H5SUPPORT_REQUIRE(err >= 0);
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  void operator()()
+  {
+    H5SUPPORT_REGISTER_TEST(TestRegistry())
+    H5SUPPORT_REGISTER_TEST(TestEntryPoints())
+    H5SUPPORT_REGISTER_TEST(RemoveTestFiles())
+  }
+};
@@ -0,0 +1,193 @@
+/* ============================================================================
+ * Copyright (c) 2007-2019 BlueQuartz Software, LLC
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+ * contributors may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The code contained herein was partially funded by the followig contracts:
+ *    United States Air Force Prime Contract FA8650-04-C-5229
+ *    United States Air Force Prime Contract FA8650-15-D-5231
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <future>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "H5Support/H5Lite.h"
+#include "H5Support/H5LiteAsync.h"
+#include "H5Support/H5TaskExecutor.h"
+#include "H5Support/H5Utilities.h"
+
+#include "UnitTestSupport.h"
+
+#include "H5SupportTestFileLocations.h"
+
+#if defined(H5Support_NAMESPACE)
+using namespace H5Support_NAMESPACE;
+#endif
+
+class H5LiteAsyncTest
+{
+public:
+  H5LiteAsyncTest() = default;
+  ~H5LiteAsyncTest() = default;
+
+  H5LiteAsyncTest(const H5LiteAsyncTest&) = delete;            // Copy Constructor Not Implemented
+  H5LiteAsyncTest(H5LiteAsyncTest&&) = delete;                 // Move Constructor Not Implemented
+  H5LiteAsyncTest& operator=(const H5LiteAsyncTest&) = delete; // Copy Assignment Not Implemented
+  H5LiteAsyncTest& operator=(H5LiteAsyncTest&&) = delete;      // Move Assignment Not Implemented
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  void RemoveTestFiles()
+  {
+#if REMOVE_TEST_FILES
+    std::remove(UnitTest::H5LiteAsyncTest::FileName.c_str());
+#endif
+  }
+
+  // -----------------------------------------------------------------------------
+  //  A single worker runs tasks in order and submit() blocks once the queue is full
+  // -----------------------------------------------------------------------------
+  void TestExecutor()
+  {
+    std::vector<std::future<size_t>> futures;
+    std::vector<size_t> order;
+    {
+      H5TaskExecutor executor(1, 2);
+      H5SUPPORT_REQUIRE_EQUAL(executor.getThreadCount(), 1)
+      H5SUPPORT_REQUIRE_EQUAL(executor.getQueueCapacity(), 2)
+
+      std::promise<void> gate;
+      std::shared_future<void> gateFuture = gate.get_future().share();
+      std::future<void> blocker = executor.submit([gateFuture]() { gateFuture.wait(); });
+
+      futures.push_back(executor.submit([&order]() {
+        order.push_back(0);
+        return static_cast<size_t>(0);
+      }));
+      futures.push_back(executor.submit([&order]() {
+        order.push_back(1);
+        return static_cast<size_t>(1);
+      }));
+
+      // The worker is stuck on the blocker and the queue holds two tasks: the next
+      // submit has to wait until the worker drains the queue
+      std::atomic<bool> submitted(false);
+      std::thread producer([&executor, &futures, &order, &submitted]() {
+        futures.push_back(executor.submit([&order]() {
+          order.push_back(2);
+          return static_cast<size_t>(2);
+        }));
+        submitted = true;
+      });
+      std::this_thread::sleep_for(std::chrono::milliseconds(50));
+      H5SUPPORT_REQUIRE(!submitted.load());
+      gate.set_value();
+      producer.join();
+      H5SUPPORT_REQUIRE(submitted.load());
+      blocker.get();
+    } // Destructor drains the queue
+    H5SUPPORT_REQUIRE_EQUAL(futures.size(), 3)
+    for(size_t i = 0; i < futures.size(); ++i)
+    {
+      H5SUPPORT_REQUIRE_EQUAL(futures[i].get(), i)
+    }
+    H5SUPPORT_REQUIRE((order == std::vector<size_t>{0, 1, 2}));
+  }
+
+  // -----------------------------------------------------------------------------
+  //  Write and read back through the I/O thread while this thread keeps computing
+  // -----------------------------------------------------------------------------
+  void TestAsyncReadWrite()
+  {
+    std::future<hid_t> fileFuture = H5Lite::async::run([]() { return H5Utilities::createFile(UnitTest::H5LiteAsyncTest::FileName); });
+    hid_t fileID = fileFuture.get();
+    H5SUPPORT_REQUIRE(fileID > 0);
+
+    constexpr size_t k_NumDatasets = 16;
+    constexpr size_t k_NumElements = 10000;
+    std::vector<std::vector<double>> buffers(k_NumDatasets);
+    std::vector<std::future<herr_t>> writes;
+    std::array<hsize_t, 1> dims = {k_NumElements};
+    for(size_t d = 0; d < k_NumDatasets; ++d)
+    {
+      // "Compute" the next buffer while the previous ones are being written
+      buffers[d].resize(k_NumElements);
+      for(size_t i = 0; i < k_NumElements; ++i)
+      {
+        buffers[d][i] = static_cast<double>(d) + static_cast<double>(i) * 0.25;
+      }
+      writes.push_back(H5Lite::async::writePointerDataset(fileID, "Pointer_" + std::to_string(d), static_cast<int32_t>(dims.size()), dims.data(), buffers[d].data()));
+    }
+
+    std::vector<int32_t> moved(k_NumElements, 42);
+    writes.push_back(H5Lite::async::writeVectorDataset(fileID, "Moved", std::vector<hsize_t>{k_NumElements}, std::move(moved)));
+
+    for(auto& write : writes)
+    {
+      H5SUPPORT_REQUIRE(write.get() >= 0);
+    }
+
+    std::vector<std::vector<double>> readBack(k_NumDatasets);
+    std::vector<std::future<herr_t>> reads;
+    for(size_t d = 0; d < k_NumDatasets; ++d)
+    {
+      reads.push_back(H5Lite::async::readVectorDataset(fileID, "Pointer_" + std::to_string(d), readBack[d]));
+    }
+    std::vector<int32_t> movedReadBack(k_NumElements, 0);
+    reads.push_back(H5Lite::async::readPointerDataset(fileID, "Moved", movedReadBack.data()));
+    for(auto& read : reads)
+    {
+      H5SUPPORT_REQUIRE(read.get() >= 0);
+    }
+    for(size_t d = 0; d < k_NumDatasets; ++d)
+    {
+      H5SUPPORT_REQUIRE(readBack[d] == buffers[d]);
+    }
+    H5SUPPORT_REQUIRE((movedReadBack == std::vector<int32_t>(k_NumElements, 42)));
+
+    std::future<herr_t> closeFuture = H5Lite::async::run([&fileID]() { return H5Utilities::closeFile(fileID); });
+    H5SUPPORT_REQUIRE(closeFuture.get() >= 0);
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  void operator()()
+  {
+    H5SUPPORT_REGISTER_TEST(TestExecutor())
+    H5SUPPORT_REGISTER_TEST(TestAsyncReadWrite())
+    H5SUPPORT_REGISTER_TEST(RemoveTestFiles())
+  }
+};
@@ -0,0 +1,156 @@
+/* ============================================================================
+ * Copyright (c) 2007-2019 BlueQuartz Software, LLC
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+ * contributors may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The code contained herein was partially funded by the followig contracts:
+ *    United States Air Force Prime Contract FA8650-04-C-5229
+ *    United States Air Force Prime Contract FA8650-15-D-5231
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "H5Support/H5AttributeWriter.h"
+#include "H5Support/H5Lite.h"
+#include "H5Support/H5LiteAttributes.h"
+#include "H5Support/H5Utilities.h"
+
+#include "UnitTestSupport.h"
+
+#include "H5SupportTestFileLocations.h"
+
+#if defined(H5Support_NAMESPACE)
+using namespace H5Support_NAMESPACE;
+#endif
+
+class H5LiteAttributesTest
+{
+public:
+  H5LiteAttributesTest() = default;
+  ~H5LiteAttributesTest() = default;
+
+  H5LiteAttributesTest(const H5LiteAttributesTest&) = delete;            // Copy Constructor Not Implemented
+  H5LiteAttributesTest(H5LiteAttributesTest&&) = delete;                 // Move Constructor Not Implemented
+  H5LiteAttributesTest& operator=(const H5LiteAttributesTest&) = delete; // Copy Assignment Not Implemented
+  H5LiteAttributesTest& operator=(H5LiteAttributesTest&&) = delete;      // Move Assignment Not Implemented
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  void RemoveTestFiles()
+  {
+#if REMOVE_TEST_FILES
+    std::remove(UnitTest::H5LiteAttributesTest::FileName.c_str());
+#endif
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  void TestReadAllAttributes()
+  {
+    hid_t fileID = H5Utilities::createFile(UnitTest::H5LiteAttributesTest::FileName);
+    H5SUPPORT_REQUIRE(fileID > 0);
+
+    herr_t error = H5Lite::writeVectorDataset(fileID, "Data", {2}, std::vector<int32_t>{1, 2});
+    H5SUPPORT_REQUIRE(error >= 0);
+    {
+      H5AttributeWriter writer(fileID, "Data");
+      writer.writeString("Units", "mm");
+      writer.writeScalar("Offset", int8_t(-3));
+      writer.writeScalar("Count", uint64_t(1) << 40);
+      writer.writeVector("Matrix", {2, 3}, std::vector<float>{1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f});
+      H5SUPPORT_REQUIRE(writer.close() >= 0);
+    }
+
+    // A variable length string attribute written with the raw API
+    {
+      hid_t datasetID = H5Dopen(fileID, "Data", H5P_DEFAULT);
+      hid_t typeID = H5Tcopy(H5T_C_S1);
+      H5Tset_size(typeID, H5T_VARIABLE);
+      hid_t dataspaceID = H5Screate(H5S_SCALAR);
+      hid_t attributeID = H5Acreate(datasetID, "Comment", typeID, dataspaceID, H5P_DEFAULT, H5P_DEFAULT);
+      const char* comment = "variable length";
+      H5SUPPORT_REQUIRE(H5Awrite(attributeID, typeID, &comment) >= 0);
+      H5Aclose(attributeID);
+      H5Sclose(dataspaceID);
+      H5Tclose(typeID);
+      H5Dclose(datasetID);
+    }
+
+    H5AttributeMap attributes;
+    error = H5Lite::readAllAttributes(fileID, "Data", attributes);
+    H5SUPPORT_REQUIRE(error >= 0);
+    H5SUPPORT_REQUIRE_EQUAL(attributes.size(), 5)
+
+    const H5AttributeValue& units = attributes["Units"];
+    H5SUPPORT_REQUIRE_EQUAL(units.classType, H5T_STRING)
+    H5SUPPORT_REQUIRE_EQUAL(units.getString(), "mm")
+    H5SUPPORT_REQUIRE_EQUAL(attributes["Comment"].getString(), "variable length")
+
+    const H5AttributeValue& offset = attributes["Offset"];
+    H5SUPPORT_REQUIRE_EQUAL(offset.classType, H5T_INTEGER)
+    H5SUPPORT_REQUIRE_EQUAL(offset.typeSize, 1)
+    H5SUPPORT_REQUIRE(offset.isSigned);
+    H5SUPPORT_REQUIRE_EQUAL(offset.getValue<int32_t>(), -3)
+
+    const H5AttributeValue& count = attributes["Count"];
+    H5SUPPORT_REQUIRE(!count.isSigned);
+    H5SUPPORT_REQUIRE_EQUAL(count.getValue<uint64_t>(), uint64_t(1) << 40)
+
+    const H5AttributeValue& matrix = attributes["Matrix"];
+    H5SUPPORT_REQUIRE_EQUAL(matrix.classType, H5T_FLOAT)
+    H5SUPPORT_REQUIRE((matrix.dims == std::vector<hsize_t>{2, 3}));
+    H5SUPPORT_REQUIRE_EQUAL(matrix.getNumberOfElements(), 6)
+    H5SUPPORT_REQUIRE((matrix.getValues<float>() == std::vector<float>{1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f}));
+
+    // An object without attributes yields an empty map
+    error = H5Lite::readAllAttributes(fileID, "/", attributes);
+    H5SUPPORT_REQUIRE(error >= 0);
+    H5SUPPORT_REQUIRE(attributes.empty());
+
+    HDF_ERROR_HANDLER_OFF
+    error = H5Lite::readAllAttributes(fileID, "DoesNotExist", attributes);
+    H5SUPPORT_REQUIRE(error < 0);
+    HDF_ERROR_HANDLER_ON
+
+    error = H5Utilities::closeFile(fileID);
+    H5SUPPORT_REQUIRE(error >= 0);
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  void operator()()
+  {
+    H5SUPPORT_REGISTER_TEST(TestReadAllAttributes())
+    H5SUPPORT_REGISTER_TEST(RemoveTestFiles())
+  }
+};
@@ -0,0 +1,184 @@
+/* ============================================================================
+ * Copyright (c) 2007-2019 BlueQuartz Software, LLC
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+ * contributors may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The code contained herein was partially funded by the followig contracts:
+ *    United States Air Force Prime Contract FA8650-04-C-5229
+ *    United States Air Force Prime Contract FA8650-15-D-5231
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "H5Support/H5Lite.h"
+#include "H5Support/H5LiteGather.h"
+#include "H5Support/H5Utilities.h"
+
+#include "UnitTestSupport.h"
+
+#include "H5SupportTestFileLocations.h"
+
+#if defined(H5Support_NAMESPACE)
+using namespace H5Support_NAMESPACE;
+#endif
+
+class H5LiteGatherTest
+{
+public:
+  H5LiteGatherTest() = default;
+  ~H5LiteGatherTest() = default;
+
+  H5LiteGatherTest(const H5LiteGatherTest&) = delete;            // Copy Constructor Not Implemented
+  H5LiteGatherTest(H5LiteGatherTest&&) = delete;                 // Move Constructor Not Implemented
+  H5LiteGatherTest& operator=(const H5LiteGatherTest&) = delete; // Copy Assignment Not Implemented
+  H5LiteGatherTest& operator=(H5LiteGatherTest&&) = delete;      // Move Assignment Not Implemented
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  void RemoveTestFiles()
+  {
+#if REMOVE_TEST_FILES
+    std::remove(UnitTest::H5LiteGatherTest::FileName.c_str());
+#endif
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  void TestWriteDatasets()
+  {
+    hid_t fileID = H5Utilities::createFile(UnitTest::H5LiteGatherTest::FileName);
+    H5SUPPORT_REQUIRE(fileID > 0);
+
+    // Value of (z, y, x) is z * 100 + y * 10 + x
+    std::vector<int32_t> volume(4 * 10 * 10);
+    for(size_t i = 0; i < volume.size(); ++i)
+    {
+      volume[i] = static_cast<int32_t>(i);
+    }
+    herr_t error = H5Lite::writeVectorDataset(fileID, "Volume", {4, 10, 10}, volume);
+    H5SUPPORT_REQUIRE(error >= 0);
+
+    error = H5Utilities::closeFile(fileID);
+    H5SUPPORT_REQUIRE(error >= 0);
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  void TestPoints()
+  {
+    hid_t fileID = H5Utilities::openFile(UnitTest::H5LiteGatherTest::FileName, true);
+    H5SUPPORT_REQUIRE(fileID > 0);
+
+    // Points arrive in the order they are listed, not in file order
+    std::vector<hsize_t> coords = {3, 9, 9, 0, 0, 0, 2, 5, 1, 0, 0, 7};
+    std::vector<int32_t> data;
+    herr_t error = H5Lite::readVectorDatasetPoints(fileID, "Volume", coords, data);
+    H5SUPPORT_REQUIRE(error >= 0);
+    H5SUPPORT_REQUIRE((data == std::vector<int32_t>{399, 0, 251, 7}));
+
+    std::vector<float> values(4, 0.0f);
+    error = H5Lite::readPointerDatasetPoints(fileID, "Volume", 4, coords.data(), values.data());
+    H5SUPPORT_REQUIRE(error >= 0);
+    H5SUPPORT_REQUIRE_EQUAL(values[2], 251.0f)
+
+    HDF_ERROR_HANDLER_OFF
+    error = H5Lite::readVectorDatasetPoints(fileID, "Volume", std::vector<hsize_t>{1, 2}, data);
+    H5SUPPORT_REQUIRE(error < 0);
+    error = H5Lite::readVectorDatasetPoints(fileID, "Volume", std::vector<hsize_t>{4, 0, 0}, data);
+    H5SUPPORT_REQUIRE(error < 0);
+    error = H5Lite::readVectorDatasetPoints(fileID, "DoesNotExist", coords, data);
+    H5SUPPORT_REQUIRE(error < 0);
+    HDF_ERROR_HANDLER_ON
+
+    error = H5Utilities::closeFile(fileID);
+    H5SUPPORT_REQUIRE(error >= 0);
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  void TestRegions()
+  {
+    hid_t fileID = H5Utilities::openFile(UnitTest::H5LiteGatherTest::FileName, true);
+    H5SUPPORT_REQUIRE(fileID > 0);
+
+    // Two rows of slice 1, listed out of order, plus an overlapping column run
+    std::vector<H5Hyperslab> regions(3);
+    regions[0].offset = {1, 5, 0};
+    regions[0].count = {1, 1, 3};
+    regions[1].offset = {1, 2, 0};
+    regions[1].count = {1, 1, 3};
+    regions[2].offset = {1, 2, 2};
+    regions[2].count = {1, 3, 1};
+    regions[2].stride = {1, 3, 1};
+    std::vector<int32_t> data;
+    herr_t error = H5Lite::readVectorDatasetRegions(fileID, "Volume", regions, data);
+    H5SUPPORT_REQUIRE(error >= 0);
+    H5SUPPORT_REQUIRE((data == std::vector<int32_t>{120, 121, 122, 150, 151, 152, 182}));
+
+    // Strided blocks
+    std::vector<H5Hyperslab> blocks(1);
+    blocks[0].offset = {0, 0, 0};
+    blocks[0].count = {2, 1, 2};
+    blocks[0].stride = {3, 1, 5};
+    blocks[0].block = {1, 1, 2};
+    H5SUPPORT_REQUIRE_EQUAL(blocks[0].getNumberOfElements(), 8)
+    std::vector<int64_t> values(8);
+    error = H5Lite::readPointerDatasetRegions(fileID, "Volume", blocks, values.data());
+    H5SUPPORT_REQUIRE(error >= 0);
+    H5SUPPORT_REQUIRE((values == std::vector<int64_t>{0, 1, 5, 6, 300, 301, 305, 306}));
+
+    HDF_ERROR_HANDLER_OFF
+    std::vector<H5Hyperslab> badRank(1);
+    badRank[0].offset = {0, 0};
+    badRank[0].count = {1, 1};
+    error = H5Lite::readVectorDatasetRegions(fileID, "Volume", badRank, data);
+    H5SUPPORT_REQUIRE(error < 0);
+    error = H5Lite::readVectorDatasetRegions(fileID, "Volume", std::vector<H5Hyperslab>(), data);
+    H5SUPPORT_REQUIRE(error < 0);
+    HDF_ERROR_HANDLER_ON
+
+    error = H5Utilities::closeFile(fileID);
+    H5SUPPORT_REQUIRE(error >= 0);
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  void operator()()
+  {
+    H5SUPPORT_REGISTER_TEST(TestWriteDatasets())
+    H5SUPPORT_REGISTER_TEST(TestPoints())
+    H5SUPPORT_REGISTER_TEST(TestRegions())
+    H5SUPPORT_REGISTER_TEST(RemoveTestFiles())
+  }
+};
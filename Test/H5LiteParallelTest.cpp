@@ -0,0 +1,260 @@
+/* ============================================================================
+ * Copyright (c) 2007-2019 BlueQuartz Software, LLC
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+ * contributors may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The code contained herein was partially funded by the followig contracts:
+ *    United States Air Force Prime Contract FA8650-04-C-5229
+ *    United States Air Force Prime Contract FA8650-15-D-5231
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#include <algorithm>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "H5Support/H5DefaultInitAllocator.h"
+#include "H5Support/H5Lite.h"
+#include "H5Support/H5Utilities.h"
+
+#ifdef H5Support_USE_ZLIB
+#include "H5Support/H5LiteParallel.h"
+#endif
+
+#include "UnitTestSupport.h"
+
+#include "H5SupportTestFileLocations.h"
+
+#if defined(H5Support_NAMESPACE)
+using namespace H5Support_NAMESPACE;
+#endif
+
+class H5LiteParallelTest
+{
+public:
+  H5LiteParallelTest() = default;
+  ~H5LiteParallelTest() = default;
+
+  H5LiteParallelTest(const H5LiteParallelTest&) = delete;            // Copy Constructor Not Implemented
+  H5LiteParallelTest(H5LiteParallelTest&&) = delete;                 // Move Constructor Not Implemented
+  H5LiteParallelTest& operator=(const H5LiteParallelTest&) = delete; // Copy Assignment Not Implemented
+  H5LiteParallelTest& operator=(H5LiteParallelTest&&) = delete;      // Move Assignment Not Implemented
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  void RemoveTestFiles()
+  {
+#if REMOVE_TEST_FILES
+    std::remove(UnitTest::H5LiteParallelTest::FileName.c_str());
+#endif
+  }
+
+#if defined(H5Support_USE_ZLIB) && defined(H5_HAVE_FILTER_DEFLATE) && H5_VERSION_GE(1, 10, 5)
+  // -----------------------------------------------------------------------------
+  //  Every stored chunk must be identical between the two datasets
+  // -----------------------------------------------------------------------------
+  void requireSameChunks(hid_t fileID, const std::string& serialName, const std::string& parallelName)
+  {
+    hid_t serialID = H5Dopen(fileID, serialName.c_str(), H5P_DEFAULT);
+    hid_t parallelID = H5Dopen(fileID, parallelName.c_str(), H5P_DEFAULT);
+    H5SUPPORT_REQUIRE(serialID >= 0);
+    H5SUPPORT_REQUIRE(parallelID >= 0);
+
+    hid_t dataspaceID = H5Dget_space(serialID);
+    hsize_t numChunks = 0;
+    H5SUPPORT_REQUIRE(H5Dget_num_chunks(serialID, dataspaceID, &numChunks) >= 0);
+    hsize_t parallelChunks = 0;
+    H5SUPPORT_REQUIRE(H5Dget_num_chunks(parallelID, dataspaceID, &parallelChunks) >= 0);
+    H5SUPPORT_REQUIRE_EQUAL(numChunks, parallelChunks)
+    int rank = H5Sget_simple_extent_ndims(dataspaceID);
+    for(hsize_t i = 0; i < numChunks; ++i)
+    {
+      std::vector<hsize_t> offset(rank, 0);
+      unsigned filterMask = 0;
+      hsize_t serialSize = 0;
+      H5SUPPORT_REQUIRE(H5Dget_chunk_info(serialID, dataspaceID, i, offset.data(), &filterMask, nullptr, &serialSize) >= 0);
+      hsize_t parallelSize = 0;
+      H5SUPPORT_REQUIRE(H5Dget_chunk_storage_size(parallelID, offset.data(), &parallelSize) >= 0);
+      H5SUPPORT_REQUIRE_EQUAL(serialSize, parallelSize)
+
+      std::vector<uint8_t> serialBytes(serialSize);
+      std::vector<uint8_t> parallelBytes(parallelSize);
+      uint32_t serialMask = 0;
+      uint32_t parallelMask = 0;
+      H5SUPPORT_REQUIRE(H5Dread_chunk(serialID, H5P_DEFAULT, offset.data(), &serialMask, serialBytes.data()) >= 0);
+      H5SUPPORT_REQUIRE(H5Dread_chunk(parallelID, H5P_DEFAULT, offset.data(), &parallelMask, parallelBytes.data()) >= 0);
+      H5SUPPORT_REQUIRE_EQUAL(serialMask, parallelMask)
+      H5SUPPORT_REQUIRE(serialBytes == parallelBytes);
+    }
+    H5Sclose(dataspaceID);
+    H5Dclose(parallelID);
+    H5Dclose(serialID);
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  void TestCompressedWrite()
+  {
+    hid_t fileID = H5Utilities::createFile(UnitTest::H5LiteParallelTest::FileName);
+    H5SUPPORT_REQUIRE(fileID > 0);
+
+    // Dimensions that are not multiples of the chunk dimensions produce edge chunks
+    const std::vector<hsize_t> dims = {13, 37, 50};
+    const std::vector<hsize_t> cDims = {4, 16, 16};
+    std::vector<float> volume(13 * 37 * 50);
+    for(size_t i = 0; i < volume.size(); ++i)
+    {
+      volume[i] = static_cast<float>(i % 97) * 0.5f;
+    }
+
+    herr_t error = H5Lite::writeVectorDatasetCompressed(fileID, "Serial", dims, volume, cDims, 6);
+    H5SUPPORT_REQUIRE(error >= 0);
+    error = H5Lite::writeVectorDatasetCompressedParallel(fileID, "Parallel", dims, volume, cDims, 6, 4);
+    H5SUPPORT_REQUIRE(error >= 0);
+    error = H5Lite::writeVectorDatasetCompressedParallel(fileID, "SingleThread", dims, volume, cDims, 6, 1);
+    H5SUPPORT_REQUIRE(error >= 0);
+
+    requireSameChunks(fileID, "Serial", "Parallel");
+    requireSameChunks(fileID, "Serial", "SingleThread");
+
+    std::vector<float> readBack;
+    error = H5Lite::readVectorDataset(fileID, "Parallel", readBack);
+    H5SUPPORT_REQUIRE(error >= 0);
+    H5SUPPORT_REQUIRE(readBack == volume);
+
+    // Random bytes do not compress; the chunks must still match the deflate filter
+    std::vector<uint8_t> noise(1000);
+    uint32_t state = 12345;
+    for(auto& value : noise)
+    {
+      state = state * 1664525u + 1013904223u;
+      value = static_cast<uint8_t>(state >> 24);
+    }
+    error = H5Lite::writeVectorDatasetCompressed(fileID, "SerialNoise", {1000}, noise, {256}, 9);
+    H5SUPPORT_REQUIRE(error >= 0);
+    error = H5Lite::writeVectorDatasetCompressedParallel(fileID, "ParallelNoise", {1000}, noise, {256}, 9);
+    H5SUPPORT_REQUIRE(error >= 0);
+    requireSameChunks(fileID, "SerialNoise", "ParallelNoise");
+
+    // Mismatched chunk rank
+    error = H5Lite::writeVectorDatasetCompressedParallel(fileID, "BadChunks", dims, volume, {4, 16}, 6);
+    H5SUPPORT_REQUIRE(error < 0);
+
+    error = H5Utilities::closeFile(fileID);
+    H5SUPPORT_REQUIRE(error >= 0);
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  void TestCompressedRead()
+  {
+    hid_t fileID = H5Utilities::openFile(UnitTest::H5LiteParallelTest::FileName, false);
+    H5SUPPORT_REQUIRE(fileID > 0);
+
+    std::vector<float> expected;
+    herr_t error = H5Lite::readVectorDataset(fileID, "Serial", expected);
+    H5SUPPORT_REQUIRE(error >= 0);
+
+    for(const std::string& name : {std::string("Serial"), std::string("Parallel")})
+    {
+      for(size_t threadCount : {1, 3, 0})
+      {
+        std::vector<float> readBack;
+        error = H5Lite::readVectorDatasetCompressedParallel(fileID, name, readBack, threadCount);
+        H5SUPPORT_REQUIRE(error >= 0);
+        H5SUPPORT_REQUIRE(readBack == expected);
+      }
+    }
+
+    UninitializedVector<float> uninitialized;
+    error = H5Lite::readVectorDatasetCompressedParallel(fileID, "Parallel", uninitialized);
+    H5SUPPORT_REQUIRE(error >= 0);
+    H5SUPPORT_REQUIRE(std::equal(expected.cbegin(), expected.cend(), uninitialized.cbegin(), uninitialized.cend()));
+
+    // Chunks the deflate filter could not shrink
+    std::vector<uint8_t> noise;
+    error = H5Lite::readVectorDataset(fileID, "SerialNoise", noise);
+    H5SUPPORT_REQUIRE(error >= 0);
+    std::vector<uint8_t> noiseReadBack;
+    error = H5Lite::readVectorDatasetCompressedParallel(fileID, "SerialNoise", noiseReadBack);
+    H5SUPPORT_REQUIRE(error >= 0);
+    H5SUPPORT_REQUIRE(noiseReadBack == noise);
+
+    // Falls back to H5Dread: type conversion, contiguous layout and other filters
+    std::vector<double> converted;
+    error = H5Lite::readVectorDatasetCompressedParallel(fileID, "Serial", converted);
+    H5SUPPORT_REQUIRE(error >= 0);
+    H5SUPPORT_REQUIRE_EQUAL(converted.size(), expected.size())
+    H5SUPPORT_REQUIRE_EQUAL(converted[1234], static_cast<double>(expected[1234]))
+
+    error = H5Lite::writeVectorDataset(fileID, "Contiguous", {static_cast<hsize_t>(expected.size())}, expected);
+    H5SUPPORT_REQUIRE(error >= 0);
+    std::vector<float> contiguous;
+    error = H5Lite::readVectorDatasetCompressedParallel(fileID, "Contiguous", contiguous);
+    H5SUPPORT_REQUIRE(error >= 0);
+    H5SUPPORT_REQUIRE(contiguous == expected);
+
+    {
+      hsize_t dims = expected.size();
+      hsize_t cDims = 1000;
+      hid_t dataspaceID = H5Screate_simple(1, &dims, nullptr);
+      hid_t propertyListID = H5Pcreate(H5P_DATASET_CREATE);
+      H5Pset_chunk(propertyListID, 1, &cDims);
+      H5Pset_shuffle(propertyListID);
+      H5Pset_deflate(propertyListID, 4);
+      hid_t datasetID = H5Dcreate(fileID, "Shuffled", H5T_NATIVE_FLOAT, dataspaceID, H5P_DEFAULT, propertyListID, H5P_DEFAULT);
+      H5SUPPORT_REQUIRE(datasetID >= 0);
+      H5SUPPORT_REQUIRE(H5Dwrite(datasetID, H5T_NATIVE_FLOAT, H5S_ALL, H5S_ALL, H5P_DEFAULT, expected.data()) >= 0);
+      H5Dclose(datasetID);
+      H5Pclose(propertyListID);
+      H5Sclose(dataspaceID);
+    }
+    std::vector<float> shuffled;
+    error = H5Lite::readVectorDatasetCompressedParallel(fileID, "Shuffled", shuffled);
+    H5SUPPORT_REQUIRE(error >= 0);
+    H5SUPPORT_REQUIRE(shuffled == expected);
+
+    error = H5Utilities::closeFile(fileID);
+    H5SUPPORT_REQUIRE(error >= 0);
+  }
+#endif
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  void operator()()
+  {
+#if defined(H5Support_USE_ZLIB) && defined(H5_HAVE_FILTER_DEFLATE) && H5_VERSION_GE(1, 10, 5)
+    H5SUPPORT_REGISTER_TEST(TestCompressedWrite())
+    H5SUPPORT_REGISTER_TEST(TestCompressedRead())
+#endif
+    H5SUPPORT_REGISTER_TEST(RemoveTestFiles())
+  }
+};
@@ -0,0 +1,225 @@
+/* ============================================================================
+ * Copyright (c) 2007-2019 BlueQuartz Software, LLC
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+ * contributors may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The code contained herein was partially funded by the followig contracts:
+ *    United States Air Force Prime Contract FA8650-04-C-5229
+ *    United States Air Force Prime Contract FA8650-15-D-5231
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "H5Support/H5Lite.h"
+#include "H5Support/H5LiteReducedPrecision.h"
+#include "H5Support/H5Utilities.h"
+
+#include "UnitTestSupport.h"
+
+#include "H5SupportTestFileLocations.h"
+
+#if defined(H5Support_NAMESPACE)
+using namespace H5Support_NAMESPACE;
+#endif
+
+class H5LiteReducedPrecisionTest
+{
+public:
+  H5LiteReducedPrecisionTest() = default;
+  ~H5LiteReducedPrecisionTest() = default;
+
+  H5LiteReducedPrecisionTest(const H5LiteReducedPrecisionTest&) = delete;            // Copy Constructor Not Implemented
+  H5LiteReducedPrecisionTest(H5LiteReducedPrecisionTest&&) = delete;                 // Move Constructor Not Implemented
+  H5LiteReducedPrecisionTest& operator=(const H5LiteReducedPrecisionTest&) = delete; // Copy Assignment Not Implemented
+  H5LiteReducedPrecisionTest& operator=(H5LiteReducedPrecisionTest&&) = delete;      // Move Assignment Not Implemented
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  void RemoveTestFiles()
+  {
+#if REMOVE_TEST_FILES
+    std::remove(UnitTest::H5LiteReducedPrecisionTest::FileName.c_str());
+#endif
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  void TestConversions()
+  {
+    H5SUPPORT_REQUIRE_EQUAL(H5Lite::floatToHalf(1.0f), 0x3C00)
+    H5SUPPORT_REQUIRE_EQUAL(H5Lite::floatToHalf(-2.0f), 0xC000)
+    H5SUPPORT_REQUIRE_EQUAL(H5Lite::floatToHalf(65504.0f), 0x7BFF)
+    H5SUPPORT_REQUIRE_EQUAL(H5Lite::floatToHalf(65519.0f), 0x7BFF)
+    H5SUPPORT_REQUIRE_EQUAL(H5Lite::floatToHalf(65520.0f), 0x7C00)
+    H5SUPPORT_REQUIRE_EQUAL(H5Lite::floatToHalf(-std::numeric_limits<float>::infinity()), 0xFC00)
+    H5SUPPORT_REQUIRE_EQUAL(H5Lite::floatToHalf(std::ldexp(1.0f, -24)), 0x0001)
+    H5SUPPORT_REQUIRE_EQUAL(H5Lite::floatToHalf(std::ldexp(1.0f, -26)), 0x0000)
+    H5SUPPORT_REQUIRE(std::isnan(H5Lite::halfToFloat(H5Lite::floatToHalf(std::numeric_limits<float>::quiet_NaN()))));
+    // 1 + 2^-11 is a tie between 1 and the next half and rounds to the even one
+    H5SUPPORT_REQUIRE_EQUAL(H5Lite::floatToHalf(1.0f + std::ldexp(1.0f, -11)), 0x3C00)
+    H5SUPPORT_REQUIRE_EQUAL(H5Lite::floatToHalf(1.0f + 3.0f * std::ldexp(1.0f, -11)), 0x3C02)
+
+    // Every half widens exactly and narrows back to itself
+    bool roundTrip = true;
+    for(uint32_t half = 0; half < 0x10000 && roundTrip; ++half)
+    {
+      float value = H5Lite::halfToFloat(static_cast<uint16_t>(half));
+      roundTrip = std::isnan(value) ? ((half & 0x7C00) == 0x7C00) : (H5Lite::floatToHalf(value) == half);
+    }
+    H5SUPPORT_REQUIRE(roundTrip);
+
+    H5SUPPORT_REQUIRE_EQUAL(H5Lite::floatToBFloat16(1.0f), 0x3F80)
+    H5SUPPORT_REQUIRE_EQUAL(H5Lite::bfloat16ToFloat(0xC000), -2.0f)
+    H5SUPPORT_REQUIRE_EQUAL(H5Lite::floatToBFloat16(H5Lite::bitsFloat(0x3F808000)), 0x3F80)
+    H5SUPPORT_REQUIRE_EQUAL(H5Lite::floatToBFloat16(H5Lite::bitsFloat(0x3F818000)), 0x3F82)
+    H5SUPPORT_REQUIRE(std::isnan(H5Lite::bfloat16ToFloat(H5Lite::floatToBFloat16(std::numeric_limits<float>::quiet_NaN()))));
+
+    // HDF5 must read our 16 bit types the same way the kernels do
+    for(H5StoragePrecision precision : {H5StoragePrecision::Float16, H5StoragePrecision::BFloat16})
+    {
+      hid_t typeID = H5Lite::createStoragePrecisionType(precision);
+      H5SUPPORT_REQUIRE(typeID >= 0);
+      H5SUPPORT_REQUIRE(H5Lite::getStoragePrecision(typeID) == precision);
+      std::vector<float> converted(0x10000);
+      std::vector<uint16_t> bits(0x10000);
+      for(uint32_t i = 0; i < 0x10000; ++i)
+      {
+        bits[i] = static_cast<uint16_t>(i);
+      }
+      // H5Tconvert widens in place from a packed source at the start of the buffer
+      std::memcpy(converted.data(), bits.data(), bits.size() * sizeof(uint16_t));
+      herr_t error = H5Tconvert(typeID, H5T_NATIVE_FLOAT, converted.size(), converted.data(), nullptr, H5P_DEFAULT);
+      H5SUPPORT_REQUIRE(error >= 0);
+      std::vector<float> widened(bits.size());
+      H5SUPPORT_REQUIRE(H5Lite::widenValues(bits.data(), bits.size() * sizeof(uint16_t), bits.size(), precision, widened.data()));
+      bool same = true;
+      for(size_t i = 0; i < bits.size() && same; ++i)
+      {
+        same = std::isnan(widened[i]) ? std::isnan(converted[i]) : (widened[i] == converted[i]);
+      }
+      H5SUPPORT_REQUIRE(same);
+      // Two byte values are too small a source for Float32
+      H5SUPPORT_REQUIRE(!H5Lite::widenValues(bits.data(), bits.size() * sizeof(uint16_t), bits.size(), H5StoragePrecision::Float32, widened.data()));
+      H5Tclose(typeID);
+    }
+    H5SUPPORT_REQUIRE(H5Lite::getStoragePrecision(H5T_NATIVE_DOUBLE) == H5StoragePrecision::Native);
+    H5SUPPORT_REQUIRE(H5Lite::getStoragePrecision(H5T_NATIVE_INT16) == H5StoragePrecision::Native);
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  void TestReadWrite()
+  {
+    hid_t fileID = H5Utilities::createFile(UnitTest::H5LiteReducedPrecisionTest::FileName);
+    H5SUPPORT_REQUIRE(fileID > 0);
+
+    std::vector<double> values(50 * 40);
+    for(size_t i = 0; i < values.size(); ++i)
+    {
+      values[i] = std::sin(static_cast<double>(i) * 0.01) * 1000.0;
+    }
+    std::vector<hsize_t> dims = {50, 40};
+    struct Mode
+    {
+      const char* name;
+      H5StoragePrecision precision;
+      size_t typeSize;
+      double maxRelativeError;
+    };
+    const Mode modes[] = {{"Native", H5StoragePrecision::Native, 8, 0.0},
+                          {"Float32", H5StoragePrecision::Float32, 4, std::ldexp(1.0, -24)},
+                          {"Float16", H5StoragePrecision::Float16, 2, std::ldexp(1.0, -11)},
+                          {"BFloat16", H5StoragePrecision::BFloat16, 2, std::ldexp(1.0, -8)}};
+    for(const Mode& mode : modes)
+    {
+      herr_t error = H5Lite::writeVectorDataset(fileID, mode.name, dims, values, mode.precision);
+      H5SUPPORT_REQUIRE(error >= 0);
+
+      std::vector<hsize_t> fileDims;
+      H5T_class_t classType = H5T_NO_CLASS;
+      size_t typeSize = 0;
+      error = H5Lite::getDatasetInfo(fileID, mode.name, fileDims, classType, typeSize);
+      H5SUPPORT_REQUIRE(error >= 0);
+      H5SUPPORT_REQUIRE(fileDims == dims);
+      H5SUPPORT_REQUIRE_EQUAL(classType, H5T_FLOAT)
+      H5SUPPORT_REQUIRE_EQUAL(typeSize, mode.typeSize)
+
+      std::vector<double> widened;
+      error = H5Lite::readVectorDatasetWidened(fileID, mode.name, widened);
+      H5SUPPORT_REQUIRE(error >= 0);
+      H5SUPPORT_REQUIRE_EQUAL(widened.size(), values.size())
+      double maxError = 0.0;
+      for(size_t i = 0; i < values.size(); ++i)
+      {
+        if(values[i] != 0.0)
+        {
+          maxError = std::max(maxError, std::fabs(widened[i] - values[i]) / std::fabs(values[i]));
+        }
+      }
+      H5SUPPORT_REQUIRE(maxError <= mode.maxRelativeError);
+
+      // Plain reads go through the HDF5 conversion and agree with the kernels
+      std::vector<float> converted;
+      error = H5Lite::readVectorDataset(fileID, mode.name, converted);
+      H5SUPPORT_REQUIRE(error >= 0);
+      std::vector<float> widenedFloats;
+      error = H5Lite::readVectorDatasetWidened(fileID, mode.name, widenedFloats);
+      H5SUPPORT_REQUIRE(error >= 0);
+      if(mode.precision != H5StoragePrecision::Native)
+      {
+        H5SUPPORT_REQUIRE(converted == widenedFloats);
+      }
+    }
+
+    HDF_ERROR_HANDLER_OFF
+    std::vector<double> missing;
+    herr_t error = H5Lite::readVectorDatasetWidened(fileID, "DoesNotExist", missing);
+    H5SUPPORT_REQUIRE(error < 0);
+    HDF_ERROR_HANDLER_ON
+
+    error = H5Utilities::closeFile(fileID);
+    H5SUPPORT_REQUIRE(error >= 0);
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  void operator()()
+  {
+    H5SUPPORT_REGISTER_TEST(TestConversions())
+    H5SUPPORT_REGISTER_TEST(TestReadWrite())
+    H5SUPPORT_REGISTER_TEST(RemoveTestFiles())
+  }
+};
@@ -0,0 +1,252 @@
+/* ============================================================================
+ * Copyright (c) 2007-2019 BlueQuartz Software, LLC
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+ * contributors may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The code contained herein was partially funded by the followig contracts:
+ *    United States Air Force Prime Contract FA8650-04-C-5229
+ *    United States Air Force Prime Contract FA8650-15-D-5231
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "H5Support/H5Lite.h"
+#include "H5Support/H5LiteStrings.h"
+#include "H5Support/H5Utilities.h"
+
+#include "UnitTestSupport.h"
+
+#include "H5SupportTestFileLocations.h"
+
+#if defined(H5Support_NAMESPACE)
+using namespace H5Support_NAMESPACE;
+#endif
+
+class H5LiteStringsTest
+{
+public:
+  H5LiteStringsTest() = default;
+  ~H5LiteStringsTest() = default;
+
+  H5LiteStringsTest(const H5LiteStringsTest&) = delete;            // Copy Constructor Not Implemented
+  H5LiteStringsTest(H5LiteStringsTest&&) = delete;                 // Move Constructor Not Implemented
+  H5LiteStringsTest& operator=(const H5LiteStringsTest&) = delete; // Copy Assignment Not Implemented
+  H5LiteStringsTest& operator=(H5LiteStringsTest&&) = delete;      // Move Assignment Not Implemented
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  void RemoveTestFiles()
+  {
+#if REMOVE_TEST_FILES
+    std::remove(UnitTest::H5LiteStringsTest::FileName.c_str());
+#endif
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  void TestStringArena()
+  {
+    hid_t fileID = H5Utilities::createFile(UnitTest::H5LiteStringsTest::FileName);
+    H5SUPPORT_REQUIRE(fileID > 0);
+
+    std::vector<std::string> strings(1000);
+    for(size_t i = 0; i < strings.size(); ++i)
+    {
+      strings[i] = std::string(i % 37, static_cast<char>('a' + i % 26)) + std::to_string(i);
+    }
+    strings[3] = "";
+    herr_t error = H5Lite::writeVectorOfStringsDataset(fileID, "VlenStrings", strings);
+    H5SUPPORT_REQUIRE(error >= 0);
+    // Strings longer than k_StringArenaBytesPerString overflow the first arena block
+    std::vector<std::string> longStrings(100);
+    for(size_t i = 0; i < longStrings.size(); ++i)
+    {
+      longStrings[i] = std::string(200 + i, static_cast<char>('A' + i % 26));
+    }
+    error = H5Lite::writeVectorOfStringsDataset(fileID, "LongStrings", longStrings);
+    H5SUPPORT_REQUIRE(error >= 0);
+    error = H5Lite::writeStringDataset(fileID, "FixedString", std::string("Fixed length"));
+    H5SUPPORT_REQUIRE(error >= 0);
+    error = H5Lite::writeVectorOfStringsDataset(fileID, "Empty", std::vector<std::string>());
+    H5SUPPORT_REQUIRE(error >= 0);
+    error = H5Lite::writeScalarDataset(fileID, "Number", 1.0f);
+    H5SUPPORT_REQUIRE(error >= 0);
+
+    // Null pointers in a variable length dataset read back as empty strings
+    {
+      hsize_t dims = 3;
+      const char* values[3] = {"first", nullptr, "third"};
+      hid_t typeID = H5Tcopy(H5T_C_S1);
+      H5Tset_size(typeID, H5T_VARIABLE);
+      hid_t dataspaceID = H5Screate_simple(1, &dims, nullptr);
+      hid_t datasetID = H5Dcreate(fileID, "WithNull", typeID, dataspaceID, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+      H5SUPPORT_REQUIRE(H5Dwrite(datasetID, typeID, H5S_ALL, H5S_ALL, H5P_DEFAULT, values) >= 0);
+      H5Dclose(datasetID);
+      H5Sclose(dataspaceID);
+      H5Tclose(typeID);
+    }
+
+    H5StringArena arena;
+    error = H5Lite::readStringArenaDataset(fileID, "VlenStrings", arena);
+    H5SUPPORT_REQUIRE(error >= 0);
+    H5SUPPORT_REQUIRE_EQUAL(arena.size(), strings.size())
+    H5SUPPORT_REQUIRE_EQUAL(arena.offsets.size(), strings.size() + 1)
+    H5SUPPORT_REQUIRE_EQUAL(arena.chars.size(), arena.offsets.back())
+    for(size_t i = 0; i < strings.size(); ++i)
+    {
+      H5SUPPORT_REQUIRE_EQUAL(arena.length(i), strings[i].size())
+      H5SUPPORT_REQUIRE_EQUAL(arena.str(i), strings[i])
+      H5SUPPORT_REQUIRE(std::string(arena.c_str(i)) == strings[i]);
+    }
+
+    // A mostly unused first block is not kept
+    error = H5Lite::writeVectorOfStringsDataset(fileID, "ShortStrings", std::vector<std::string>(1000, "x"));
+    H5SUPPORT_REQUIRE(error >= 0);
+    error = H5Lite::readStringArenaDataset(fileID, "ShortStrings", arena);
+    H5SUPPORT_REQUIRE(error >= 0);
+    H5SUPPORT_REQUIRE_EQUAL(arena.size(), 1000)
+    H5SUPPORT_REQUIRE_EQUAL(arena.str(999), "x")
+    H5SUPPORT_REQUIRE(arena.chars.capacity() / 2 <= arena.chars.size());
+
+    error = H5Lite::readStringArenaDataset(fileID, "LongStrings", arena);
+    H5SUPPORT_REQUIRE(error >= 0);
+    H5SUPPORT_REQUIRE_EQUAL(arena.size(), longStrings.size())
+    H5SUPPORT_REQUIRE_EQUAL(arena.chars.size(), arena.offsets.back())
+    for(size_t i = 0; i < longStrings.size(); ++i)
+    {
+      H5SUPPORT_REQUIRE_EQUAL(arena.str(i), longStrings[i])
+      H5SUPPORT_REQUIRE(std::string(arena.c_str(i)) == longStrings[i]);
+    }
+
+    error = H5Lite::readStringArenaDataset(fileID, "FixedString", arena);
+    H5SUPPORT_REQUIRE(error >= 0);
+    H5SUPPORT_REQUIRE_EQUAL(arena.size(), 1)
+    H5SUPPORT_REQUIRE_EQUAL(arena.str(0), "Fixed length")
+
+    error = H5Lite::readStringArenaDataset(fileID, "WithNull", arena);
+    H5SUPPORT_REQUIRE(error >= 0);
+    H5SUPPORT_REQUIRE_EQUAL(arena.size(), 3)
+    H5SUPPORT_REQUIRE_EQUAL(arena.str(0), "first")
+    H5SUPPORT_REQUIRE_EQUAL(arena.length(1), 0)
+    H5SUPPORT_REQUIRE_EQUAL(arena.str(2), "third")
+
+    error = H5Lite::readStringArenaDataset(fileID, "Empty", arena);
+    H5SUPPORT_REQUIRE(error >= 0);
+    H5SUPPORT_REQUIRE(arena.empty());
+
+    HDF_ERROR_HANDLER_OFF
+    error = H5Lite::readStringArenaDataset(fileID, "Number", arena);
+    H5SUPPORT_REQUIRE(error < 0);
+    error = H5Lite::readStringArenaDataset(fileID, "DoesNotExist", arena);
+    H5SUPPORT_REQUIRE(error < 0);
+    HDF_ERROR_HANDLER_ON
+
+    error = H5Utilities::closeFile(fileID);
+    H5SUPPORT_REQUIRE(error >= 0);
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  void TestFixedLengthStrings()
+  {
+    hid_t fileID = H5Utilities::openFile(UnitTest::H5LiteStringsTest::FileName, false);
+    H5SUPPORT_REQUIRE(fileID > 0);
+
+    std::vector<std::string> strings(5000);
+    for(size_t i = 0; i < strings.size(); ++i)
+    {
+      strings[i] = "Element " + std::to_string(i % 100);
+    }
+    strings[7] = "";
+    strings[9] = "The longest string of the set";
+    herr_t error = H5Lite::writeFixedLengthStringsDataset(fileID, "Fixed", strings);
+    H5SUPPORT_REQUIRE(error >= 0);
+#ifdef H5_HAVE_FILTER_DEFLATE
+    error = H5Lite::writeFixedLengthStringsDataset(fileID, "FixedCompressed", strings, 0, 6);
+    H5SUPPORT_REQUIRE(error >= 0);
+    // The characters live in the chunks, so the repeated strings compress well
+    hid_t datasetID = H5Dopen(fileID, "FixedCompressed", H5P_DEFAULT);
+    H5SUPPORT_REQUIRE(H5Dget_storage_size(datasetID) < strings.size() * strings[9].size() / 4);
+    H5Dclose(datasetID);
+#endif
+    error = H5Lite::writeFixedLengthStringsDataset(fileID, "FixedEmpty", std::vector<std::string>(), 8, 6);
+    H5SUPPORT_REQUIRE(error >= 0);
+
+    for(const std::string& name : {std::string("Fixed"), std::string("FixedCompressed")})
+    {
+      if(!H5Lite::datasetExists(fileID, name))
+      {
+        continue;
+      }
+      H5FixedStringBuffer buffer;
+      error = H5Lite::readFixedLengthStringsDataset(fileID, name, buffer);
+      H5SUPPORT_REQUIRE(error >= 0);
+      H5SUPPORT_REQUIRE_EQUAL(buffer.width, strings[9].size())
+      H5SUPPORT_REQUIRE_EQUAL(buffer.size(), strings.size())
+      for(size_t i = 0; i < strings.size(); ++i)
+      {
+        H5SUPPORT_REQUIRE_EQUAL(buffer.str(i), strings[i])
+      }
+
+      // The other string readers understand the same layout
+      H5StringArena arena;
+      error = H5Lite::readStringArenaDataset(fileID, name, arena);
+      H5SUPPORT_REQUIRE(error >= 0);
+      H5SUPPORT_REQUIRE_EQUAL(arena.str(9), strings[9])
+      H5SUPPORT_REQUIRE_EQUAL(arena.length(7), 0)
+    }
+
+    H5FixedStringBuffer buffer;
+    error = H5Lite::readFixedLengthStringsDataset(fileID, "FixedEmpty", buffer);
+    H5SUPPORT_REQUIRE(error >= 0);
+    H5SUPPORT_REQUIRE(buffer.empty());
+
+    HDF_ERROR_HANDLER_OFF
+    error = H5Lite::readFixedLengthStringsDataset(fileID, "VlenStrings", buffer);
+    H5SUPPORT_REQUIRE_EQUAL(error, -2)
+    HDF_ERROR_HANDLER_ON
+
+    error = H5Utilities::closeFile(fileID);
+    H5SUPPORT_REQUIRE(error >= 0);
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  void operator()()
+  {
+    H5SUPPORT_REGISTER_TEST(TestStringArena())
+    H5SUPPORT_REGISTER_TEST(TestFixedLengthStrings())
+    H5SUPPORT_REGISTER_TEST(RemoveTestFiles())
+  }
+};
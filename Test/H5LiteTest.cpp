@@ -32,11 +32,16 @@
  *
  * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
 
+#include <algorithm>
+#include <array>
 #include <cstdio>
 #include <iostream>
 #include <map>
+#include <memory>
 #include <string>
 
+#include "H5Support/H5DatasetHandle.h"
+#include "H5Support/H5DefaultInitAllocator.h"
 #include "H5Support/H5Lite.h"
 #include "H5Support/H5Utilities.h"
 
@@ -77,6 +82,12 @@
  * getDatasetType
  * getDatasetInfo - DONE
  * getAttributeInfo - DONE
+ * writePointerDatasetSlab - DONE
+ * writeVectorDatasetSlab - DONE
+ * readPointerDatasetSlab - DONE
+ * readVectorDatasetSlab - DONE
+ * readPointerDataset (checked size) - DONE
+ * readUniquePtrDataset - DONE
  */
 
 #if defined(H5Support_NAMESPACE)
@@ -103,6 +114,9 @@ public:
     std::remove(UnitTest::H5LiteTest::FileName.c_str());
     std::remove(UnitTest::H5LiteTest::LargeFile.c_str());
     std::remove(UnitTest::H5LiteTest::VLengthFile.c_str());
+    std::remove(UnitTest::H5LiteTest::SlabFile.c_str());
+    std::remove(UnitTest::H5LiteTest::FilterFile.c_str());
+    std::remove(UnitTest::H5LiteTest::FilterLatestFile.c_str());
 #endif
   }
 
@@ -872,6 +886,15 @@ public:
     H5SUPPORT_REQUIRE_EQUAL(_testTypeName<signed char>(), H5T_NATIVE_INT8)
     H5SUPPORT_REQUIRE_EQUAL(_testTypeName<unsigned char>(), H5T_NATIVE_UINT8)
     H5SUPPORT_REQUIRE_EQUAL(_testTypeName<uint8_t>(), H5T_NATIVE_UINT8)
+
+    // The mapping is resolved at compile time by size and signedness
+    static_assert(H5TypeTraits<int32_t>::k_Supported && H5TypeTraits<double>::k_Supported, "Primitive types must be supported");
+    static_assert(!H5TypeTraits<std::string>::k_Supported && !H5TypeTraits<long double>::k_Supported, "Only types with an HDF5 mapping are supported");
+    H5SUPPORT_REQUIRE_EQUAL(_testTypeName<long>(), (sizeof(long) == 8 ? H5T_NATIVE_INT64 : H5T_NATIVE_INT32))
+    H5SUPPORT_REQUIRE_EQUAL(_testTypeName<unsigned long long>(), H5T_NATIVE_UINT64)
+    H5SUPPORT_REQUIRE_EQUAL(_testTypeName<bool>(), H5T_NATIVE_UINT8)
+    H5SUPPORT_REQUIRE_EQUAL(std::string(H5TypeTraits<uint16_t>::name()), "H5T_NATIVE_UINT16")
+    H5SUPPORT_REQUIRE_EQUAL(H5Lite::HDFTypeForPrimitiveAsStr(1.0f), "H5T_NATIVE_FLOAT")
   }
 
   class WriteString
@@ -983,8 +1006,324 @@ public:
 
       H5Utilities::closeFile(fileID);
     }
+
+    // Large tables written in one call, chunked and compressed
+    {
+      hid_t fileID = H5Utilities::createFile(UnitTest::H5LiteTest::VLengthFile);
+
+      std::vector<std::string> strings(10000);
+      for(size_t i = 0; i < strings.size(); ++i)
+      {
+        strings[i] = "String " + std::to_string(i * 7919);
+      }
+      strings[5] = "";
+      herr_t error = H5Lite::writeVectorOfStringsDataset(fileID, "Chunked", strings, 1024);
+      H5SUPPORT_REQUIRE(error >= 0)
+#ifdef H5_HAVE_FILTER_DEFLATE
+      error = H5Lite::writeVectorOfStringsDataset(fileID, "Compressed", strings, 0, 6);
+      H5SUPPORT_REQUIRE(error >= 0)
+#endif
+      error = H5Lite::writeVectorOfStringsDataset(fileID, "Empty", std::vector<std::string>(), 16, 6);
+      H5SUPPORT_REQUIRE(error >= 0)
+
+      for(const std::string& name : {std::string("Chunked"), std::string("Compressed")})
+      {
+        if(!H5Lite::datasetExists(fileID, name))
+        {
+          continue;
+        }
+        std::vector<std::string> data;
+        error = H5Lite::readVectorOfStringDataset(fileID, name, data);
+        H5SUPPORT_REQUIRE(error >= 0)
+        H5SUPPORT_REQUIRE(data == strings)
+      }
+      H5DatasetHandle chunked = H5DatasetHandle::open(fileID, "Chunked");
+      H5SUPPORT_REQUIRE_EQUAL(chunked.getLayout(), H5D_CHUNKED)
+      H5SUPPORT_REQUIRE((chunked.getChunkDimensions() == std::vector<hsize_t>{1024}));
+      chunked.close();
+
+      std::vector<std::string> data;
+      error = H5Lite::readVectorOfStringDataset(fileID, "Empty", data);
+      H5SUPPORT_REQUIRE(data.empty())
+
+      H5Utilities::closeFile(fileID);
+    }
   }
 
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  void TestSlabReadWrite()
+  {
+    hid_t fileID = H5Utilities::createFile(UnitTest::H5LiteTest::SlabFile);
+    H5SUPPORT_REQUIRE(fileID > 0);
+
+    // A 4 x 6 x 8 volume where every value encodes its own (z, y, x) index
+    const std::vector<hsize_t> dims = {4, 6, 8};
+    std::vector<int32_t> volume(4 * 6 * 8);
+    for(size_t i = 0; i < volume.size(); ++i)
+    {
+      volume[i] = static_cast<int32_t>(i);
+    }
+    herr_t error = H5Lite::writeVectorDataset(fileID, "Volume", dims, volume);
+    H5SUPPORT_REQUIRE(error >= 0);
+
+    // One full z slice
+    std::vector<int32_t> slice;
+    error = H5Lite::readVectorDatasetSlab(fileID, "Volume", {2, 0, 0}, {1, 6, 8}, slice);
+    H5SUPPORT_REQUIRE(error >= 0);
+    H5SUPPORT_REQUIRE_EQUAL(slice.size(), 6 * 8)
+    for(size_t i = 0; i < slice.size(); ++i)
+    {
+      H5SUPPORT_REQUIRE_EQUAL(slice[i], volume[2 * 6 * 8 + i])
+    }
+
+    // Every other y row, two 1 x 1 x 3 blocks per row spaced 4 apart in x
+    std::vector<int32_t> blocks;
+    error = H5Lite::readVectorDatasetSlab(fileID, "Volume", {1, 1, 0}, {1, 3, 2}, blocks, {1, 2, 4}, {1, 1, 3});
+    H5SUPPORT_REQUIRE(error >= 0);
+    H5SUPPORT_REQUIRE_EQUAL(blocks.size(), 3 * 6)
+    size_t index = 0;
+    for(hsize_t y = 1; y < 6; y += 2)
+    {
+      for(hsize_t x : {0, 1, 2, 4, 5, 6})
+      {
+        H5SUPPORT_REQUIRE_EQUAL(blocks[index], volume[1 * 6 * 8 + y * 8 + x])
+        index++;
+      }
+    }
+
+    // Overwrite a 2 x 2 x 2 corner and read it back through the pointer API
+    std::vector<int32_t> corner(8, -1);
+    error = H5Lite::writeVectorDatasetSlab(fileID, "Volume", {2, 4, 6}, {2, 2, 2}, corner);
+    H5SUPPORT_REQUIRE(error >= 0);
+    std::array<hsize_t, 3> offset = {2, 4, 6};
+    std::array<hsize_t, 3> count = {2, 2, 2};
+    std::array<int32_t, 8> cornerReadBack = {};
+    error = H5Lite::readPointerDatasetSlab(fileID, "Volume", 3, offset.data(), count.data(), nullptr, nullptr, cornerReadBack.data());
+    H5SUPPORT_REQUIRE(error >= 0);
+    for(int32_t value : cornerReadBack)
+    {
+      H5SUPPORT_REQUIRE_EQUAL(value, -1)
+    }
+    std::vector<int32_t> updated;
+    error = H5Lite::readVectorDataset(fileID, "Volume", updated);
+    H5SUPPORT_REQUIRE(error >= 0);
+    H5SUPPORT_REQUIRE_EQUAL(updated[2 * 6 * 8 + 4 * 8 + 5], volume[2 * 6 * 8 + 4 * 8 + 5])
+    H5SUPPORT_REQUIRE_EQUAL(updated[3 * 6 * 8 + 5 * 8 + 7], -1)
+
+    // Slabs that do not fit, have the wrong rank or do not match the buffer are rejected
+    error = H5Lite::readVectorDatasetSlab(fileID, "Volume", {3, 0, 0}, {2, 6, 8}, slice);
+    H5SUPPORT_REQUIRE(error < 0);
+    error = H5Lite::readVectorDatasetSlab(fileID, "Volume", {0, 0}, {1, 1}, slice);
+    H5SUPPORT_REQUIRE(error < 0);
+    error = H5Lite::writeVectorDatasetSlab(fileID, "Volume", {0, 0, 0}, {1, 1, 2}, corner);
+    H5SUPPORT_REQUIRE(error < 0);
+
+    error = H5Utilities::closeFile(fileID);
+    H5SUPPORT_REQUIRE(error >= 0);
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  void TestUninitializedReads()
+  {
+    hid_t fileID = H5Utilities::openFile(UnitTest::H5LiteTest::SlabFile, false);
+    H5SUPPORT_REQUIRE(fileID > 0);
+
+    std::vector<double> values(1000);
+    for(size_t i = 0; i < values.size(); ++i)
+    {
+      values[i] = static_cast<double>(i) * 1.5;
+    }
+    herr_t error = H5Lite::writeVectorDataset(fileID, "Values", {10, 100}, values);
+    H5SUPPORT_REQUIRE(error >= 0);
+
+    // Caller owned storage with a size query
+    hsize_t numElements = H5Lite::getNumberOfElements(fileID, "Values");
+    H5SUPPORT_REQUIRE_EQUAL(numElements, values.size())
+    std::vector<double> storage(numElements + 1, -1.0);
+    error = H5Lite::readPointerDataset(fileID, "Values", storage.data(), numElements + 1);
+    H5SUPPORT_REQUIRE(error >= 0);
+    H5SUPPORT_REQUIRE(std::equal(values.cbegin(), values.cend(), storage.cbegin()));
+    H5SUPPORT_REQUIRE_EQUAL(storage.back(), -1.0)
+    error = H5Lite::readPointerDataset(fileID, "Values", storage.data(), numElements - 1);
+    H5SUPPORT_REQUIRE_EQUAL(error, -4)
+
+    // std::unique_ptr<T[]> allocated without value initialization
+    std::unique_ptr<double[]> array;
+    hsize_t arraySize = 0;
+    error = H5Lite::readUniquePtrDataset(fileID, "Values", array, arraySize);
+    H5SUPPORT_REQUIRE(error >= 0);
+    H5SUPPORT_REQUIRE_EQUAL(arraySize, values.size())
+    H5SUPPORT_REQUIRE(std::equal(values.cbegin(), values.cend(), array.get()));
+
+    // Vector with a default initializing allocator, also through the slab reader
+    UninitializedVector<double> uninitialized;
+    error = H5Lite::readVectorDataset(fileID, "Values", uninitialized);
+    H5SUPPORT_REQUIRE(error >= 0);
+    H5SUPPORT_REQUIRE(std::equal(values.cbegin(), values.cend(), uninitialized.cbegin(), uninitialized.cend()));
+    error = H5Lite::readVectorDatasetSlab(fileID, "Values", {9, 0}, {1, 100}, uninitialized);
+    H5SUPPORT_REQUIRE(error >= 0);
+    H5SUPPORT_REQUIRE(std::equal(values.cbegin() + 900, values.cend(), uninitialized.cbegin(), uninitialized.cend()));
+    error = H5Lite::writeVectorAttribute(fileID, "Values", "Origin", {3}, std::vector<double>{0.5, 1.5, 2.5});
+    H5SUPPORT_REQUIRE(error >= 0);
+    error = H5Lite::readVectorAttribute(fileID, "Values", "Origin", uninitialized);
+    H5SUPPORT_REQUIRE(error >= 0);
+    H5SUPPORT_REQUIRE((uninitialized == UninitializedVector<double>{0.5, 1.5, 2.5}));
+
+    // Explicit construction still value initializes
+    UninitializedVector<int32_t> filled(4, 7);
+    H5SUPPORT_REQUIRE_EQUAL(filled[3], 7)
+
+    HDF_ERROR_HANDLER_OFF
+    error = H5Lite::readUniquePtrDataset(fileID, "DoesNotExist", array, arraySize);
+    HDF_ERROR_HANDLER_ON
+    H5SUPPORT_REQUIRE(error < 0);
+    H5SUPPORT_REQUIRE(array == nullptr);
+    H5SUPPORT_REQUIRE_EQUAL(arraySize, 0)
+
+    error = H5Utilities::closeFile(fileID);
+    H5SUPPORT_REQUIRE(error >= 0);
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  hsize_t getStorageSize(hid_t fileID, const std::string& datasetName)
+  {
+    hid_t datasetID = H5Dopen(fileID, datasetName.c_str(), H5P_DEFAULT);
+    hsize_t size = H5Dget_storage_size(datasetID);
+    H5Dclose(datasetID);
+    return size;
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  void TestFilterPipeline()
+  {
+    hid_t fileID = H5Utilities::createFile(UnitTest::H5LiteTest::FilterFile);
+    H5SUPPORT_REQUIRE(fileID > 0);
+
+    // A label volume: small integers in runs, the case byte shuffle helps most
+    const std::vector<hsize_t> dims = {32, 32, 32};
+    const std::vector<hsize_t> cDims = {16, 16, 16};
+    std::vector<int32_t> labels(32 * 32 * 32);
+    for(size_t i = 0; i < labels.size(); ++i)
+    {
+      labels[i] = static_cast<int32_t>((i / 7) % 1000);
+    }
+    std::vector<int32_t> readBack;
+
+    H5FilterPipeline shuffled = H5FilterPipeline::Deflate(6);
+    shuffled.shuffle = true;
+    shuffled.fletcher32 = true;
+    herr_t error = H5Lite::writeVectorDatasetCompressed(fileID, "Shuffled", dims, labels, cDims, shuffled);
+    H5SUPPORT_REQUIRE(error >= 0);
+    H5SUPPORT_REQUIRE(H5Lite::readVectorDataset(fileID, "Shuffled", readBack) >= 0);
+    H5SUPPORT_REQUIRE(readBack == labels);
+    {
+      H5DatasetHandle handle = H5DatasetHandle::open(fileID, "Shuffled");
+      H5SUPPORT_REQUIRE((handle.getFilters() == std::vector<H5Z_filter_t>{H5Z_FILTER_SHUFFLE, H5Z_FILTER_DEFLATE, H5Z_FILTER_FLETCHER32}));
+    }
+
+    // 11 significant bits, counting the sign bit, hold every label
+    H5FilterPipeline nbit;
+    nbit.nbitPrecision = 11;
+    error = H5Lite::writeVectorDatasetCompressed(fileID, "NBit", dims, labels, cDims, nbit);
+    H5SUPPORT_REQUIRE(error >= 0);
+    H5SUPPORT_REQUIRE(H5Lite::readVectorDataset(fileID, "NBit", readBack) >= 0);
+    H5SUPPORT_REQUIRE(readBack == labels);
+    H5SUPPORT_REQUIRE(getStorageSize(fileID, "NBit") < labels.size() * 2);
+
+    H5FilterPipeline scaleOffset = H5FilterPipeline::Deflate(1);
+    scaleOffset.scaleOffset = true;
+    error = H5Lite::writeVectorDatasetCompressed(fileID, "ScaleOffset", dims, labels, cDims, scaleOffset);
+    H5SUPPORT_REQUIRE(error >= 0);
+    H5SUPPORT_REQUIRE(H5Lite::readVectorDataset(fileID, "ScaleOffset", readBack) >= 0);
+    H5SUPPORT_REQUIRE(readBack == labels);
+    H5SUPPORT_REQUIRE(getStorageSize(fileID, "ScaleOffset") < labels.size() * 2);
+
+    // Floats keep 2 decimal digits, within 10^-2 of the original
+    std::vector<float> noisy(labels.size());
+    for(size_t i = 0; i < noisy.size(); ++i)
+    {
+      noisy[i] = static_cast<float>(std::sin(static_cast<double>(i)) * 50.0);
+    }
+    scaleOffset.scaleFactor = 2;
+    error = H5Lite::writeVectorDatasetCompressed(fileID, "ScaleOffsetFloat", dims, noisy, cDims, scaleOffset);
+    H5SUPPORT_REQUIRE(error >= 0);
+    std::vector<float> noisyBack;
+    H5SUPPORT_REQUIRE(H5Lite::readVectorDataset(fileID, "ScaleOffsetFloat", noisyBack) >= 0);
+    H5SUPPORT_REQUIRE_EQUAL(noisyBack.size(), noisy.size())
+    float maxError = 0.0f;
+    for(size_t i = 0; i < noisy.size(); ++i)
+    {
+      maxError = std::max(maxError, std::fabs(noisyBack[i] - noisy[i]));
+    }
+    H5SUPPORT_REQUIRE(maxError < 0.01f);
+
+    HDF_ERROR_HANDLER_OFF
+    H5FilterPipeline both;
+    both.scaleOffset = true;
+    both.nbitPrecision = 8;
+    error = H5Lite::writeVectorDatasetCompressed(fileID, "Both", dims, labels, cDims, both);
+    H5SUPPORT_REQUIRE(error < 0);
+    error = H5Lite::writeVectorDatasetCompressed(fileID, "NBitFloat", dims, noisy, cDims, nbit);
+    H5SUPPORT_REQUIRE(error < 0);
+    HDF_ERROR_HANDLER_ON
+
+    error = H5Utilities::closeFile(fileID);
+    H5SUPPORT_REQUIRE(error >= 0);
+  }
+
+#if H5_VERSION_GE(1, 10, 2)
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  void TestPartialEdgeChunks()
+  {
+    // Edge chunks that are mostly padding can skip the filters, which a 1.8 format file can not record
+    H5FilterPipeline edges = H5FilterPipeline::Deflate(6);
+    edges.filterPartialEdgeChunks = false;
+    std::vector<int32_t> ramp(100);
+    std::iota(ramp.begin(), ramp.end(), 0);
+    std::vector<int32_t> readBack;
+    hid_t fileAccessPropertyList = H5Pcreate(H5P_FILE_ACCESS);
+    H5Pset_libver_bounds(fileAccessPropertyList, H5F_LIBVER_V18, H5F_LIBVER_V110);
+    hid_t latestFileID = H5Fcreate(UnitTest::H5LiteTest::FilterLatestFile.c_str(), H5F_ACC_TRUNC, H5P_DEFAULT, fileAccessPropertyList);
+    H5Pclose(fileAccessPropertyList);
+    H5SUPPORT_REQUIRE(latestFileID > 0);
+    herr_t error = H5Lite::writeVectorDatasetCompressed(latestFileID, "Edges", {100}, ramp, {64}, edges);
+    H5SUPPORT_REQUIRE(error >= 0);
+    H5SUPPORT_REQUIRE(H5Lite::readVectorDataset(latestFileID, "Edges", readBack) >= 0);
+    H5SUPPORT_REQUIRE(readBack == ramp);
+    {
+      hid_t datasetID = H5Dopen(latestFileID, "Edges", H5P_DEFAULT);
+      hid_t propertyListID = H5Dget_create_plist(datasetID);
+      unsigned options = 0;
+      H5SUPPORT_REQUIRE(H5Pget_chunk_opts(propertyListID, &options) >= 0);
+      H5SUPPORT_REQUIRE_EQUAL(options, H5D_CHUNK_DONT_FILTER_PARTIAL_CHUNKS)
+      H5Pclose(propertyListID);
+      H5Dclose(datasetID);
+    }
+    error = H5Utilities::closeFile(latestFileID);
+    H5SUPPORT_REQUIRE(error >= 0);
+
+    // The files H5Utilities creates stay readable by 1.8 and reject the option
+    hid_t fileID = H5Utilities::createFile(UnitTest::H5LiteTest::FilterLatestFile);
+    H5SUPPORT_REQUIRE(fileID > 0);
+    HDF_ERROR_HANDLER_OFF
+    error = H5Lite::writeVectorDatasetCompressed(fileID, "Edges", {100}, ramp, {64}, edges);
+    H5SUPPORT_REQUIRE(error < 0);
+    HDF_ERROR_HANDLER_ON
+    error = H5Utilities::closeFile(fileID);
+    H5SUPPORT_REQUIRE(error >= 0);
+  }
+#endif
+
   // -----------------------------------------------------------------------------
   //
   // -----------------------------------------------------------------------------
@@ -993,6 +1332,12 @@ public:
     H5SUPPORT_REGISTER_TEST(TestVLengStringReadWrite())
     H5SUPPORT_REGISTER_TEST(TestTypeDetection())
     H5SUPPORT_REGISTER_TEST(Test())
+    H5SUPPORT_REGISTER_TEST(TestSlabReadWrite())
+    H5SUPPORT_REGISTER_TEST(TestUninitializedReads())
+    H5SUPPORT_REGISTER_TEST(TestFilterPipeline())
+#if H5_VERSION_GE(1, 10, 2)
+    H5SUPPORT_REGISTER_TEST(TestPartialEdgeChunks())
+#endif
     H5SUPPORT_REGISTER_TEST(RemoveTestFiles())
   }
 };
@@ -0,0 +1,239 @@
+/* ============================================================================
+ * Copyright (c) 2007-2019 BlueQuartz Software, LLC
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+ * contributors may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The code contained herein was partially funded by the followig contracts:
+ *    United States Air Force Prime Contract FA8650-04-C-5229
+ *    United States Air Force Prime Contract FA8650-15-D-5231
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "H5Support/H5Lite.h"
+#include "H5Support/H5MemoryLayout.h"
+#include "H5Support/H5Utilities.h"
+
+#include "UnitTestSupport.h"
+
+#include "H5SupportTestFileLocations.h"
+
+#if defined(H5Support_NAMESPACE)
+using namespace H5Support_NAMESPACE;
+#endif
+
+class H5MemoryLayoutTest
+{
+public:
+  H5MemoryLayoutTest() = default;
+  ~H5MemoryLayoutTest() = default;
+
+  H5MemoryLayoutTest(const H5MemoryLayoutTest&) = delete;            // Copy Constructor Not Implemented
+  H5MemoryLayoutTest(H5MemoryLayoutTest&&) = delete;                 // Move Constructor Not Implemented
+  H5MemoryLayoutTest& operator=(const H5MemoryLayoutTest&) = delete; // Copy Assignment Not Implemented
+  H5MemoryLayoutTest& operator=(H5MemoryLayoutTest&&) = delete;      // Move Assignment Not Implemented
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  void RemoveTestFiles()
+  {
+#if REMOVE_TEST_FILES
+    std::remove(UnitTest::H5MemoryLayoutTest::FileName.c_str());
+#endif
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  void TestLayouts()
+  {
+    hsize_t dims[3] = {2, 3, 4};
+    H5MemoryLayout layout = H5MemoryLayout::RowMajor(3, dims);
+    H5SUPPORT_REQUIRE((layout.strides == std::vector<hsize_t>{12, 4, 1}));
+    H5SUPPORT_REQUIRE_EQUAL(layout.getRequiredElements(3, dims), 24)
+
+    layout = H5MemoryLayout::ColumnMajor(3, dims);
+    H5SUPPORT_REQUIRE((layout.strides == std::vector<hsize_t>{1, 2, 6}));
+    H5SUPPORT_REQUIRE_EQUAL(layout.getRequiredElements(3, dims), 24)
+
+    layout = H5MemoryLayout::Interleaved(3, dims, 3, 2);
+    H5SUPPORT_REQUIRE((layout.strides == std::vector<hsize_t>{36, 12, 3}));
+    H5SUPPORT_REQUIRE_EQUAL(layout.getRequiredElements(3, dims), 72)
+
+    // Nested strides become a hyperslab, anything else falls back to points
+    hid_t memSpaceID = -1;
+    H5SUPPORT_REQUIRE_EQUAL(H5Lite::createLayoutMemorySpace(3, dims, layout, memSpaceID), 0)
+    H5SUPPORT_REQUIRE(memSpaceID >= 0);
+    H5SUPPORT_REQUIRE_EQUAL(H5Sget_select_npoints(memSpaceID), 24)
+    H5Sclose(memSpaceID);
+    H5SUPPORT_REQUIRE_EQUAL(H5Lite::createLayoutMemorySpace(3, dims, H5MemoryLayout::ColumnMajor(3, dims), memSpaceID), 1)
+    H5SUPPORT_REQUIRE_EQUAL(memSpaceID, -1)
+    layout.strides = {1, 2};
+    H5SUPPORT_REQUIRE(H5Lite::createLayoutMemorySpace(3, dims, layout, memSpaceID) < 0);
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  void TestInterleaved()
+  {
+    hid_t fileID = H5Utilities::createFile(UnitTest::H5MemoryLayoutTest::FileName);
+    H5SUPPORT_REQUIRE(fileID > 0);
+
+    hsize_t numPoints = 1000;
+    std::vector<float> xyz(numPoints * 3);
+    for(size_t i = 0; i < xyz.size(); ++i)
+    {
+      xyz[i] = static_cast<float>(i);
+    }
+    const char* names[3] = {"X", "Y", "Z"};
+    for(hsize_t c = 0; c < 3; ++c)
+    {
+      H5MemoryLayout layout = H5MemoryLayout::Interleaved(1, &numPoints, 3, c);
+      herr_t error = H5Lite::writePointerDatasetWithLayout(fileID, names[c], 1, &numPoints, xyz.data(), layout);
+      H5SUPPORT_REQUIRE(error >= 0);
+    }
+    std::vector<float> y;
+    H5SUPPORT_REQUIRE(H5Lite::readVectorDataset(fileID, "Y", y) >= 0);
+    H5SUPPORT_REQUIRE_EQUAL(y.size(), numPoints)
+    H5SUPPORT_REQUIRE_EQUAL(y[0], 1.0f)
+    H5SUPPORT_REQUIRE_EQUAL(y[999], 2998.0f)
+
+    // Read the components back into an interleaved buffer
+    std::vector<float> readBack(numPoints * 3, -1.0f);
+    for(hsize_t c = 0; c < 3; ++c)
+    {
+      H5MemoryLayout layout = H5MemoryLayout::Interleaved(1, &numPoints, 3, c);
+      herr_t error = H5Lite::readPointerDatasetWithLayout(fileID, names[c], readBack.data(), layout);
+      H5SUPPORT_REQUIRE(error >= 0);
+    }
+    H5SUPPORT_REQUIRE(readBack == xyz);
+
+    // Only the addressed component is touched
+    std::vector<float> partial(numPoints * 3, -1.0f);
+    herr_t error = H5Lite::readPointerDatasetWithLayout(fileID, "Z", partial.data(), H5MemoryLayout::Interleaved(1, &numPoints, 3, 2));
+    H5SUPPORT_REQUIRE(error >= 0);
+    H5SUPPORT_REQUIRE_EQUAL(partial[0], -1.0f)
+    H5SUPPORT_REQUIRE_EQUAL(partial[2], 2.0f)
+    H5SUPPORT_REQUIRE_EQUAL(partial[3], -1.0f)
+
+    // A 3 x 4 window of a 10 x 10 image
+    std::vector<int32_t> image(100);
+    for(size_t i = 0; i < image.size(); ++i)
+    {
+      image[i] = static_cast<int32_t>(i);
+    }
+    hsize_t windowDims[2] = {3, 4};
+    H5MemoryLayout window;
+    window.strides = {10, 1};
+    window.offset = 22;
+    error = H5Lite::writePointerDatasetWithLayout(fileID, "Window", 2, windowDims, image.data(), window);
+    H5SUPPORT_REQUIRE(error >= 0);
+    std::vector<int32_t> windowData;
+    H5SUPPORT_REQUIRE(H5Lite::readVectorDataset(fileID, "Window", windowData) >= 0);
+    H5SUPPORT_REQUIRE((windowData == std::vector<int32_t>{22, 23, 24, 25, 32, 33, 34, 35, 42, 43, 44, 45}));
+
+    error = H5Utilities::closeFile(fileID);
+    H5SUPPORT_REQUIRE(error >= 0);
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  void TestColumnMajor()
+  {
+    hid_t fileID = H5Utilities::openFile(UnitTest::H5MemoryLayoutTest::FileName, false);
+    H5SUPPORT_REQUIRE(fileID > 0);
+
+    // Large enough to be moved in several point batches
+    std::vector<std::vector<hsize_t>> shapes = {{300, 300, 2}, {3, 70000}, {7}};
+    for(const auto& shape : shapes)
+    {
+      int32_t rank = static_cast<int32_t>(shape.size());
+      H5MemoryLayout layout = H5MemoryLayout::ColumnMajor(rank, shape.data());
+      hsize_t numElements = layout.getRequiredElements(rank, shape.data());
+      std::vector<int32_t> fortran(numElements);
+      for(size_t i = 0; i < fortran.size(); ++i)
+      {
+        fortran[i] = static_cast<int32_t>(i);
+      }
+      std::string name = "ColumnMajor" + std::to_string(rank);
+      herr_t error = H5Lite::writePointerDatasetWithLayout(fileID, name, rank, shape.data(), fortran.data(), layout);
+      H5SUPPORT_REQUIRE(error >= 0);
+
+      // The file holds the transpose in C order
+      std::vector<int32_t> data;
+      H5SUPPORT_REQUIRE(H5Lite::readVectorDataset(fileID, name, data) >= 0);
+      H5SUPPORT_REQUIRE_EQUAL(data.size(), numElements)
+      std::vector<hsize_t> rowStrides = H5MemoryLayout::RowMajor(rank, shape.data()).strides;
+      bool transposed = true;
+      for(hsize_t i = 0; i < numElements && transposed; ++i)
+      {
+        hsize_t fileIndex = 0;
+        hsize_t remainder = i;
+        for(int32_t d = 0; d < rank; ++d)
+        {
+          fileIndex += (remainder % shape[d]) * rowStrides[d];
+          remainder /= shape[d];
+        }
+        transposed = (data[fileIndex] == fortran[i]);
+      }
+      H5SUPPORT_REQUIRE(transposed);
+
+      std::vector<int32_t> readBack(numElements, -1);
+      error = H5Lite::readPointerDatasetWithLayout(fileID, name, readBack.data(), layout);
+      H5SUPPORT_REQUIRE(error >= 0);
+      H5SUPPORT_REQUIRE(readBack == fortran);
+    }
+
+    // An empty extent moves nothing
+    const hsize_t emptyShape[2] = {5, 0};
+    int32_t unused = -1;
+    herr_t error = H5Lite::writePointerDatasetWithLayout(fileID, "ColumnMajorEmpty", 2, emptyShape, &unused, H5MemoryLayout::ColumnMajor(2, emptyShape));
+    H5SUPPORT_REQUIRE(error >= 0);
+    error = H5Lite::readPointerDatasetWithLayout(fileID, "ColumnMajorEmpty", &unused, H5MemoryLayout::ColumnMajor(2, emptyShape));
+    H5SUPPORT_REQUIRE(error >= 0);
+    H5SUPPORT_REQUIRE_EQUAL(unused, -1)
+
+    error = H5Utilities::closeFile(fileID);
+    H5SUPPORT_REQUIRE(error >= 0);
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  void operator()()
+  {
+    H5SUPPORT_REGISTER_TEST(TestLayouts())
+    H5SUPPORT_REGISTER_TEST(TestInterleaved())
+    H5SUPPORT_REGISTER_TEST(TestColumnMajor())
+    H5SUPPORT_REGISTER_TEST(RemoveTestFiles())
+  }
+};
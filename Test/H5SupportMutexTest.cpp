@@ -0,0 +1,221 @@
+/* ============================================================================
+ * Copyright (c) 2007-2019 BlueQuartz Software, LLC
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+ * contributors may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The code contained herein was partially funded by the followig contracts:
+ *    United States Air Force Prime Contract FA8650-04-C-5229
+ *    United States Air Force Prime Contract FA8650-15-D-5231
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#include <array>
+#include <atomic>
+#include <cstdio>
+#include <iostream>
+#include <list>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "H5Support/H5Lite.h"
+#include "H5Support/H5Utilities.h"
+
+#include "UnitTestSupport.h"
+
+#include "H5SupportTestFileLocations.h"
+
+#if defined(H5Support_NAMESPACE)
+using namespace H5Support_NAMESPACE;
+#endif
+
+class H5SupportMutexTest
+{
+public:
+  H5SupportMutexTest() = default;
+  ~H5SupportMutexTest() = default;
+
+  H5SupportMutexTest(const H5SupportMutexTest&) = delete;            // Copy Constructor Not Implemented
+  H5SupportMutexTest(H5SupportMutexTest&&) = delete;                 // Move Constructor Not Implemented
+  H5SupportMutexTest& operator=(const H5SupportMutexTest&) = delete; // Copy Assignment Not Implemented
+  H5SupportMutexTest& operator=(H5SupportMutexTest&&) = delete;      // Move Assignment Not Implemented
+
+  static constexpr size_t k_NumThreads = 8;
+  static constexpr size_t k_NumIterations = 50;
+  static constexpr size_t k_NumElements = 4096;
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  void RemoveTestFiles()
+  {
+#if REMOVE_TEST_FILES
+    std::remove(UnitTest::H5SupportMutexTest::FileName.c_str());
+#endif
+  }
+
+#ifdef H5Support_USE_MUTEX
+  // -----------------------------------------------------------------------------
+  //  Nested entry points must be able to re-acquire the lock from the same thread
+  // -----------------------------------------------------------------------------
+  void TestRecursiveLocking()
+  {
+    H5ScopedMutexLock outerLock;
+    H5SUPPORT_REQUIRE(H5SupportMutex::instance().isHeldByCurrentThread());
+    {
+      H5ScopedSharedMutexLock nestedShared;
+      H5ScopedMutexLock nestedExclusive;
+      H5SUPPORT_REQUIRE(H5SupportMutex::instance().isHeldByCurrentThread());
+    }
+    H5SUPPORT_REQUIRE(H5SupportMutex::instance().isHeldByCurrentThread());
+
+    // readVectorAttribute -> getAttributeInfo -> openId all take the lock again
+    hid_t fileID = H5Utilities::createFile(UnitTest::H5SupportMutexTest::FileName);
+    H5SUPPORT_REQUIRE(fileID > 0);
+    std::vector<hsize_t> dims = {4};
+    std::vector<int32_t> data = {1, 2, 3, 4};
+    herr_t error = H5Lite::writeVectorDataset(fileID, "Nested", dims, data);
+    H5SUPPORT_REQUIRE(error >= 0);
+    error = H5Lite::writeVectorAttribute(fileID, "Nested", "Attribute", dims, data);
+    H5SUPPORT_REQUIRE(error >= 0);
+    std::vector<int32_t> readBack;
+    error = H5Lite::readVectorAttribute(fileID, "Nested", "Attribute", readBack);
+    H5SUPPORT_REQUIRE(error >= 0);
+    H5SUPPORT_REQUIRE(readBack == data);
+    error = H5Utilities::closeFile(fileID);
+    H5SUPPORT_REQUIRE(error >= 0);
+  }
+
+  // -----------------------------------------------------------------------------
+  //  No two threads may ever be inside an exclusive section at the same time
+  // -----------------------------------------------------------------------------
+  void TestMutualExclusion()
+  {
+    std::atomic<int32_t> insideCount(0);
+    std::atomic<int32_t> maxInside(0);
+    std::vector<std::thread> threads;
+    for(size_t t = 0; t < k_NumThreads; ++t)
+    {
+      threads.emplace_back([&insideCount, &maxInside]() {
+        for(size_t i = 0; i < k_NumIterations * 20; ++i)
+        {
+          H5ScopedMutexLock lock;
+          int32_t current = ++insideCount;
+          int32_t previous = maxInside.load();
+          while(current > previous && !maxInside.compare_exchange_weak(previous, current))
+          {
+          }
+          std::this_thread::yield();
+          --insideCount;
+        }
+      });
+    }
+    for(auto& thread : threads)
+    {
+      thread.join();
+    }
+    H5SUPPORT_REQUIRE_EQUAL(maxInside.load(), 1)
+  }
+
+  // -----------------------------------------------------------------------------
+  //  Many threads writing and reading datasets in the same file at the same time
+  // -----------------------------------------------------------------------------
+  void TestConcurrentReadWrite()
+  {
+    hid_t fileID = H5Utilities::createFile(UnitTest::H5SupportMutexTest::FileName);
+    H5SUPPORT_REQUIRE(fileID > 0);
+
+    std::vector<float> shared(k_NumElements);
+    for(size_t i = 0; i < k_NumElements; ++i)
+    {
+      shared[i] = static_cast<float>(i) * 0.5f;
+    }
+    std::vector<hsize_t> dims = {k_NumElements};
+    herr_t error = H5Lite::writeVectorDataset(fileID, "Shared", dims, shared);
+    H5SUPPORT_REQUIRE(error >= 0);
+
+    std::atomic<int32_t> failures(0);
+    std::vector<std::thread> threads;
+    for(size_t t = 0; t < k_NumThreads; ++t)
+    {
+      threads.emplace_back([fileID, t, &shared, &failures]() {
+        std::vector<int32_t> data(k_NumElements);
+        std::vector<int32_t> readBack;
+        std::vector<float> sharedReadBack;
+        std::array<hsize_t, 1> dims = {k_NumElements};
+        for(size_t i = 0; i < k_NumIterations; ++i)
+        {
+          for(size_t e = 0; e < k_NumElements; ++e)
+          {
+            data[e] = static_cast<int32_t>(t * 1000000 + i * 1000 + e);
+          }
+          std::string datasetName = "Thread_" + std::to_string(t) + "_" + std::to_string(i);
+          if(H5Lite::writePointerDataset(fileID, datasetName, static_cast<int32_t>(dims.size()), dims.data(), data.data()) < 0)
+          {
+            ++failures;
+          }
+          if(H5Lite::readVectorDataset(fileID, datasetName, readBack) < 0 || readBack != data)
+          {
+            ++failures;
+          }
+          if(H5Lite::readVectorDataset(fileID, "Shared", sharedReadBack) < 0 || sharedReadBack != shared)
+          {
+            ++failures;
+          }
+        }
+      });
+    }
+    for(auto& thread : threads)
+    {
+      thread.join();
+    }
+    H5SUPPORT_REQUIRE_EQUAL(failures.load(), 0)
+
+    std::list<std::string> names;
+    error = H5Utilities::getGroupObjects(fileID, H5Utilities::CustomHDFDataTypes::Dataset, names);
+    H5SUPPORT_REQUIRE(error >= 0);
+    H5SUPPORT_REQUIRE_EQUAL(names.size(), k_NumThreads * k_NumIterations + 1)
+
+    error = H5Utilities::closeFile(fileID);
+    H5SUPPORT_REQUIRE(error >= 0);
+  }
+#endif
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  void operator()()
+  {
+#ifdef H5Support_USE_MUTEX
+    H5SUPPORT_REGISTER_TEST(TestRecursiveLocking())
+    H5SUPPORT_REGISTER_TEST(TestMutualExclusion())
+    H5SUPPORT_REGISTER_TEST(TestConcurrentReadWrite())
+    H5SUPPORT_REGISTER_TEST(RemoveTestFiles())
+#else
+    std::cout << "H5Support_USE_MUTEX is OFF. Skipping the multi-threaded tests." << std::endl;
+#endif
+  }
+};